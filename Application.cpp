@@ -5,68 +5,216 @@
 #include "classes/Othello.h"
 #include "classes/Connect4.h"
 #include "classes/Chess.h"
+#include "classes/ThreadPool.h"
 
 namespace ClassGame {
+        //
+        // every game on the dashboard, with the AI move it is waiting on
+        //
+        struct GameSlot
+        {
+            Game *game;
+            std::string name;
+            bool gameOver;
+            int gameWinner;
+            std::future<std::string> pendingMove;
+        };
+
         //
         // our global variables
         //
-        Game *game = nullptr;
-        bool gameOver = false;
-        int gameWinner = -1;
+        std::vector<GameSlot *> slots;
+        // the game shown in the detail view
+        GameSlot *selected = nullptr;
+        bool selfPlay = false;
+        const float kThumbnailSize = 160.0f;
+
+        static GameSlot *slotForGame(Game *game)
+        {
+            for (GameSlot *slot : slots) {
+                if (slot->game == game) {
+                    return slot;
+                }
+            }
+            return nullptr;
+        }
+
+        static void addGame(Game *game, const char *name)
+        {
+            GameSlot *slot = new GameSlot();
+            slot->game = game;
+            slot->name = std::string(name) + " #" + std::to_string(slots.size() + 1);
+            slot->gameOver = false;
+            slot->gameWinner = -1;
+            game->setUpBoard();
+            game->_gameOptions.AIvsAI = selfPlay;
+            slots.push_back(slot);
+            selected = slot;
+        }
+
+        //
+        // a worker may still be reading the game, wait for it before touching the board
+        //
+        static void waitForAI(GameSlot *slot)
+        {
+            if (slot->pendingMove.valid()) {
+                slot->pendingMove.wait();
+                slot->pendingMove = std::future<std::string>();
+            }
+        }
+
+        static void resetGame(GameSlot *slot)
+        {
+            waitForAI(slot);
+            bool AIvsAI = slot->game->_gameOptions.AIvsAI;
+            slot->game->stopGame();
+            slot->game->setUpBoard();
+            slot->game->_gameOptions.AIvsAI = AIvsAI;
+            slot->gameOver = false;
+            slot->gameWinner = -1;
+        }
+
+        static void closeGame(GameSlot *slot)
+        {
+            waitForAI(slot);
+            slot->game->stopGame();
+            delete slot->game;
+            slots.erase(std::find(slots.begin(), slots.end(), slot));
+            if (selected == slot) {
+                selected = slots.empty() ? nullptr : slots.back();
+            }
+            delete slot;
+        }
+
+        //
+        // background AI searches a snapshot of the state on the shared pool and the UI thread
+        // applies the result once it's ready, so no game's search holds up the others
+        //
+        static void updateAI(GameSlot *slot)
+        {
+            Game *game = slot->game;
+            if (slot->gameOver || !game->gameHasAI() || !(game->getCurrentPlayer()->isAIPlayer() || game->_gameOptions.AIvsAI)) {
+                return;
+            }
+            if (!game->gameHasBackgroundAI()) {
+                game->updateAI();
+                return;
+            }
+            if (!slot->pendingMove.valid()) {
+                std::string state = game->stateString();
+                int playerNumber = game->getCurrentPlayer()->playerNumber();
+                AIOptions options = game->aiOptions();
+                slot->pendingMove = ThreadPool::sharedPool().submit([game, state, playerNumber, options]() {
+                    return game->searchAIMove(state, playerNumber, options);
+                });
+            } else if (slot->pendingMove.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                std::string move = slot->pendingMove.get();
+                game->applyAIMove(move);
+            }
+        }
 
         //
         // game starting point
         // this is called by the main render loop in main.cpp
         //
-        void GameStartUp() 
+        void GameStartUp()
         {
-            game = nullptr;
+            slots.clear();
+            selected = nullptr;
+        }
+
+        static void renderDashboard()
+        {
+            ImGui::Begin("Dashboard");
+            float available = ImGui::GetContentRegionAvail().x;
+            int columns = std::max(1, (int)(available / (kThumbnailSize + ImGui::GetStyle().ItemSpacing.x)));
+            for (size_t i = 0; i < slots.size(); i++) {
+                GameSlot *slot = slots[i];
+                if (i % columns) {
+                    ImGui::SameLine();
+                }
+                ImGui::BeginGroup();
+                ImGui::PushID((int)i);
+                ImVec2 extent = slot->game->boardExtent();
+                float scale = kThumbnailSize / std::max(1.0f, std::max(extent.x, extent.y));
+                ImVec2 origin = ImGui::GetCursorScreenPos();
+                if (ImGui::InvisibleButton("board", ImVec2(kThumbnailSize, kThumbnailSize))) {
+                    selected = slot;
+                }
+                ImDrawList *drawList = ImGui::GetWindowDrawList();
+                // the detail view animates the selected game, the thumbnail just mirrors it
+                slot->game->drawThumbnail(drawList, origin, scale, slot != selected);
+                if (slot == selected) {
+                    drawList->AddRect(origin, ImVec2(origin.x + kThumbnailSize, origin.y + kThumbnailSize), IM_COL32(255, 255, 0, 255));
+                }
+                if (slot->gameOver) {
+                    ImGui::Text("%s: over, winner %d", slot->name.c_str(), slot->gameWinner);
+                } else {
+                    ImGui::Text("%s: turn %u", slot->name.c_str(), slot->game->getCurrentTurnNo());
+                }
+                ImGui::PopID();
+                ImGui::EndGroup();
+            }
+            ImGui::End();
         }
 
         //
         // game render loop
         // this is called by the main render loop in main.cpp
         //
-        void RenderGame() 
+        void RenderGame()
         {
                 ImGui::DockSpaceOverViewport();
 
                 //ImGui::ShowDemoWindow();
 
+                for (GameSlot *slot : slots) {
+                    updateAI(slot);
+                }
+
                 ImGui::Begin("Settings");
 
-                if (gameOver) {
-                    ImGui::Text("Game Over!");
-                    ImGui::Text("Winner: %d", gameWinner);
-                    if (ImGui::Button("Reset Game")) {
-                        game->stopGame();
-                        game->setUpBoard();
-                        gameOver = false;
-                        gameWinner = -1;
-                    }
+                ImGui::Checkbox("Self-play (AI vs AI)", &selfPlay);
+                if (ImGui::Button("Start Tic-Tac-Toe")) {
+                    addGame(new TicTacToe(), "Tic-Tac-Toe");
+                }
+                if (ImGui::Button("Start Checkers")) {
+                    addGame(new Checkers(), "Checkers");
+                }
+                if (ImGui::Button("Start Othello")) {
+                    addGame(new Othello(), "Othello");
+                }
+                if (ImGui::Button("Start Connect 4")) {
+                    addGame(new Connect4(), "Connect 4");
                 }
-                if (!game) {
-                    if (ImGui::Button("Start Tic-Tac-Toe")) {
-                        game = new TicTacToe();
-                        game->setUpBoard();
+                if (ImGui::Button("Start Chess")) {
+                    addGame(new Chess(), "Chess");
+                }
+
+                if (selected) {
+                    ImGui::Separator();
+                    ImGui::Text("%s", selected->name.c_str());
+                    if (selected->gameOver) {
+                        ImGui::Text("Game Over!");
+                        ImGui::Text("Winner: %d", selected->gameWinner);
                     }
-                    if (ImGui::Button("Start Checkers")) {
-                        game = new Checkers();
-                        game->setUpBoard();
+                    if (selected->game->gameHasMCTS()) {
+                        ImGui::Checkbox("Monte Carlo AI", &selected->game->_gameOptions.AIUseMCTS);
                     }
-                    if (ImGui::Button("Start Othello")) {
-                        game = new Othello();
-                        game->setUpBoard();
+                    if (selected->game->gameHasMultiPV()) {
+                        ImGui::SliderInt("Analysis lines", &selected->game->_gameOptions.AIMultiPV, 1, 8);
                     }
-                    if (ImGui::Button("Start Connect 4")) {
-                        game = new Connect4();
-                        game->setUpBoard();
+                    selected->game->drawAISettings();
+                    if (ImGui::Button("Reset Game")) {
+                        resetGame(selected);
                     }
-                    if (ImGui::Button("Start Chess")) {
-                        game = new Chess();
-                        game->setUpBoard();
+                    ImGui::SameLine();
+                    if (ImGui::Button("Close Game")) {
+                        closeGame(selected);
                     }
-                } else {
+                }
+                if (selected) {
+                    Game *game = selected->game;
                     ImGui::Text("Current Player Number: %d", game->getCurrentPlayer()->playerNumber());
                     std::string stateString = game->stateString();
                     int stride = game->_gameOptions.rowX;
@@ -75,17 +223,23 @@ namespace ClassGame {
                     for(int y=0; y<height; y++) {
                         ImGui::Text("%s", stateString.substr(y*stride,stride).c_str());
                     }
-                    ImGui::Text("Current Board State: %s", game->stateString().c_str());
+                    ImGui::Text("Current Board State: %s", stateString.c_str());
                 }
                 ImGui::End();
 
-                ImGui::Begin("GameWindow");
-                if (game) {
-                    if (game->gameHasAI() && (game->getCurrentPlayer()->isAIPlayer() || game->_gameOptions.AIvsAI))
-                    {
-                        game->updateAI();
+                if (selected && selected->game->gameHasMultiPV()) {
+                    ImGui::Begin("Analysis");
+                    for (const std::string &line : selected->game->analysisLines()) {
+                        ImGui::TextUnformatted(line.c_str());
                     }
-                    game->drawFrame();
+                    ImGui::End();
+                }
+
+                renderDashboard();
+
+                ImGui::Begin("GameWindow");
+                if (selected) {
+                    selected->game->drawFrame();
                 }
                 ImGui::End();
         }
@@ -94,17 +248,21 @@ namespace ClassGame {
         // end turn is called by the game code at the end of each turn
         // this is where we check for a winner
         //
-        void EndOfTurn() 
+        void EndOfTurn(Game *game)
         {
+            GameSlot *slot = slotForGame(game);
+            if (!slot) {
+                return;
+            }
             Player *winner = game->checkForWinner();
             if (winner)
             {
-                gameOver = true;
-                gameWinner = winner->playerNumber();
+                slot->gameOver = true;
+                slot->gameWinner = winner->playerNumber();
             }
             if (game->checkForDraw()) {
-                gameOver = true;
-                gameWinner = -1;
+                slot->gameOver = true;
+                slot->gameWinner = -1;
             }
         }
 }
@@ -1,7 +1,9 @@
 #pragma once
 
+class Game;
+
 namespace ClassGame {
     void GameStartUp();
     void RenderGame();
-    void EndOfTurn();
+    void EndOfTurn(Game *game);
 }
@@ -7,6 +7,22 @@ Bit::~Bit()
 {
 }
 
+void Bit::reset()
+{
+	setParent(nullptr);
+	setPosition(0, 0);
+	setSize(0, 0);
+	setRotation(0);
+	setScale(1.0f);
+	setColor(1, 1, 1, 1);
+	setLocalZOrder(0);
+	setHighlighted(false);
+	_pickedUp = false;
+	_owner = nullptr;
+	_gameTag = 0;
+	_moving = false;
+}
+
 BitHolder *Bit::getHolder()
 {
 	// Look for my nearest ancestor that's a BitHolder:
@@ -53,6 +69,7 @@ void Bit::setPickedUp(bool up)
 		setOpacity(opacity);
 		setRotation(rotation);
 		_pickedUp = up;
+		invalidateRender();
 	}
 }
 
@@ -82,6 +99,10 @@ void Bit::moveTo(const ImVec2 &point)
 	// work out the step so we move same step each update
 	ImVec2 delta = ImVec2(_destinationPosition.x - getPosition().x, _destinationPosition.y - getPosition().y);
 	_destinationStep = ImVec2(delta.x * 0.05f, delta.y * 0.05f);
+	if (!_moving)
+	{
+		invalidateRender();
+	}
 	_moving = true;
 }
 
@@ -102,5 +123,6 @@ void Bit::update()
 	{
 		setPosition(_destinationPosition);
 		_moving = false;
+		invalidateRender();
 	}
 }
\ No newline at end of file
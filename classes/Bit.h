@@ -11,12 +11,13 @@ class BitHolder;
 #define kPickedUpScale 1.2f
 #define kPickedUpOpacity 255
 
+// draw order, lowest first: a piece being dragged is drawn over one that is animating
 enum bitz
 {
 	kBoardZ = 0,
 	kPieceZ = 3,
-	kPickupUpZ = 9920,
-	kMovingZ = 9930
+	kMovingZ = 9920,
+	kPickupUpZ = 9930
 };
 
 class Bit : public Sprite
@@ -33,6 +34,9 @@ public:
 
 	~Bit();
 
+	// put the bit back in its freshly constructed state so a pool can hand it out again
+	void reset();
+
 	// helper functions
 	bool getPickedUp();
 	void setPickedUp(bool yes);
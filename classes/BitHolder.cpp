@@ -1,5 +1,6 @@
 #include "BitHolder.h"
 #include "Bit.h"
+#include "BitPool.h"
 
 BitHolder::~BitHolder()
 {
@@ -28,7 +29,7 @@ void BitHolder::setBit(Bit *abit)
 	{
 		if (_bit)
 		{
-			delete _bit;
+			BitPool::sharedPool().release(_bit);
 			_bit = nullptr;
 		}
 		_bit = abit;
@@ -36,15 +37,18 @@ void BitHolder::setBit(Bit *abit)
 		{
 			_bit->setParent(this);
 		}
+		invalidateRender();
 	}
 }
 
 void BitHolder::destroyBit()
 {
-	if (_bit)
+	// only recycle a bit we still hold, one that was dragged away belongs to its new holder
+	if (bit())
 	{
-		delete _bit;
+		BitPool::sharedPool().release(_bit);
 		_bit = nullptr;
+		invalidateRender();
 	}
 }
 
@@ -16,9 +16,9 @@ public:
 	// current piece or nullptr if empty
 	Bit *bit() const;
 	Bit *bit();
-	// set the current piece
+	// set the current piece, any piece it replaces goes back to the bit pool
 	void setBit(Bit *bit);
-	// destroy the current piece, triggering any associated animations
+	// destroy the current piece, returning it to the bit pool
 	void destroyBit();
 	// gametag can be used by games for any purpose
 	const int gameTag() { return _gameTag; };
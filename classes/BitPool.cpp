@@ -0,0 +1,75 @@
+#include "BitPool.h"
+
+BitPool::BitPool(size_t preallocate) : _capacity(0)
+{
+    grow(preallocate);
+}
+
+BitPool::~BitPool()
+{
+    _free.clear();
+    _blocks.clear();
+}
+
+BitPool &BitPool::sharedPool()
+{
+    static BitPool pool;
+    return pool;
+}
+
+//
+// pieces live in fixed blocks so pointers stay valid while the pool grows
+//
+void BitPool::grow(size_t count)
+{
+    if (count == 0) {
+        return;
+    }
+    _blocks.emplace_back(new Bit[count]);
+    Bit *block = _blocks.back().get();
+    _free.reserve(_free.size() + count);
+    // hand out the front of the block first
+    for (size_t i = count; i > 0; i--) {
+        _free.push_back(&block[i - 1]);
+    }
+    _capacity += count;
+}
+
+Bit *BitPool::acquire(Player *owner, const char *spriteName, int gameTag)
+{
+    if (_free.empty()) {
+        grow(kBlockSize);
+    }
+    Bit *bit = _free.back();
+    _free.pop_back();
+    bit->reset();
+    skin(bit, owner, spriteName, gameTag);
+    return bit;
+}
+
+void BitPool::release(Bit *bit)
+{
+    if (!bit) {
+        return;
+    }
+    bit->reset();
+    _free.push_back(bit);
+}
+
+void BitPool::skin(Bit *bit, Player *owner, const char *spriteName, int gameTag)
+{
+    auto it = _textures.find(spriteName);
+    if (it == _textures.end()) {
+        // first use of this sprite, load it through the piece and remember the result
+        // failed loads are remembered too so we don't hit the disk for every piece
+        Texture texture = { 0, ImVec2(0, 0) };
+        if (bit->LoadTextureFromFile(spriteName)) {
+            texture.texture = bit->getTexture();
+            texture.size = bit->getSize();
+        }
+        it = _textures.emplace(spriteName, texture).first;
+    }
+    bit->setTexture(it->second.texture, it->second.size);
+    bit->setOwner(owner);
+    bit->setGameTag(gameTag);
+}
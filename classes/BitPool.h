@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Bit.h"
+#include <vector>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+//
+// a pool of preallocated, reusable pieces
+// games acquire pieces already skinned with an owner, texture and game tag, and holders
+// hand them back when they are destroyed, so board resets and replays never hit the allocator
+//
+class BitPool
+{
+public:
+    BitPool(size_t preallocate = kBlockSize);
+    ~BitPool();
+
+    // the pool every game and holder shares
+    static BitPool &sharedPool();
+
+    // hand out a piece skinned for the given owner, sprite and game tag
+    Bit *acquire(Player *owner, const char *spriteName, int gameTag = 0);
+    // put a piece back on the free list, it must not be referenced afterwards
+    void release(Bit *bit);
+    // change an existing piece's owner, texture and tag in place (othello flips, promotions)
+    void skin(Bit *bit, Player *owner, const char *spriteName, int gameTag = 0);
+
+    size_t capacity() const { return _capacity; }
+    size_t available() const { return _free.size(); }
+
+private:
+    static const size_t kBlockSize = 64;
+
+    struct Texture
+    {
+        ImTextureID texture;
+        ImVec2 size;
+    };
+
+    void grow(size_t count);
+
+    std::vector<std::unique_ptr<Bit[]>> _blocks;
+    std::vector<Bit *> _free;
+    // textures are loaded once per sprite name and shared by every piece that uses them
+    std::unordered_map<std::string, Texture> _textures;
+    size_t _capacity;
+};
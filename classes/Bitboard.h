@@ -3,8 +3,35 @@
 #ifdef _MSC_VER
 #include <intrin.h>
 #endif
+#include <cstdint>
 #include <iostream>
 
+// Constants for ranks and files
+constexpr uint64_t FILE_A = 0x0101010101010101ULL;
+constexpr uint64_t FILE_B = FILE_A << 1;
+constexpr uint64_t FILE_C = FILE_A << 2;
+constexpr uint64_t FILE_D = FILE_A << 3;
+constexpr uint64_t FILE_E = FILE_A << 4;
+constexpr uint64_t FILE_F = FILE_A << 5;
+constexpr uint64_t FILE_G = FILE_A << 6;
+constexpr uint64_t FILE_H = FILE_A << 7;
+
+constexpr uint64_t RANK_1 = 0x00000000000000FFULL;
+constexpr uint64_t RANK_2 = 0x000000000000FF00ULL;
+constexpr uint64_t RANK_3 = 0x0000000000FF0000ULL;
+constexpr uint64_t RANK_4 = 0x00000000FF000000ULL;
+constexpr uint64_t RANK_5 = 0x000000FF00000000ULL;
+constexpr uint64_t RANK_6 = 0x0000FF0000000000ULL;
+constexpr uint64_t RANK_7 = 0x00FF000000000000ULL;
+constexpr uint64_t RANK_8 = 0xFF00000000000000ULL;
+
+constexpr uint64_t NOT_FILE_A = ~FILE_A;
+constexpr uint64_t NOT_FILE_B = ~FILE_B;
+constexpr uint64_t NOT_FILE_G = ~FILE_G;
+constexpr uint64_t NOT_FILE_H = ~FILE_H;
+constexpr uint64_t NOT_FILE_AB = ~(FILE_A | FILE_B);
+constexpr uint64_t NOT_FILE_GH = ~(FILE_G | FILE_H);
+
 enum ChessPiece
 {
     NoPiece,
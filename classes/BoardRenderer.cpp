@@ -0,0 +1,91 @@
+#include "BoardRenderer.h"
+#include <algorithm>
+
+BoardRenderer::BoardRenderer() : _grid(nullptr), _revision(0), _extent(0, 0)
+{
+}
+
+//
+// gather the enabled squares and their pieces once, sorted so each layer's
+// sprites are grouped by texture
+//
+void BoardRenderer::rebuild(Grid *grid)
+{
+    _drawables.clear();
+    _extent = ImVec2(0, 0);
+
+    for (ChessSquare &square : grid->enabledSquares())
+    {
+        _drawables.push_back({ &square, nullptr, bitz::kBoardZ, square.getTexture() });
+        Bit *bit = square.bit();
+        if (bit)
+        {
+            int z = bitz::kPieceZ;
+            if (bit->getPickedUp())
+            {
+                z = bitz::kPickupUpZ;
+            }
+            else if (bit->getMoving())
+            {
+                z = bitz::kMovingZ;
+            }
+            _drawables.push_back({ bit, bit, z, bit->getTexture() });
+        }
+        const ImVec2 &position = square.getPosition();
+        const ImVec2 &size = square.getSize();
+        _extent.x = std::max(_extent.x, position.x + size.x);
+        _extent.y = std::max(_extent.y, position.y + size.y);
+    }
+
+    std::stable_sort(_drawables.begin(), _drawables.end(), [](const Drawable &a, const Drawable &b) {
+        if (a.z != b.z)
+        {
+            return a.z < b.z;
+        }
+        return a.texture < b.texture;
+    });
+
+    _grid = grid;
+    _revision = grid->renderRevision();
+}
+
+void BoardRenderer::emit(ImDrawList *drawList, const Drawable &drawable, const ImVec2 &origin, float scale)
+{
+    Sprite *sprite = drawable.sprite;
+    ImVec2 size = sprite->getSize();
+    if (size.x <= 0.0f || size.y <= 0.0f)
+    {
+        return;
+    }
+    const ImVec2 &position = sprite->getPosition();
+    ImVec2 min(origin.x + position.x * scale, origin.y + position.y * scale);
+    size = ImVec2(size.x * scale, size.y * scale);
+    if (sprite->highlighted())
+    {
+        // matches the one pixel border ImGui::Image draws around a highlighted sprite
+        drawList->AddRect(min, ImVec2(min.x + size.x + 2, min.y + size.y + 2), IM_COL32(255, 255, 0, 255));
+        min = ImVec2(min.x + 1, min.y + 1);
+    }
+    drawList->AddImage(sprite->getTexture(), min, ImVec2(min.x + size.x, min.y + size.y), ImVec2(0, 0), ImVec2(1, 1), ImGui::GetColorU32(sprite->getColor()));
+}
+
+void BoardRenderer::prepare(Grid *grid)
+{
+    if (grid != _grid || _revision != grid->renderRevision())
+    {
+        rebuild(grid);
+    }
+}
+
+void BoardRenderer::draw(Grid *grid, ImDrawList *drawList, const ImVec2 &origin, float scale, bool animate)
+{
+    prepare(grid);
+    for (const Drawable &drawable : _drawables)
+    {
+        if (animate && drawable.z == bitz::kMovingZ)
+        {
+            drawable.bit->update();
+        }
+        emit(drawList, drawable, origin, scale);
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Grid.h"
+#include <vector>
+
+//
+// retained-mode renderer for a board
+// the squares and pieces of a grid are gathered into a render list sorted by draw layer (bitz)
+// and texture, and only re-gathered when the grid's renderRevision() changes, so a change on one
+// board leaves every other board's list alone. every frame the list is emitted straight into an
+// ImDrawList, so consecutive sprites sharing a texture batch together
+//
+class BoardRenderer
+{
+public:
+    BoardRenderer();
+
+    // draw the grid with its top left corner at origin (screen space), scaled for thumbnails
+    // only one view of a board should animate its moving pieces each frame
+    void draw(Grid *grid, ImDrawList *drawList, const ImVec2 &origin, float scale = 1.0f, bool animate = true);
+    // rebuild the render list if the grid changed since the last draw
+    void prepare(Grid *grid);
+    // force the render list to be rebuilt on the next draw
+    void invalidate() { _grid = nullptr; }
+    // unscaled bottom right corner of everything drawn, for reserving window space
+    const ImVec2 &extent() const { return _extent; }
+
+private:
+    struct Drawable
+    {
+        Sprite *sprite;
+        // set for pieces, so moving ones can be animated as they are drawn
+        Bit *bit;
+        int z;
+        ImTextureID texture;
+    };
+
+    void rebuild(Grid *grid);
+    void emit(ImDrawList *drawList, const Drawable &drawable, const ImVec2 &origin, float scale);
+
+    std::vector<Drawable> _drawables;
+    Grid *_grid;
+    unsigned int _revision;
+    ImVec2 _extent;
+};
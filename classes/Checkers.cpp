@@ -1,11 +1,18 @@
 #include "Checkers.h"
+#include "BitPool.h"
+#include "CheckersEndgame.h"
+#include <algorithm>
+#include <sstream>
+
+// how long the AI may think about a move
+static const int kAIThinkTimeMs = 1000;
 
 Checkers::Checkers() : Game() {
     _grid = new Grid(8, 8);
-    _mustContinueJumping = false;
-    _jumpingPiece = nullptr;
-    _redPieces = 12;
-    _yellowPieces = 12;
+    _quietMoves = 0;
+    // captures are searched past this, so the nominal depth can stay modest
+    _gameOptions.AIMAXDepth = 20;
+    _ai.setEndgame(&CheckersEndgame::sharedDatabase());
 }
 
 Checkers::~Checkers() {
@@ -20,243 +27,159 @@ void Checkers::setUpBoard() {
     // Initialize all squares
     _grid->initializeSquares(80, "boardsquare.png");
 
-    // Enable only dark squares and place pieces
+    // Enable only dark squares
     _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        bool isDark = (x + y) % 2 == 1;
-        _grid->setEnabled(x, y, isDark);
-
-        if (isDark) {
-            if (y < 3) {
-                Bit* piece = createPiece(RED_PIECE);
-                piece->setPosition(square->getPosition());
-                square->setBit(piece);
-            } else if (y > 4) {
-                Bit* piece = createPiece(YELLOW_PIECE);
-                piece->setPosition(square->getPosition());
-                square->setBit(piece);
-            }
-        }
+        _grid->setEnabled(x, y, (x + y) % 2 == 1);
     });
 
+    _board = CheckersBoard::initialPosition();
+    _board.generateMoves(_legalMoves);
+    _hops.clear();
+    _quietMoves = 0;
+    syncGrid();
+
+    if (gameHasAI()) {
+        setAIPlayer(AI_PLAYER);
+    }
+
     startGame();
 }
 
 Bit* Checkers::createPiece(int pieceType) {
-    Bit* bit = new Bit();
     bool isRed = (pieceType == RED_PIECE || pieceType == RED_KING);
-    bit->LoadTextureFromFile(isRed ? "red.png" : "yellow.png");
-    bit->setOwner(getPlayerAt(isRed ? RED_PLAYER : YELLOW_PLAYER));
-    bit->setGameTag(pieceType);
+    Bit* bit = BitPool::sharedPool().acquire(getPlayerAt(isRed ? RED_PLAYER : YELLOW_PLAYER), isRed ? "red.png" : "yellow.png", pieceType);
     if (pieceType == RED_KING || pieceType == YELLOW_KING)
         bit->setScale(1.3f);
     return bit;
 }
 
+//
+// mirror the bitboards onto the grid, pieces that are already right are left alone
+//
+void Checkers::syncGrid() {
+    for (ChessSquare& square : _grid->enabledSquares()) {
+        uint32_t bit = 1u << CheckersBoard::squareAt(square.getColumn(), square.getRow());
+        int pieceType = EMPTY;
+        if (_board.men(CheckersBoard::kRed) & bit) pieceType = RED_PIECE;
+        else if (_board.kings(CheckersBoard::kRed) & bit) pieceType = RED_KING;
+        else if (_board.men(CheckersBoard::kYellow) & bit) pieceType = YELLOW_PIECE;
+        else if (_board.kings(CheckersBoard::kYellow) & bit) pieceType = YELLOW_KING;
+
+        Bit* current = square.bit();
+        if (pieceType == EMPTY) {
+            square.destroyBit();
+        } else if (!current || current->gameTag() != pieceType) {
+            Bit* piece = createPiece(pieceType);
+            piece->setPosition(square.getPosition());
+            square.setBit(piece);
+        }
+    }
+}
+
+int Checkers::squareIndex(BitHolder &holder) const {
+    ChessSquare* square = static_cast<ChessSquare*>(&holder);
+    return CheckersBoard::squareAt(square->getColumn(), square->getRow());
+}
+
+ChessSquare* Checkers::squareFor(int index) const {
+    return _grid->getSquare(CheckersBoard::columnOf(index), CheckersBoard::rowOf(index));
+}
+
+bool Checkers::followsHops(const CheckersMove &move, int from, int to) const {
+    size_t at = _hops.empty() ? 0 : _hops.size() - 1;
+    if ((size_t)move.length <= at + 1) return false;
+    for (size_t i = 0; i < _hops.size(); i++) {
+        if (move.path[i] != _hops[i]) return false;
+    }
+    return move.path[at] == from && move.path[at + 1] == to;
+}
+
 bool Checkers::actionForEmptyHolder(BitHolder &holder) {
     return false; // Checkers doesn't place new pieces
 }
 
 bool Checkers::canBitMoveFrom(Bit &bit, BitHolder &src) {
     if (!src.bit() || bit.getOwner() != getCurrentPlayer()) return false;
-    if (_mustContinueJumping && &src != _jumpingPiece) return false;
 
-    ChessSquare* square = static_cast<ChessSquare*>(&src);
-    int x = square->getColumn();
-    int y = square->getRow();
+    int from = squareIndex(src);
+    // mid-jump only the jumping piece may move
+    if (!_hops.empty()) return from == _hops.back();
 
-    // Must jump if available
-    if (hasJumpAvailable(bit.getOwner())) {
-        return canJumpFrom(*square);
+    // the move list already holds only captures when one is available
+    for (const CheckersMove& move : _legalMoves) {
+        if (move.path[0] == from) return true;
     }
-    return true;
+    return false;
 }
 
 bool Checkers::canBitMoveFromTo(Bit& bit, BitHolder& src, BitHolder& dst) {
     if (!src.bit() || dst.bit()) return false;
 
-    ChessSquare* srcSquare = static_cast<ChessSquare*>(&src);
-    ChessSquare* dstSquare = static_cast<ChessSquare*>(&dst);
-
-    int srcX = srcSquare->getColumn();
-    int srcY = srcSquare->getRow();
+    int from = squareIndex(src);
+    int to = squareIndex(dst);
+    if (from < 0 || to < 0) return false;
 
-    if (!_grid->isEnabled(dstSquare->getColumn(), dstSquare->getRow())) return false;
-
-    bool isKing = (bit.gameTag() == RED_KING || bit.gameTag() == YELLOW_KING);
-    bool isRed = (bit.getOwner() == getPlayerAt(RED_PLAYER));
-
-    // Simple moves (if no jumps required)
-    if (!_mustContinueJumping && !hasJumpAvailable(bit.getOwner())) {
-        if (isKing) {
-            return dstSquare == _grid->getFL(srcX, srcY) || dstSquare == _grid->getFR(srcX, srcY) ||
-                   dstSquare == _grid->getBL(srcX, srcY) || dstSquare == _grid->getBR(srcX, srcY);
-        }
-        return isRed ? (dstSquare == _grid->getBL(srcX, srcY) || dstSquare == _grid->getBR(srcX, srcY)) :
-                       (dstSquare == _grid->getFL(srcX, srcY) || dstSquare == _grid->getFR(srcX, srcY));
+    for (const CheckersMove& move : _legalMoves) {
+        if (followsHops(move, from, to)) return true;
     }
-
-    // Jump moves
-    if (_mustContinueJumping && &src != _jumpingPiece) return false;
-
-    // Check all jump directions
-    auto checkJump = [&](ChessSquare* middle, ChessSquare* target) -> bool {
-        if (!middle || !target || !middle->bit()) return false;
-        if (middle->bit()->getOwner() == bit.getOwner()) return false;
-        return dstSquare == target;
-    };
-
-    if (isKing || !isRed) {
-        if (checkJump(_grid->getFL(srcX, srcY), _grid->getFLFL(srcX, srcY))) return true;
-        if (checkJump(_grid->getFR(srcX, srcY), _grid->getFRFR(srcX, srcY))) return true;
-    }
-    if (isKing || isRed) {
-        if (checkJump(_grid->getBL(srcX, srcY), _grid->getBLBL(srcX, srcY))) return true;
-        if (checkJump(_grid->getBR(srcX, srcY), _grid->getBRBR(srcX, srcY))) return true;
-    }
-
     return false;
 }
 
+//
+// a drag makes one hop, a multi-jump finishes once the hops spell out a whole legal move
+//
 void Checkers::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
     ChessSquare* srcSquare = static_cast<ChessSquare*>(&src);
     ChessSquare* dstSquare = static_cast<ChessSquare*>(&dst);
 
-    int srcX = srcSquare->getColumn();
-    int srcY = srcSquare->getRow();
-    int dstX = dstSquare->getColumn();
-    int dstY = dstSquare->getRow();
-
-    // Check for jump
-    ChessSquare* jumped = nullptr;
-    if (dstSquare == _grid->getFLFL(srcX, srcY)) jumped = _grid->getFL(srcX, srcY);
-    else if (dstSquare == _grid->getFRFR(srcX, srcY)) jumped = _grid->getFR(srcX, srcY);
-    else if (dstSquare == _grid->getBLBL(srcX, srcY)) jumped = _grid->getBL(srcX, srcY);
-    else if (dstSquare == _grid->getBRBR(srcX, srcY)) jumped = _grid->getBR(srcX, srcY);
-
-    if (jumped && jumped->bit()) {
-        // Capture
-        (jumped->bit()->getOwner() == getPlayerAt(RED_PLAYER)) ? _redPieces-- : _yellowPieces--;
-        jumped->destroyBit();
-
-        // Promotion check
-        if ((bit.gameTag() == RED_PIECE && dstY == 7) || (bit.gameTag() == YELLOW_PIECE && dstY == 0)) {
-            bit.setGameTag(bit.gameTag() == RED_PIECE ? RED_KING : YELLOW_KING);
-            bit.setScale(1.3f);
-        }
+    if (_hops.empty()) _hops.push_back(squareIndex(src));
+    _hops.push_back(squareIndex(dst));
+
+    // a jump takes the piece it passed over off the grid straight away
+    if (std::abs(dstSquare->getRow() - srcSquare->getRow()) == 2) {
+        ChessSquare* jumped = _grid->getSquare((srcSquare->getColumn() + dstSquare->getColumn()) / 2, (srcSquare->getRow() + dstSquare->getRow()) / 2);
+        if (jumped) jumped->destroyBit();
+    }
 
-        // Check for more jumps
-        if (canJumpFrom(*dstSquare)) {
-            _mustContinueJumping = true;
-            _jumpingPiece = &dst;
+    for (const CheckersMove& move : _legalMoves) {
+        if ((size_t)move.length == _hops.size() && std::equal(_hops.begin(), _hops.end(), move.path)) {
+            finishMove(move);
             return;
         }
-    } else {
-        // Regular move - promotion check
-        if ((bit.gameTag() == RED_PIECE && dstY == 7) || (bit.gameTag() == YELLOW_PIECE && dstY == 0)) {
-            bit.setGameTag(bit.gameTag() == RED_PIECE ? RED_KING : YELLOW_KING);
-            bit.setScale(1.3f);
-        }
     }
-
-    _mustContinueJumping = false;
-    _jumpingPiece = nullptr;
-    endTurn();
 }
 
-bool Checkers::canJumpFrom(ChessSquare& square) const {
-    Bit* piece = square.bit();
-    if (!piece) return false;
-
-    int x = square.getColumn();
-    int y = square.getRow();
-    bool isKing = (piece->gameTag() == RED_KING || piece->gameTag() == YELLOW_KING);
-    bool isRed = (piece->getOwner() == getPlayerAt(RED_PLAYER));
-    Player* player = piece->getOwner();
-
-    auto checkJumpDir = [&](ChessSquare* middle, ChessSquare* target) -> bool {
-        return middle && middle->bit() && middle->bit()->getOwner() != player &&
-               target && !target->bit();
-    };
-
-    if (isKing || !isRed) {
-        if (checkJumpDir(_grid->getFL(x, y), _grid->getFLFL(x, y))) return true;
-        if (checkJumpDir(_grid->getFR(x, y), _grid->getFRFR(x, y))) return true;
-    }
-    if (isKing || isRed) {
-        if (checkJumpDir(_grid->getBL(x, y), _grid->getBLBL(x, y))) return true;
-        if (checkJumpDir(_grid->getBR(x, y), _grid->getBRBR(x, y))) return true;
-    }
-    return false;
-}
+void Checkers::finishMove(const CheckersMove &move) {
+    _quietMoves = _board.isQuiet(move) ? _quietMoves + 1 : 0;
 
-bool Checkers::hasJumpAvailable(Player* player) const {
-    bool hasJump = false;
-    _grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
-        if (hasJump) return;
-        Bit* piece = square->bit();
-        if (piece && piece->getOwner() == player) {
-            Checkers* self = const_cast<Checkers*>(this);
-            if (self->canJumpFrom(*square)) {
-                hasJump = true;
-            }
-        }
-    });
-    return hasJump;
+    _board.make(move);
+    _board.generateMoves(_legalMoves);
+    _hops.clear();
+    // picks up crowned men
+    syncGrid();
+    endTurn();
 }
 
 Player* Checkers::checkForWinner() {
-    if (_redPieces == 0) return getPlayerAt(YELLOW_PLAYER);
-    if (_yellowPieces == 0) return getPlayerAt(RED_PLAYER);
-
-    // Check if current player has any moves
-    Player* current = getCurrentPlayer();
-    bool hasMove = false;
-
-    _grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
-        if (hasMove) return;
-        Bit* piece = square->bit();
-        if (piece && piece->getOwner() == current) {
-            bool isKing = (piece->gameTag() == RED_KING || piece->gameTag() == YELLOW_KING);
-            bool isRed = (current == getPlayerAt(RED_PLAYER));
-
-            // Check for any valid move
-            auto checkMove = [&](ChessSquare* target) {
-                if (target && !target->bit()) hasMove = true;
-            };
-
-            if (isKing) {
-                checkMove(_grid->getFL(x, y));
-                checkMove(_grid->getFR(x, y));
-                checkMove(_grid->getBL(x, y));
-                checkMove(_grid->getBR(x, y));
-            } else if (isRed) {
-                checkMove(_grid->getBL(x, y));
-                checkMove(_grid->getBR(x, y));
-            } else {
-                checkMove(_grid->getFL(x, y));
-                checkMove(_grid->getFR(x, y));
-            }
-        }
-    });
-
-    if (!hasMove) {
-        return current == getPlayerAt(RED_PLAYER) ? getPlayerAt(YELLOW_PLAYER) : getPlayerAt(RED_PLAYER);
+    // a side with no pieces or no legal moves has lost
+    if (_legalMoves.count == 0) {
+        return getPlayerAt(_board.sideToMove() == CheckersBoard::kRed ? YELLOW_PLAYER : RED_PLAYER);
     }
     return nullptr;
 }
 
 bool Checkers::checkForDraw() {
-    return false;
+    return _quietMoves >= CheckersBoard::kDrawQuietMoves && _legalMoves.count > 0;
 }
 
 void Checkers::stopGame() {
     _grid->forEachSquare([](ChessSquare* square, int x, int y) {
         square->destroyBit();
     });
-    _mustContinueJumping = false;
-    _jumpingPiece = nullptr;
-    _redPieces = 12;
-    _yellowPieces = 12;
+    _board = CheckersBoard();
+    _legalMoves.count = 0;
+    _hops.clear();
+    _quietMoves = 0;
 }
 
 std::string Checkers::initialStateString() {
@@ -270,25 +193,59 @@ std::string Checkers::stateString() {
 void Checkers::setStateString(const std::string &s) {
     if (s.length() != 32) return;
 
-    _redPieces = 0;
-    _yellowPieces = 0;
-
-    _grid->setStateString(s);
-
-    // Recreate pieces from state
-    size_t index = 0;
-    _grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
-        if (index < s.length()) {
-            int pieceType = s[index++] - '0';
-            if (pieceType != 0) {
-                Bit* piece = createPiece(pieceType);
-                piece->setPosition(square->getPosition());
-                square->setBit(piece);
-                (pieceType == RED_PIECE || pieceType == RED_KING) ? _redPieces++ : _yellowPieces++;
-            }
-        }
-    });
+    _board = CheckersBoard::fromState(s, getCurrentPlayer()->playerNumber());
+    _board.generateMoves(_legalMoves);
+    _hops.clear();
+    syncGrid();
 }
 
-void Checkers::updateAI() {}
+void Checkers::updateAI() {
+    applyAIMove(searchAIMove(stateString(), getCurrentPlayer()->playerNumber(), aiOptions()));
+}
 
+//
+// runs on a worker thread from a state snapshot, returns the squares the piece visits as "9-14"
+//
+std::string Checkers::searchAIMove(const std::string &state, int playerNumber, const AIOptions &options) {
+    CheckersBoard board = CheckersBoard::fromState(state, playerNumber);
+    CheckersMove move;
+    if (!_ai.findMove(board, options.maxDepth, kAIThinkTimeMs, move)) {
+        return "";
+    }
+    std::string path;
+    for (int i = 0; i < move.length; i++) {
+        if (i) {
+            path += '-';
+        }
+        path += std::to_string(move.path[i]);
+    }
+    return path;
+}
+
+bool Checkers::applyAIMove(const std::string &move) {
+    std::vector<int> path;
+    std::stringstream stream(move);
+    std::string square;
+    while (std::getline(stream, square, '-')) {
+        path.push_back(std::stoi(square));
+    }
+    if (path.size() < 2) return false;
+
+    for (const CheckersMove& legal : _legalMoves) {
+        if ((size_t)legal.length != path.size() || !std::equal(path.begin(), path.end(), legal.path)) continue;
+
+        ChessSquare* src = squareFor(path.front());
+        ChessSquare* dst = squareFor(path.back());
+        Bit* bit = src->bit();
+        if (!bit) return false;
+        dst->setBit(bit);
+        bit->moveTo(dst->getPosition());
+        for (uint32_t captured = legal.captured; captured; captured &= captured - 1) {
+            squareFor(std::countr_zero(captured))->destroyBit();
+        }
+        _hops.clear();
+        finishMove(legal);
+        return true;
+    }
+    return false;
+}
@@ -1,5 +1,8 @@
 #pragma once
 #include "Game.h"
+#include "CheckersBoard.h"
+#include "CheckersAI.h"
+#include <vector>
 
 // NOTE: If Square class needs modifications to support colored squares for checkerboard pattern,
 // add a method like setColor(ImVec4 color) to Square class
@@ -25,7 +28,10 @@ public:
 
     // AI methods
     void        updateAI() override;
-    bool        gameHasAI() override { return false; } // Set to true when AI is implemented
+    bool        gameHasAI() override { return true; }
+    bool        gameHasBackgroundAI() override { return true; }
+    std::string searchAIMove(const std::string &state, int playerNumber, const AIOptions &options) override;
+    bool        applyAIMove(const std::string &move) override;
     Grid* getGrid() override { return _grid; }
 
 private:
@@ -42,23 +48,23 @@ private:
 
     // Helper methods
     Bit*        createPiece(int pieceType);
-    int         getPieceType(const Bit& bit) const;
-    bool        isKing(const Bit& bit) const;
-    bool        isValidMove(int srcX, int srcY, int dstX, int dstY, Player* player) const;
-    bool        isJumpMove(int srcX, int srcY, int dstX, int dstY) const;
-    bool        hasJumpAvailable(Player* player) const;
-    bool        canJumpFrom(ChessSquare& square) const;
-    void        performJump(int srcX, int srcY, int dstX, int dstY);
-    void        promoteToKing(Bit& bit, int y);
-    void        getBoardPosition(BitHolder &holder, int &x, int &y) const;
-    bool        isValidSquare(int x, int y) const;
+    int         squareIndex(BitHolder &holder) const;
+    ChessSquare* squareFor(int index) const;
+    // does move start with the hops already made this turn followed by from -> to
+    bool        followsHops(const CheckersMove &move, int from, int to) const;
+    void        finishMove(const CheckersMove &move);
+    void        syncGrid();
 
-    // Board representation
-    Grid*        _grid;
+    // Board representation, the bitboards are the rules and the grid mirrors them
+    Grid*          _grid;
+    CheckersBoard  _board;
+    CheckersMoveList _legalMoves;
 
     // Game state
-    bool        _mustContinueJumping;
-    BitHolder*  _jumpingPiece;
-    int         _redPieces;
-    int         _yellowPieces;
-};
\ No newline at end of file
+    // squares visited so far by a multi-jump being dragged one hop at a time
+    std::vector<int> _hops;
+    int            _quietMoves;
+
+    // only ever used by this game's one pending AI job
+    CheckersAI     _ai;
+};
@@ -0,0 +1,113 @@
+#include "CheckersAI.h"
+#include "CheckersEndgame.h"
+#include <algorithm>
+
+namespace {
+    const int kManValue = 100;
+    const int kKingValue = 160;
+    // per row a man has advanced
+    const int kAdvance = 3;
+    // men still guarding their own back row keep the opponent from crowning
+    const int kBackRank = 10;
+    const int kCentre = 5;
+
+    const uint32_t kBackRow[2] = { 0x0000000fu, 0xf0000000u };
+    const uint32_t kCentreSquares = 0x00666600u;
+}
+
+CheckersSearchState::CheckersSearchState(const CheckersBoard &board, const CheckersEndgame *endgame, int probePieces)
+{
+    _stack.reserve(Search<CheckersSearchState>::kMaxPly + 1);
+    _stack.push_back(board);
+    _endgame = endgame;
+    _probePieces = endgame ? probePieces : 0;
+}
+
+int CheckersSearchState::evaluate() const
+{
+    // no moves loses, the search makes sooner worse
+    CheckersMoveList list;
+    board().generateMoves(list);
+    if (list.count == 0) {
+        return -kSearchWinScore;
+    }
+    return CheckersAI::evaluate(board());
+}
+
+//
+// bigger captures first, then crowning moves
+//
+int CheckersSearchState::scoreMove(const CheckersMove &move) const
+{
+    int score = 10 * std::popcount(move.captured);
+    if (move.to & (CheckersBoard::kPromotionRow[0] | CheckersBoard::kPromotionRow[1])) {
+        score += 5;
+    }
+    return score;
+}
+
+bool CheckersSearchState::exactScore(int &score) const
+{
+    if (std::popcount(board().occupied()) > _probePieces) {
+        return false;
+    }
+    switch (_endgame->probe(board())) {
+        case CheckersEndgame::kWin: score = kDatabaseWin + CheckersAI::evaluate(board()); return true;
+        case CheckersEndgame::kLoss: score = -kDatabaseWin + CheckersAI::evaluate(board()); return true;
+        case CheckersEndgame::kDraw: score = 0; return true;
+        default: return false;
+    }
+}
+
+CheckersAI::CheckersAI(size_t tableEntries) : _search(tableEntries)
+{
+    _endgame = nullptr;
+    _nodes = 0;
+    _lastScore = 0;
+    _lastDepth = 0;
+}
+
+int CheckersAI::evaluate(const CheckersBoard &board)
+{
+    int score[2] = { 0, 0 };
+    for (int side = 0; side < 2; side++) {
+        uint32_t men = board.men(side);
+        score[side] += kManValue * std::popcount(men) + kKingValue * std::popcount(board.kings(side));
+        score[side] += kBackRank * std::popcount(men & kBackRow[side]);
+        score[side] += kCentre * std::popcount(board.pieces(side) & kCentreSquares);
+        for (uint32_t bits = men; bits; bits &= bits - 1) {
+            int row = CheckersBoard::rowOf(std::countr_zero(bits));
+            score[side] += kAdvance * (side == CheckersBoard::kRed ? row : 7 - row);
+        }
+    }
+    int side = board.sideToMove();
+    return score[side] - score[side ^ 1];
+}
+
+bool CheckersAI::findMove(const CheckersBoard &board, int maxDepth, int timeLimitMs, CheckersMove &bestMove)
+{
+    CheckersMoveList list;
+    board.generateMoves(list);
+    if (list.count == 0) {
+        return false;
+    }
+    bestMove = list.moves[0];
+    if (list.count == 1) {
+        return true;
+    }
+
+    // once the game is in the database a value alone can't say which move makes progress, so
+    // only positions after a capture get probed and the search has to find the way there
+    int probePieces = _endgame ? std::min(_endgame->maxPieces(), std::popcount(board.occupied()) - 1) : 0;
+    CheckersSearchState state(board, _endgame, probePieces);
+    Search<CheckersSearchState>::Limits limits;
+    limits.maxDepth = maxDepth > 0 ? std::min(maxDepth, Search<CheckersSearchState>::kMaxPly / 2) : Search<CheckersSearchState>::kMaxPly / 2;
+    limits.timeLimitMs = timeLimitMs;
+    Search<CheckersSearchState>::Result result = _search.run(state, limits);
+
+    bestMove = result.bestMove;
+    _nodes = result.nodes;
+    _lastScore = result.score;
+    _lastDepth = result.depth;
+    return true;
+}
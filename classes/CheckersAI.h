@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CheckersBoard.h"
+#include "Search.h"
+#include <vector>
+
+class CheckersEndgame;
+
+//
+// CheckersBoard as a SearchState: copy-make with a stack of positions, pending captures are
+// forcing so they're searched past the horizon, and an endgame database answers positions
+// it holds
+//
+class CheckersSearchState
+{
+public:
+    using Move = CheckersMove;
+    using MoveList = CheckersMoveList;
+
+    // endgame wins score this much plus the evaluation, so the search still heads for simpler
+    // wins, and always below a win it can see to the end
+    static const int kDatabaseWin = 50000;
+
+    // endgame is probed for positions of probePieces or fewer, nullptr for none
+    CheckersSearchState(const CheckersBoard &board, const CheckersEndgame *endgame = nullptr, int probePieces = 0);
+
+    const CheckersBoard &board() const { return _stack.back(); }
+
+    void generateMoves(CheckersMoveList &list) const { board().generateMoves(list); }
+    void make(const CheckersMove &move)
+    {
+        _stack.push_back(board());
+        _stack.back().make(move);
+    }
+    void unmake(const CheckersMove &) { _stack.pop_back(); }
+    int evaluate() const;
+    uint64_t hash() const { return board().hash(); }
+
+    bool isForcing() const { return board().hasCapture(); }
+    int scoreMove(const CheckersMove &move) const;
+    bool exactScore(int &score) const;
+
+private:
+    std::vector<CheckersBoard> _stack;
+    const CheckersEndgame *_endgame;
+    int _probePieces;
+};
+
+//
+// checkers player: iterative deepening alpha-beta through Search, scores are from the side to
+// move's point of view
+//
+class CheckersAI
+{
+public:
+    static const int kWinScore = kSearchWinScore;
+
+    CheckersAI(size_t tableEntries = 1 << 20);
+
+    // best move for the side to move, false if it has none (and has lost), searching up to
+    // maxDepth plies and stopping after timeLimitMs (0 for no limit)
+    bool findMove(const CheckersBoard &board, int maxDepth, int timeLimitMs, CheckersMove &bestMove);
+
+    // material, advancement, back rank and centre
+    static int evaluate(const CheckersBoard &board);
+
+    // forget the table, for a new game
+    void clear() { _search.table().clear(); }
+
+    // score positions from an endgame database instead of searching them, nullptr for none
+    void setEndgame(const CheckersEndgame *endgame) { _endgame = endgame; }
+
+    uint64_t nodes() const { return _nodes; }
+    int lastScore() const { return _lastScore; }
+    int lastDepth() const { return _lastDepth; }
+
+private:
+    Search<CheckersSearchState> _search;
+    const CheckersEndgame *_endgame;
+    uint64_t _nodes;
+    int _lastScore;
+    int _lastDepth;
+};
@@ -0,0 +1,213 @@
+#include "CheckersBoard.h"
+#include <array>
+
+namespace {
+    // the directions each side's men may move in, kings use all four
+    const int kManDirections[2][2] = { { 0, 1 }, { 2, 3 } };
+
+    // zobrist keys: [side][man/king][square], then the side to move
+    constexpr std::array<uint64_t, 2 * 2 * 32 + 1> makeKeys()
+    {
+        std::array<uint64_t, 2 * 2 * 32 + 1> keys{};
+        uint64_t seed = 0x2545f4914f6cdd1dULL;
+        for (uint64_t &key : keys) {
+            // splitmix64
+            seed += 0x9e3779b97f4a7c15ULL;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            key = z ^ (z >> 31);
+        }
+        return keys;
+    }
+    constexpr std::array<uint64_t, 2 * 2 * 32 + 1> kKeys = makeKeys();
+}
+
+uint64_t CheckersBoard::pieceKey(int side, bool king, int square)
+{
+    return kKeys[(side * 2 + (king ? 1 : 0)) * 32 + square];
+}
+
+uint64_t CheckersBoard::sideKey()
+{
+    return kKeys[2 * 2 * 32];
+}
+
+CheckersBoard::CheckersBoard(uint32_t redMen, uint32_t redKings, uint32_t yellowMen, uint32_t yellowKings, int side)
+{
+    _men[kRed] = redMen;
+    _kings[kRed] = redKings;
+    _men[kYellow] = yellowMen;
+    _kings[kYellow] = yellowKings;
+    _side = side;
+    computeHash();
+}
+
+void CheckersBoard::computeHash()
+{
+    _hash = _side == kYellow ? sideKey() : 0;
+    for (int side = 0; side < 2; side++) {
+        for (uint32_t bits = _men[side]; bits; bits &= bits - 1) {
+            _hash ^= pieceKey(side, false, std::countr_zero(bits));
+        }
+        for (uint32_t bits = _kings[side]; bits; bits &= bits - 1) {
+            _hash ^= pieceKey(side, true, std::countr_zero(bits));
+        }
+    }
+}
+
+bool CheckersBoard::hasCapture() const
+{
+    uint32_t opponents = pieces(_side ^ 1);
+    uint32_t open = empty();
+    for (int direction = 0; direction < 4; direction++) {
+        bool forward = direction == kManDirections[_side][0] || direction == kManDirections[_side][1];
+        uint32_t movers = forward ? pieces(_side) : _kings[_side];
+        if (step(step(movers, direction) & opponents, direction) & open) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//
+// extend the jump sequence in move from at, recording it once no further jump is possible
+// captured pieces stay on the board (they can't be jumped twice and still block) until the
+// move is made, and the mover's own starting square counts as empty
+//
+void CheckersBoard::addCaptures(CheckersMoveList &list, CheckersMove &move, uint32_t at, bool king) const
+{
+    uint32_t opponents = pieces(_side ^ 1) & ~move.captured;
+    uint32_t open = empty() | move.from;
+    bool extended = false;
+    for (int direction = 0; direction < 4; direction++) {
+        if (!king && direction != kManDirections[_side][0] && direction != kManDirections[_side][1]) {
+            continue;
+        }
+        uint32_t jumped = step(at, direction) & opponents;
+        uint32_t landing = step(jumped, direction) & open;
+        if (!landing || move.length >= CheckersMove::kMaxPath) {
+            continue;
+        }
+        extended = true;
+        move.captured |= jumped;
+        move.path[move.length++] = (int8_t)std::countr_zero(landing);
+        // a man that's crowned mid-jump ends the move there
+        if (!king && (landing & kPromotionRow[_side])) {
+            if (list.count < CheckersMoveList::kMaxMoves) {
+                move.to = landing;
+                list.moves[list.count++] = move;
+            }
+        } else {
+            addCaptures(list, move, landing, king);
+        }
+        move.length--;
+        move.captured &= ~jumped;
+    }
+    if (!extended && move.captured && list.count < CheckersMoveList::kMaxMoves) {
+        move.to = at;
+        list.moves[list.count++] = move;
+    }
+}
+
+void CheckersBoard::generateMoves(CheckersMoveList &list) const
+{
+    list.count = 0;
+    if (hasCapture()) {
+        for (uint32_t bits = pieces(_side); bits; bits &= bits - 1) {
+            uint32_t from = bits & (0u - bits);
+            CheckersMove move;
+            move.from = from;
+            move.to = from;
+            move.captured = 0;
+            move.path[0] = (int8_t)std::countr_zero(from);
+            move.length = 1;
+            addCaptures(list, move, from, (_kings[_side] & from) != 0);
+        }
+        return;
+    }
+
+    uint32_t open = empty();
+    for (uint32_t bits = pieces(_side); bits; bits &= bits - 1) {
+        uint32_t from = bits & (0u - bits);
+        bool king = (_kings[_side] & from) != 0;
+        for (int direction = 0; direction < 4; direction++) {
+            if (!king && direction != kManDirections[_side][0] && direction != kManDirections[_side][1]) {
+                continue;
+            }
+            uint32_t to = step(from, direction) & open;
+            if (to && list.count < CheckersMoveList::kMaxMoves) {
+                CheckersMove &move = list.moves[list.count++];
+                move.from = from;
+                move.to = to;
+                move.captured = 0;
+                move.path[0] = (int8_t)std::countr_zero(from);
+                move.path[1] = (int8_t)std::countr_zero(to);
+                move.length = 2;
+            }
+        }
+    }
+}
+
+void CheckersBoard::make(const CheckersMove &move)
+{
+    int side = _side;
+    int other = side ^ 1;
+    int from = std::countr_zero(move.from);
+    int to = std::countr_zero(move.to);
+    bool king = (_kings[side] & move.from) != 0;
+
+    // a king's jumps can bring it back round to where it started
+    uint32_t &movers = king ? _kings[side] : _men[side];
+    movers = (movers & ~move.from) | move.to;
+    if (from != to) {
+        _hash ^= pieceKey(side, king, from) ^ pieceKey(side, king, to);
+    }
+
+    for (uint32_t bits = move.captured; bits; bits &= bits - 1) {
+        int square = std::countr_zero(bits);
+        bool capturedKing = (_kings[other] >> square) & 1;
+        _hash ^= pieceKey(other, capturedKing, square);
+    }
+    _men[other] &= ~move.captured;
+    _kings[other] &= ~move.captured;
+
+    if (!king && (move.to & kPromotionRow[side])) {
+        _men[side] ^= move.to;
+        _kings[side] |= move.to;
+        _hash ^= pieceKey(side, false, to) ^ pieceKey(side, true, to);
+    }
+
+    _side = other;
+    _hash ^= sideKey();
+}
+
+CheckersBoard CheckersBoard::flipped() const
+{
+    return CheckersBoard(rotated(_men[kYellow]), rotated(_kings[kYellow]), rotated(_men[kRed]), rotated(_kings[kRed]), _side ^ 1);
+}
+
+CheckersBoard CheckersBoard::fromState(const std::string &state, int side)
+{
+    uint32_t bits[5] = { 0, 0, 0, 0, 0 };
+    for (size_t square = 0; square < 32 && square < state.length(); square++) {
+        int piece = state[square] - '0';
+        if (piece >= 1 && piece <= 4) {
+            bits[piece] |= 1u << square;
+        }
+    }
+    return CheckersBoard(bits[1], bits[2], bits[3], bits[4], side);
+}
+
+std::string CheckersBoard::stateString() const
+{
+    std::string state(32, '0');
+    for (int square = 0; square < 32; square++) {
+        uint32_t bit = 1u << square;
+        if (_men[kRed] & bit) state[square] = '1';
+        else if (_kings[kRed] & bit) state[square] = '2';
+        else if (_men[kYellow] & bit) state[square] = '3';
+        else if (_kings[kYellow] & bit) state[square] = '4';
+    }
+    return state;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <bit>
+#include <string>
+
+//
+// a checkers move: the squares the piece visits (from, every landing square) and the pieces it
+// captures on the way. squares are 0-31, four dark squares per row from the top row down
+//
+struct CheckersMove
+{
+    static const int kMaxPath = 16;
+
+    uint32_t from;
+    uint32_t to;
+    uint32_t captured;
+    int8_t path[kMaxPath];
+    int8_t length;
+
+    bool isCapture() const { return captured != 0; }
+    bool operator==(const CheckersMove &other) const { return from == other.from && to == other.to && captured == other.captured; }
+};
+
+struct CheckersMoveList
+{
+    static const int kMaxMoves = 128;
+
+    CheckersMove moves[kMaxMoves];
+    int count = 0;
+
+    CheckersMove *begin() { return moves; }
+    CheckersMove *end() { return moves + count; }
+    const CheckersMove *begin() const { return moves; }
+    const CheckersMove *end() const { return moves + count; }
+};
+
+//
+// 32-square bitboard checkers position: men and kings for each side, red (side 0) starts on
+// the top three rows and moves down, yellow (side 1) starts at the bottom and moves up
+//
+// even rows have their dark squares one column to the right of odd rows, so a diagonal step
+// is a shift by 4 plus a shift by 3 or 5 depending on the row parity
+//
+class CheckersBoard
+{
+public:
+    static const int kRed = 0;
+    static const int kYellow = 1;
+    // moves without a capture or a man moving before the game is drawn, there's no repetition rule
+    static const int kDrawQuietMoves = 80;
+
+    CheckersBoard() : _men{ 0, 0 }, _kings{ 0, 0 }, _side(kRed), _hash(0) {}
+    CheckersBoard(uint32_t redMen, uint32_t redKings, uint32_t yellowMen, uint32_t yellowKings, int side);
+
+    static CheckersBoard initialPosition() { return CheckersBoard(0x00000fffu, 0, 0xfff00000u, 0, kRed); }
+
+    uint32_t men(int side) const { return _men[side]; }
+    uint32_t kings(int side) const { return _kings[side]; }
+    uint32_t pieces(int side) const { return _men[side] | _kings[side]; }
+    uint32_t occupied() const { return pieces(kRed) | pieces(kYellow); }
+    uint32_t empty() const { return ~occupied(); }
+    int sideToMove() const { return _side; }
+    uint64_t hash() const { return _hash; }
+
+    // legal moves for the side to move: only captures (every complete jump sequence) when any
+    // capture exists, otherwise simple moves. men that reach the far row are crowned and stop
+    void generateMoves(CheckersMoveList &list) const;
+    bool hasCapture() const;
+    void make(const CheckersMove &move);
+    // a king moving without capturing, which counts towards kDrawQuietMoves
+    bool isQuiet(const CheckersMove &move) const { return !move.isCapture() && (_kings[_side] & move.from) != 0; }
+    // the same position seen from the other side: board turned around and colours swapped
+    CheckersBoard flipped() const;
+    bool operator==(const CheckersBoard &other) const
+    {
+        return _men[0] == other._men[0] && _men[1] == other._men[1] && _kings[0] == other._kings[0] && _kings[1] == other._kings[1] && _side == other._side;
+    }
+
+    // the Checkers game's 32 character state ('0' empty, '1'/'2' red man/king, '3'/'4' yellow)
+    static CheckersBoard fromState(const std::string &state, int side);
+    std::string stateString() const;
+
+    // grid coordinates of a square (row 0 at the top) and back, -1 for light squares
+    static int squareAt(int x, int y) { return ((x + y) & 1) ? y * 4 + x / 2 : -1; }
+    static int columnOf(int square) { return 2 * (square & 3) + (((square >> 2) & 1) ? 0 : 1); }
+    static int rowOf(int square) { return square >> 2; }
+
+    // square s becomes 31 - s when the board is turned around
+    static uint32_t rotated(uint32_t bits)
+    {
+        bits = ((bits >> 1) & 0x55555555u) | ((bits & 0x55555555u) << 1);
+        bits = ((bits >> 2) & 0x33333333u) | ((bits & 0x33333333u) << 2);
+        bits = ((bits >> 4) & 0x0f0f0f0fu) | ((bits & 0x0f0f0f0fu) << 4);
+        bits = ((bits >> 8) & 0x00ff00ffu) | ((bits & 0x00ff00ffu) << 8);
+        return (bits >> 16) | (bits << 16);
+    }
+
+    // one diagonal step: down-left, down-right, up-left, up-right
+    static uint32_t step(uint32_t bits, int direction)
+    {
+        switch (direction) {
+            case 0: return ((bits & kEvenRows) << 4) | ((bits & kOddRows & ~kColumn0) << 3);
+            case 1: return ((bits & kEvenRows & ~kColumn3) << 5) | ((bits & kOddRows) << 4);
+            case 2: return ((bits & kEvenRows) >> 4) | ((bits & kOddRows & ~kColumn0) >> 5);
+            default: return ((bits & kEvenRows & ~kColumn3) >> 3) | ((bits & kOddRows) >> 4);
+        }
+    }
+
+    // far row for each side's men
+    static constexpr uint32_t kPromotionRow[2] = { 0xf0000000u, 0x0000000fu };
+
+private:
+    static constexpr uint32_t kEvenRows = 0x0f0f0f0fu;
+    static constexpr uint32_t kOddRows = 0xf0f0f0f0u;
+    static constexpr uint32_t kColumn0 = 0x11111111u;
+    static constexpr uint32_t kColumn3 = 0x88888888u;
+
+    // zobrist keys for a piece on a square and for yellow to move
+    static uint64_t pieceKey(int side, bool king, int square);
+    static uint64_t sideKey();
+
+    void addCaptures(CheckersMoveList &list, CheckersMove &move, uint32_t at, bool king) const;
+    void computeHash();
+
+    uint32_t _men[2];
+    uint32_t _kings[2];
+    int _side;
+    uint64_t _hash;
+};
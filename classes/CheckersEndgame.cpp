@@ -0,0 +1,300 @@
+#include "CheckersEndgame.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace {
+    // men never stand on their own promotion row, so each side's men have 28 squares
+    const int kManSquares = 28;
+    const uint32_t kRedManSquares = 0x0fffffffu;
+    const uint32_t kYellowManSquares = 0xfffffff0u;
+
+    constexpr std::array<std::array<uint64_t, 33>, 33> makeBinomials()
+    {
+        std::array<std::array<uint64_t, 33>, 33> table{};
+        for (int n = 0; n <= 32; n++) {
+            table[n][0] = 1;
+            for (int k = 1; k <= n; k++) {
+                table[n][k] = table[n - 1][k - 1] + (k < n ? table[n - 1][k] : 0);
+            }
+        }
+        return table;
+    }
+    constexpr std::array<std::array<uint64_t, 33>, 33> kBinomial = makeBinomials();
+
+    uint64_t choose(int n, int k)
+    {
+        return (k < 0 || n < 0 || k > n) ? 0 : kBinomial[n][k];
+    }
+
+    // rank of a set of squares among the squares free allows, in the combinatorial number system
+    uint64_t rankSquares(uint32_t squares, uint32_t free)
+    {
+        uint64_t rank = 0;
+        int k = 1;
+        for (uint32_t bits = squares; bits; bits &= bits - 1, k++) {
+            uint32_t below = (bits & (0u - bits)) - 1;
+            rank += choose(std::popcount(free & below), k);
+        }
+        return rank;
+    }
+
+    // the inverse of rankSquares, 0 if it needs more free squares than there are
+    uint32_t unrankSquares(uint64_t rank, int count, uint32_t free)
+    {
+        int position[32];
+        int p = 31;
+        for (int k = count; k >= 1; k--) {
+            while (choose(p, k) > rank) {
+                p--;
+            }
+            position[k - 1] = p;
+            rank -= choose(p, k);
+            p--;
+        }
+        uint32_t squares = 0;
+        for (int k = 0; k < count; k++) {
+            // the position'th free square
+            uint32_t bits = free;
+            for (int skip = 0; skip < position[k] && bits; skip++) {
+                bits &= bits - 1;
+            }
+            if (!bits) {
+                return 0;
+            }
+            squares |= bits & (0u - bits);
+        }
+        return squares;
+    }
+
+    // multipliers of each group's rank in the slice index
+    struct IndexRadix
+    {
+        uint64_t yellowMen;
+        uint64_t redKings;
+        uint64_t yellowKings;
+    };
+
+    IndexRadix radixOf(const CheckersEndgame::Slice &slice)
+    {
+        int men = slice.redMen + slice.yellowMen;
+        return IndexRadix{ choose(kManSquares, slice.yellowMen), choose(32 - men, slice.redKings), choose(32 - men - slice.redKings, slice.yellowKings) };
+    }
+}
+
+CheckersEndgame::CheckersEndgame()
+{
+    _slices = nullptr;
+    _blockOffsets = nullptr;
+    _data = nullptr;
+    _maxPieces = 0;
+}
+
+CheckersEndgame::~CheckersEndgame()
+{
+    close();
+}
+
+CheckersEndgame::Slice CheckersEndgame::sliceOf(const CheckersBoard &board)
+{
+    return Slice{ (uint8_t)std::popcount(board.men(CheckersBoard::kRed)), (uint8_t)std::popcount(board.kings(CheckersBoard::kRed)),
+                  (uint8_t)std::popcount(board.men(CheckersBoard::kYellow)), (uint8_t)std::popcount(board.kings(CheckersBoard::kYellow)) };
+}
+
+uint64_t CheckersEndgame::sliceSize(const Slice &slice)
+{
+    IndexRadix radix = radixOf(slice);
+    return choose(kManSquares, slice.redMen) * radix.yellowMen * radix.redKings * radix.yellowKings;
+}
+
+//
+// yellow men are ranked among the yellow man squares red men left free, so a slice has a few
+// more indices than positions. kings are ranked exactly among whatever the men left
+//
+uint64_t CheckersEndgame::indexOf(const CheckersBoard &board)
+{
+    Slice slice = sliceOf(board);
+    IndexRadix radix = radixOf(slice);
+    uint32_t redMen = board.men(CheckersBoard::kRed);
+    uint32_t men = redMen | board.men(CheckersBoard::kYellow);
+    uint32_t redKings = board.kings(CheckersBoard::kRed);
+
+    uint64_t index = rankSquares(redMen, kRedManSquares);
+    index = index * radix.yellowMen + rankSquares(board.men(CheckersBoard::kYellow), kYellowManSquares & ~redMen);
+    index = index * radix.redKings + rankSquares(redKings, ~men);
+    index = index * radix.yellowKings + rankSquares(board.kings(CheckersBoard::kYellow), ~(men | redKings));
+    return index;
+}
+
+bool CheckersEndgame::positionAt(const Slice &slice, uint64_t index, CheckersBoard &board)
+{
+    IndexRadix radix = radixOf(slice);
+    uint64_t yellowKingRank = index % radix.yellowKings;
+    index /= radix.yellowKings;
+    uint64_t redKingRank = index % radix.redKings;
+    index /= radix.redKings;
+    uint64_t yellowManRank = index % radix.yellowMen;
+    uint64_t redManRank = index / radix.yellowMen;
+
+    uint32_t redMen = unrankSquares(redManRank, slice.redMen, kRedManSquares);
+    uint32_t yellowMen = unrankSquares(yellowManRank, slice.yellowMen, kYellowManSquares & ~redMen);
+    if (std::popcount(yellowMen) != slice.yellowMen) {
+        return false;
+    }
+    uint32_t men = redMen | yellowMen;
+    uint32_t redKings = unrankSquares(redKingRank, slice.redKings, ~men);
+    uint32_t yellowKings = unrankSquares(yellowKingRank, slice.yellowKings, ~(men | redKings));
+    board = CheckersBoard(redMen, redKings, yellowMen, yellowKings, CheckersBoard::kRed);
+    return true;
+}
+
+bool CheckersEndgame::open(const std::string &path)
+{
+    close();
+    if (!_file.open(path) || _file.size() < sizeof(Header)) {
+        close();
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, _file.data(), sizeof(Header));
+    size_t tableSize = sizeof(Header) + (size_t)header.sliceCount * sizeof(SliceEntry);
+    if (std::memcmp(header.magic, "CKDB", 4) != 0 || header.version != kVersion || header.blockSize != kBlockSize ||
+        header.maxPieces > (uint32_t)kMaxPieces || tableSize > _file.size()) {
+        close();
+        return false;
+    }
+    _slices = reinterpret_cast<const SliceEntry *>(_file.data() + sizeof(Header));
+    _maxPieces = (int)header.maxPieces;
+
+    // every slice's blocks follow the previous slice's
+    uint64_t blockCount = 0;
+    int side = _maxPieces + 1;
+    _sliceLookup.assign((size_t)side * side * side * side, -1);
+    for (uint32_t i = 0; i < header.sliceCount; i++) {
+        const Slice &slice = _slices[i].slice;
+        if (slice.pieces() > _maxPieces || _slices[i].firstBlock != blockCount) {
+            close();
+            return false;
+        }
+        _sliceLookup[((slice.redMen * side + slice.redKings) * side + slice.yellowMen) * side + slice.yellowKings] = (int)i;
+        blockCount += (sliceSize(slice) + kBlockSize - 1) / kBlockSize;
+    }
+
+    size_t dataStart = tableSize + (size_t)(blockCount + 1) * sizeof(uint64_t);
+    if (dataStart > _file.size()) {
+        close();
+        return false;
+    }
+    _blockOffsets = reinterpret_cast<const uint64_t *>(_file.data() + tableSize);
+    _data = reinterpret_cast<const uint8_t *>(_file.data() + dataStart);
+    if (_blockOffsets[blockCount] > _file.size() - dataStart) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void CheckersEndgame::close()
+{
+    _file.close();
+    _slices = nullptr;
+    _blockOffsets = nullptr;
+    _data = nullptr;
+    _maxPieces = 0;
+    _sliceLookup.clear();
+}
+
+int CheckersEndgame::sliceId(const Slice &slice) const
+{
+    if (slice.pieces() > _maxPieces) {
+        return -1;
+    }
+    int side = _maxPieces + 1;
+    return _sliceLookup[((slice.redMen * side + slice.redKings) * side + slice.yellowMen) * side + slice.yellowKings];
+}
+
+CheckersEndgame::Value CheckersEndgame::probe(const CheckersBoard &board) const
+{
+    if (!isOpen()) {
+        return kUnknown;
+    }
+    CheckersBoard position = board.sideToMove() == CheckersBoard::kRed ? board : board.flipped();
+    int id = sliceId(sliceOf(position));
+    if (id < 0) {
+        return kUnknown;
+    }
+
+    uint64_t index = indexOf(position);
+    uint64_t block = _slices[id].firstBlock + index / kBlockSize;
+    uint32_t offset = (uint32_t)(index % kBlockSize);
+    const uint8_t *run = _data + _blockOffsets[block];
+    const uint8_t *end = _data + _blockOffsets[block + 1];
+    for (; run < end; run++) {
+        uint32_t length = (*run & 63) + 1;
+        if (offset < length) {
+            return (Value)(*run >> 6);
+        }
+        offset -= length;
+    }
+    return kUnknown;
+}
+
+//
+// indices with no position can't be probed, so they take whatever value extends the current
+// run, which is most of what makes the runs long
+//
+bool CheckersEndgame::write(const std::string &path, int maxPieces, const std::vector<Slice> &slices, const std::vector<std::vector<uint8_t>> &values)
+{
+    std::vector<SliceEntry> entries;
+    std::vector<uint64_t> blockOffsets;
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < slices.size(); i++) {
+        entries.push_back(SliceEntry{ slices[i], 0, blockOffsets.size() });
+        const std::vector<uint8_t> &slice = values[i];
+        for (size_t first = 0; first < slice.size(); first += kBlockSize) {
+            blockOffsets.push_back(data.size());
+            size_t last = std::min(slice.size(), first + kBlockSize);
+            uint8_t value = kDraw;
+            uint32_t length = 0;
+            for (size_t index = first; index < last; index++) {
+                uint8_t next = slice[index] == kUnknown ? value : slice[index];
+                if (length > 0 && (next != value || length == 64)) {
+                    data.push_back((uint8_t)((value << 6) | (length - 1)));
+                    length = 0;
+                }
+                value = next;
+                length++;
+            }
+            data.push_back((uint8_t)((value << 6) | (length - 1)));
+        }
+    }
+    blockOffsets.push_back(data.size());
+
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    Header header;
+    std::memcpy(header.magic, "CKDB", 4);
+    header.version = kVersion;
+    header.maxPieces = (uint32_t)maxPieces;
+    header.sliceCount = (uint32_t)entries.size();
+    header.blockSize = kBlockSize;
+    header.reserved = 0;
+    bool written = std::fwrite(&header, sizeof(Header), 1, file) == 1 &&
+                   std::fwrite(entries.data(), sizeof(SliceEntry), entries.size(), file) == entries.size() &&
+                   std::fwrite(blockOffsets.data(), sizeof(uint64_t), blockOffsets.size(), file) == blockOffsets.size() &&
+                   std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    return std::fclose(file) == 0 && written;
+}
+
+const CheckersEndgame &CheckersEndgame::sharedDatabase()
+{
+    static CheckersEndgame database;
+    static bool opened = database.open((std::filesystem::path("resources") / "checkers.db").string());
+    (void)opened;
+    return database;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CheckersBoard.h"
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+
+//
+// checkers endgame database: the win/loss/draw value of every position with up to some number
+// of pieces, solved offline by tools/checkers_endgame and memory mapped at runtime
+//
+// positions are split into slices by piece counts and only stored with red to move (yellow to
+// move is looked up on the flipped board). inside a slice every position has a dense index:
+// red men, yellow men, red kings then yellow kings, each ranked as a combination of the
+// squares the earlier groups left free
+//
+// file layout (little endian): a Header, sliceCount SliceEntry, the byte offset of each block
+// (plus one past the last) into the data that follows. a block is kBlockSize consecutive
+// indices run length encoded as one byte per run, the value in the top 2 bits and the run
+// length - 1 in the low 6, so a probe decodes at most one block
+//
+class CheckersEndgame
+{
+public:
+    // from the side to move's point of view, kUnknown when the position isn't in the database
+    enum Value : uint8_t { kUnknown = 0, kWin = 1, kLoss = 2, kDraw = 3 };
+
+    // piece counts of a slice, red is the side to move
+    struct Slice
+    {
+        uint8_t redMen;
+        uint8_t redKings;
+        uint8_t yellowMen;
+        uint8_t yellowKings;
+
+        int pieces() const { return redMen + redKings + yellowMen + yellowKings; }
+        Slice flipped() const { return Slice{ yellowMen, yellowKings, redMen, redKings }; }
+    };
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t maxPieces;
+        uint32_t sliceCount;
+        uint32_t blockSize;
+        uint32_t reserved;
+    };
+    struct SliceEntry
+    {
+        Slice slice;
+        uint32_t reserved;
+        // index of the slice's first block offset
+        uint64_t firstBlock;
+    };
+    static const uint32_t kVersion = 1;
+    static const uint32_t kBlockSize = 4096;
+    // the index arithmetic stays inside 64 bits up to here
+    static const int kMaxPieces = 10;
+
+    CheckersEndgame();
+    ~CheckersEndgame();
+    CheckersEndgame(const CheckersEndgame &) = delete;
+    CheckersEndgame &operator=(const CheckersEndgame &) = delete;
+
+    // map a database file, false if it's missing or malformed
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const { return _blockOffsets != nullptr; }
+    int maxPieces() const { return _maxPieces; }
+
+    Value probe(const CheckersBoard &board) const;
+
+    // indexing, shared with the generator. board must have red to move
+    static Slice sliceOf(const CheckersBoard &board);
+    static uint64_t sliceSize(const Slice &slice);
+    static uint64_t indexOf(const CheckersBoard &board);
+    // the position at index, false for the few indices that don't describe one
+    static bool positionAt(const Slice &slice, uint64_t index, CheckersBoard &board);
+
+    // compress one value per index for each slice (kUnknown where there's no position) and
+    // write a database file
+    static bool write(const std::string &path, int maxPieces, const std::vector<Slice> &slices, const std::vector<std::vector<uint8_t>> &values);
+
+    // the database the games share, opened from resources/checkers.db on first use
+    static const CheckersEndgame &sharedDatabase();
+
+private:
+    int sliceId(const Slice &slice) const;
+
+    MappedFile _file;
+    const SliceEntry *_slices;
+    const uint64_t *_blockOffsets;
+    const uint8_t *_data;
+    int _maxPieces;
+    // slice index by piece counts, -1 where there's none
+    std::vector<int> _sliceLookup;
+};
@@ -1,29 +1,37 @@
 #include "Chess.h"
-#include <limits>
-#include <cmath>
-#include "MagicBitboards.h"
+#include "BitPool.h"
+#include <algorithm>
+
+// how long the AI may think about a move
+static const int kAIThinkTimeMs = 1000;
+
+//
+// one analysis line as "+0.35  e2e4 e7e5 g1f3", scored from white's side with mates as "#3"
+//
+static std::string formatLine(const ChessAI::Line &line, int side)
+{
+    int score = side == ChessBoard::kWhite ? line.score : -line.score;
+    char text[32];
+    if (std::abs(score) >= ChessAI::kWinScore - ChessAI::kMaxPly) {
+        int moves = (ChessAI::kWinScore - std::abs(score) + 1) / 2;
+        snprintf(text, sizeof(text), "#%d", score > 0 ? moves : -moves);
+    } else {
+        snprintf(text, sizeof(text), "%+.2f", score / 100.0);
+    }
+    std::string result = text;
+    result += " ";
+    for (const ChessMove &move : line.pv) {
+        result += ' ';
+        result += move.toString();
+    }
+    return result;
+}
 
 Chess::Chess()
 {
     _grid = new Grid(8, 8);
-
-    initMagicBitboards();
-
-    for(int i = 0; i < 128; i++) { _bitboardLookup[i] = 0; }
-
-    _bitboardLookup['P'] = WHITE_PAWNS;
-    _bitboardLookup['N'] = WHITE_KNIGHTS;
-    _bitboardLookup['B'] = WHITE_BISHOPS;
-    _bitboardLookup['R'] = WHITE_ROOKS;
-    _bitboardLookup['Q'] = WHITE_QUEENS;
-    _bitboardLookup['K'] = WHITE_KING;
-    _bitboardLookup['p'] = BLACK_PAWNS;
-    _bitboardLookup['n'] = BLACK_KNIGHTS;
-    _bitboardLookup['b'] = BLACK_BISHOPS;
-    _bitboardLookup['r'] = BLACK_ROOKS;
-    _bitboardLookup['q'] = BLACK_QUEENS;
-    _bitboardLookup['k'] = BLACK_KING;
-    _bitboardLookup['0'] = EMPTY_SQUARES;
+    // the time limit is what stops the search
+    _gameOptions.AIMAXDepth = ChessAI::kMaxPly / 2;
 }
 
 Chess::~Chess()
@@ -31,28 +39,13 @@ Chess::~Chess()
     delete _grid;
 }
 
-char Chess::pieceNotation(int x, int y) const
-{
-    const char *wpieces = { "0PNBRQK" };
-    const char *bpieces = { "0pnbrqk" };
-    Bit *bit = _grid->getSquare(x, y)->bit();
-    char notation = '0';
-    if (bit) {
-        notation = bit->gameTag() < 128 ? wpieces[bit->gameTag()] : bpieces[bit->gameTag()-128];
-    }
-    return notation;
-}
-
 Bit* Chess::PieceForPlayer(const int playerNumber, ChessPiece piece)
 {
     const char* pieces[] = { "pawn.png", "knight.png", "bishop.png", "rook.png", "queen.png", "king.png" };
 
-    Bit* bit = new Bit();
-    // should possibly be cached from player class?
     const char* pieceName = pieces[piece - 1];
     std::string spritePath = std::string("") + (playerNumber == 0 ? "w_" : "b_") + pieceName;
-    bit->LoadTextureFromFile(spritePath.c_str());
-    bit->setOwner(getPlayerAt(playerNumber));
+    Bit* bit = BitPool::sharedPool().acquire(getPlayerAt(playerNumber), spritePath.c_str());
     bit->setSize(pieceSize, pieceSize);
 
     return bit;
@@ -65,71 +58,51 @@ void Chess::setUpBoard()
     _gameOptions.rowY = 8;
 
     _grid->initializeChessSquares(pieceSize, "boardsquare.png");
-    FENtoBoard("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR");
+    FENtoBoard(ChessBoard::kStartFEN);
 
-    // Populate Knight Bitboards for each square
-    for (int sq = 0; sq < 64; ++sq) {
-    _knightBitboards[sq] = generateKnightMoveBitboard(sq);
-    _kingBitboards[sq] = generateKingMoveBitboard(sq);
+    if (gameHasAI()) {
+        setAIPlayer(AI_PLAYER);
     }
 
-    _currentPlayer = WHITE;
-    _moves = generateAllMoves();
     startGame();
 }
 
 void Chess::FENtoBoard(const std::string& fen) {
-    // convert a FEN string to a board
-    // FEN is a space delimited string with 6 fields
-    // 1: piece placement (from white's perspective)
-    // NOT PART OF THIS ASSIGNMENT BUT OTHER THINGS THAT CAN BE IN A FEN STRING
-    // ARE BELOW
-    // 2: active color (W or B)
-    // 3: castling availability (KQkq or -)
-    // 4: en passant target square (in algebraic notation, or -)
-    // 5: halfmove clock (number of halfmoves since the last capture or pawn advance)
+    // convert a FEN string to a board, all six fields are read and any left off take their
+    // usual defaults (white to move, no castling, no en passant)
+    if (!_board.setFEN(fen)) {
+        return;
+    }
+    _board.generateMoves(_moves);
+    _positions.assign(1, _board.hash());
+    syncGrid();
+}
 
-    _grid->forEachSquare([](ChessSquare* square, int x, int y) {
-            square->setBit(nullptr);
-    });
+ChessSquare* Chess::squareFor(int index) const
+{
+    return _grid->getSquareByIndex(index);
+}
 
-    int y = 7;
-    int x = 0;
-    for (char character : fen) {
-        if (character == '/') {
-            y--;
-            x = 0;
-        } else if (isdigit(character)) {
-            x += character - '0';
-        } else {
-            ChessPiece piece = Pawn;
-            switch (toupper(character)) {
-            case 'K':
-                piece = King;
-                break;
-            case 'Q':
-                piece = Queen;
-                break;
-            case 'R':
-                piece = Rook;
-                break;
-            case 'N':
-                piece = Knight;
-                break;
-            case 'B':
-                piece = Bishop;
-                break;
-            case 'P':
-                piece = Pawn;
-                break;
-            }
-            Bit* bit = PieceForPlayer(isupper(character) ? 0 : 1, piece);
-            ChessSquare *square = _grid->getSquare(x, y);
-            bit->setPosition(square->getPosition());
-            bit->setParent(square);
-            bit->setGameTag(isupper(character) ? piece : (piece + 128));
-            square->setBit(bit);
-            x++;
+//
+// mirror the bitboards onto the grid, pieces that are already right are left alone, so castling
+// rooks, pawns taken en passant and promotions all come out of the one pass
+//
+void Chess::syncGrid()
+{
+    for (ChessSquare& square : _grid->squares()) {
+        int code = _board.pieceAt(square.getSquareIndex());
+        if (!code) {
+            square.destroyBit();
+            continue;
+        }
+        int side = ChessBoard::sideOf(code);
+        int gameTag = ChessBoard::typeOf(code) + (side == ChessBoard::kBlack ? 128 : 0);
+        Bit* current = square.bit();
+        if (!current || current->gameTag() != gameTag) {
+            Bit* bit = PieceForPlayer(side, (ChessPiece)ChessBoard::typeOf(code));
+            bit->setPosition(square.getPosition());
+            bit->setGameTag(gameTag);
+            square.setBit(bit);
         }
     }
 }
@@ -141,9 +114,7 @@ bool Chess::actionForEmptyHolder(BitHolder &holder)
 
 bool Chess::canBitMoveFrom(Bit &bit, BitHolder &src)
 {
-    int currentPlayer = getCurrentPlayer()->playerNumber() * 128;
-    int pieceColor = bit.gameTag() & 128;
-    if (pieceColor != currentPlayer) return false;
+    if (bit.getOwner() != getCurrentPlayer()) return false;
 
     _grid->forEachSquare([](ChessSquare* sq, int x, int y) {
         sq->setHighlighted(false);
@@ -153,10 +124,10 @@ bool Chess::canBitMoveFrom(Bit &bit, BitHolder &src)
     ChessSquare* square = (ChessSquare *)&src;
     if (square) {
         int squareIndex = square->getSquareIndex();
-        for (auto move : _moves) {
+        for (const ChessMove& move : _moves) {
             if (move.from == squareIndex) {
                 returnVal = true;
-                auto dest = _grid->getSquareByIndex(move.to);
+                auto dest = squareFor(move.to);
                 dest->setHighlighted(true);
             }
         }
@@ -171,7 +142,7 @@ bool Chess::canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst)
     ChessSquare* square = (ChessSquare *)&dst;
     if (square) {
         int squareIndex = square->getSquareIndex();
-        for (auto move : _moves) {
+        for (const ChessMove& move : _moves) {
             if (move.to == squareIndex && move.from == srdsquare->getSquareIndex()) {
                 return true;
             }
@@ -186,9 +157,25 @@ void Chess::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst)
     _grid->forEachSquare([](ChessSquare* sq, int x, int y) {
         sq->setHighlighted(false);
     });
-    
-    _currentPlayer = _currentPlayer == BLACK ? WHITE : BLACK;
-    _moves = generateAllMoves();
+
+    int from = ((ChessSquare *)&src)->getSquareIndex();
+    int to = ((ChessSquare *)&dst)->getSquareIndex();
+    // promotions come queen first, so a dragged pawn always queens
+    for (const ChessMove& move : _moves) {
+        if (move.from == from && move.to == to) {
+            finishMove(move);
+            return;
+        }
+    }
+}
+
+void Chess::finishMove(const ChessMove &move)
+{
+    ChessBoard::Undo undo;
+    _board.make(move, undo);
+    _board.generateMoves(_moves);
+    _positions.push_back(_board.hash());
+    syncGrid();
     endTurn();
 }
 
@@ -197,6 +184,10 @@ void Chess::stopGame()
     _grid->forEachSquare([](ChessSquare* square, int x, int y) {
         square->destroyBit();
     });
+    _moves.count = 0;
+    _positions.clear();
+    std::lock_guard<std::mutex> lock(_analysisMutex);
+    _analysis.clear();
 }
 
 Player* Chess::ownerAt(int x, int y) const
@@ -214,12 +205,22 @@ Player* Chess::ownerAt(int x, int y) const
 
 Player* Chess::checkForWinner()
 {
+    // checkmate, the side that just moved wins
+    if (_moves.count == 0 && _board.inCheck()) {
+        return getPlayerAt(_board.sideToMove() == ChessBoard::kWhite ? 1 : 0);
+    }
     return nullptr;
 }
 
 bool Chess::checkForDraw()
 {
-    return false;
+    if (_moves.count == 0) {
+        return !_board.inCheck();
+    }
+    if (_board.halfmoveClock() >= 100 || _board.insufficientMaterial()) {
+        return true;
+    }
+    return std::count(_positions.begin(), _positions.end(), _board.hash()) >= 3;
 }
 
 std::string Chess::initialStateString()
@@ -229,257 +230,103 @@ std::string Chess::initialStateString()
 
 std::string Chess::stateString()
 {
-    std::string s;
-    s.reserve(64);
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-            s += pieceNotation( x, y );
-        }
-    );
-    return s;}
+    return _board.stateString();
+}
 
 void Chess::setStateString(const std::string &s)
 {
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        int index = y * 8 + x;
-        char playerNumber = s[index] - '0';
-        if (playerNumber) {
-            square->setBit(PieceForPlayer(playerNumber - 1, Pawn));
-        } else {
-            square->setBit(nullptr);
-        }
-    });
-}
-
-void Chess::addPawnBitboardMovesToList(std::vector<BitMove>& moves, const BitboardElement bitBoard, const int shift) {
-    if (bitBoard.getData() == 0) {
+    if (!_board.setState(s)) {
         return;
     }
-    bitBoard.forEachBit([&](int toSquare){
-        int fromSquare = toSquare - shift;
-        moves.emplace_back(fromSquare, toSquare, Pawn);
-    });
+    _board.generateMoves(_moves);
+    _positions.assign(1, _board.hash());
+    syncGrid();
 }
 
-void Chess::generatePawnMoveList(std::vector<BitMove>& moves, const BitboardElement Pawns, const BitboardElement emptySquares, const BitboardElement enemyPieces, char color) {
-    if (Pawns.getData() == 0) {
-        return;
-    }
-
-    // Single Moves
-    BitboardElement singleMoves = (color == WHITE) ? (Pawns.getData() << 8) & emptySquares.getData() : (Pawns.getData() >> 8) & emptySquares.getData();
-    //Double Moves
-    BitboardElement doubleMoves = (color == WHITE) ? ((singleMoves.getData() & RANK_3) << 8) & emptySquares.getData() : ((singleMoves.getData() & RANK_6) >> 8) & emptySquares.getData();
-    // Captures
-    BitboardElement leftCaptures = (color == WHITE) ? ((Pawns.getData() & NOT_FILE_A) << 7) & enemyPieces.getData() : ((Pawns.getData() & NOT_FILE_A) >> 7) & enemyPieces.getData();
-    BitboardElement rightCaptures =  (color == WHITE) ? ((Pawns.getData() & NOT_FILE_H) << 9) & enemyPieces.getData() : ((Pawns.getData() & NOT_FILE_H) >> 9) & enemyPieces.getData();
-
-    int shiftForward = (color == WHITE) ? 8 : -8;
-    int doubleShift = (color == WHITE) ? 16 : -16;
-    int leftCaptureShift = (color == WHITE) ? 7 : -7;
-    int rightCaptureShift = (color == WHITE) ? 9 : -9;
-
-    addPawnBitboardMovesToList(moves, singleMoves, shiftForward);
-    addPawnBitboardMovesToList(moves, doubleMoves, doubleShift);
-    addPawnBitboardMovesToList(moves, leftCaptures, leftCaptureShift);
-    addPawnBitboardMovesToList(moves, rightCaptures, rightCaptureShift);
+void Chess::updateAI()
+{
+    applyAIMove(searchAIMove(stateString(), getCurrentPlayer()->playerNumber(), aiOptions()));
 }
 
-BitboardElement Chess::generateKnightMoveBitboard(int square) {
-    BitboardElement bitboard = 0ULL;
-    int rank = square / 8;
-    int file = square % 8;
-
-    std::pair<int, int> knightOffsets[] = {
-        { 2, 1 }, { 2, -1 }, { -2, 1 }, { -2, -1 },
-        { 1, 2 }, { 1, -2 }, { -1, 2 }, { -1, -2 }
-    };
-
-    constexpr uint64_t oneBit = 1;
-    for (auto [dr, df] : knightOffsets) {
-        int r = rank + dr, f = file + df;
-        if (r >= 0 && r < 8 && f >= 0 && f < 8) {
-            bitboard |= oneBit << (r * 8 + f);
-        }
+//
+// runs on a worker thread from a state snapshot, returns the move in long algebraic ("e2e4")
+//
+std::string Chess::searchAIMove(const std::string &state, int playerNumber, const AIOptions &options)
+{
+    ChessBoard board;
+    if (!board.setState(state)) {
+        return "";
     }
-
-    return bitboard;
-}
-
-void Chess::generateKnightMoves(std::vector<BitMove>& moves, BitboardElement knightBoard, uint64_t emptySquares) {
-    knightBoard.forEachBit([&](int fromSquare) {
-        BitboardElement moveBitboard = BitboardElement(_knightBitboards[fromSquare].getData() & emptySquares);
-        moveBitboard.forEachBit([&](int toSquare) {
-            moves.emplace_back(fromSquare, toSquare, Knight);
-        });
-    });
-}
-
-BitboardElement Chess::generateKingMoveBitboard(int square) {
-    BitboardElement bitboard = 0ULL;
-    int rank = square / 8;
-    int file = square % 8;
-
-    std::pair<int, int> kingOffsets[] = {
-        { -1, 1 }, { 0, 1 }, { 1, 1 },
-        {-1, 0 },            { 1, 0 },
-        {-1, -1}, { 0, -1 }, { 1, -1 } 
-    };
-
-    constexpr uint64_t oneBit = 1;
-    for (auto [dr, df] : kingOffsets) {
-        int r = rank + dr, f = file + df;
-        if (r >= 0 && r < 8 && f >= 0 && f < 8) {
-            bitboard |= oneBit << (r * 8 + f);
-        }
+    ChessSearchParams params;
+    for (const auto &[name, value] : options.settings) {
+        params.set(name, value);
     }
-
-    return bitboard;
-}
-
-void Chess::generateKingMoves(std::vector<BitMove>& moves, BitboardElement kingBoard, uint64_t emptySquares) {
-    kingBoard.forEachBit([&](int fromSquare){
-        BitboardElement moveBitBoard = BitboardElement(_kingBitboards[fromSquare].getData() & emptySquares);
-        moveBitBoard.forEachBit([&](int toSquare){
-            moves.emplace_back(fromSquare, toSquare, King);
-        });
-    });
-}
-
-void Chess::generateBishopMoves(std::vector<BitMove>& moves, BitboardElement piecesBoard, uint64_t occupancy, uint64_t friendlies) {
-    piecesBoard.forEachBit([&](int fromSquare){
-        BitboardElement moveBitBoard = BitboardElement(getBishopAttacks(fromSquare, occupancy) & ~friendlies);
-        moveBitBoard.forEachBit([&](int toSquare){
-            moves.emplace_back(fromSquare, toSquare, King);
-        });
-    });
+    _ai.setParams(params);
+    ChessAI::Limits limits;
+    limits.maxDepth = options.maxDepth;
+    limits.timeLimitMs = kAIThinkTimeMs;
+    limits.multiPV = options.multiPV;
+    limits.history = options.history;
+    ChessAI::Result result = _ai.search(board, limits);
+
+    std::vector<std::string> analysis;
+    for (const ChessAI::Line &line : result.lines) {
+        analysis.push_back(formatLine(line, board.sideToMove()));
+    }
+    if (!analysis.empty()) {
+        analysis.insert(analysis.begin(), "depth " + std::to_string(result.depth) + ", " + std::to_string(result.nodes) + " nodes");
+    }
+    {
+        std::lock_guard<std::mutex> lock(_analysisMutex);
+        _analysis = std::move(analysis);
+    }
+    return result.hasMove ? result.bestMove.toString() : "";
 }
 
-void Chess::generateRookMoves(std::vector<BitMove>& moves, BitboardElement piecesBoard, uint64_t occupancy, uint64_t friendlies) {
-    piecesBoard.forEachBit([&](int fromSquare){
-        BitboardElement moveBitBoard = BitboardElement(getRookAttacks(fromSquare, occupancy) & ~friendlies);
-        moveBitBoard.forEachBit([&](int toSquare){
-            moves.emplace_back(fromSquare, toSquare, King);
-        });
-    });
+std::vector<std::string> Chess::analysisLines()
+{
+    std::lock_guard<std::mutex> lock(_analysisMutex);
+    return _analysis;
 }
 
-void Chess::generateQueenMoves(std::vector<BitMove>& moves, BitboardElement piecesBoard, uint64_t occupancy, uint64_t friendlies) {
-    piecesBoard.forEachBit([&](int fromSquare){
-        BitboardElement moveBitBoard = BitboardElement(getQueenAttacks(fromSquare, occupancy) & ~friendlies);
-        moveBitBoard.forEachBit([&](int toSquare){
-            moves.emplace_back(fromSquare, toSquare, King);
-        });
-    });
+bool Chess::applyAIMove(const std::string &move)
+{
+    ChessMove legal;
+    if (!_board.parseMove(move, legal)) {
+        return false;
+    }
+    ChessSquare* src = squareFor(legal.from);
+    ChessSquare* dst = squareFor(legal.to);
+    Bit* bit = src->bit();
+    if (!bit) return false;
+    dst->setBit(bit);
+    bit->moveTo(dst->getPosition());
+    finishMove(legal);
+    return true;
 }
 
-std::vector<BitMove> Chess::generateAllMoves()
+AIOptions Chess::aiOptions()
 {
-    std::vector<BitMove> moves;
-    moves.reserve(32);
-
-    std::string state = stateString();
-
-    for (int i = 0; i < e_numBitboards; i++) {
-        _bitboards[i] = 0;
+    AIOptions options = Game::aiOptions();
+    // nothing from before the last capture or pawn move can come round again
+    size_t before = _positions.empty() ? 0 : _positions.size() - 1;
+    size_t reversible = std::min(before, (size_t)_board.halfmoveClock());
+    options.history.assign(_positions.begin() + (before - reversible), _positions.begin() + before);
+    for (const ChessSearchParams::Option& option : ChessSearchParams::options()) {
+        options.settings.emplace_back(option.name, _searchParams.*option.value);
     }
+    return options;
+}
 
-    for (int i = 0; i < 64; i++) {
-        int bitIndex = _bitboardLookup[state[i]];
-        _bitboards[bitIndex] |= 1ULL << i;
+void Chess::drawAISettings()
+{
+    if (ImGui::TreeNode("Search options")) {
+        for (const ChessSearchParams::Option& option : ChessSearchParams::options()) {
+            ImGui::SliderInt(option.name, &(_searchParams.*option.value), option.min, option.max);
+        }
+        if (ImGui::Button("Defaults")) {
+            _searchParams = ChessSearchParams();
+        }
+        ImGui::TreePop();
     }
-
-    _bitboards[WHITE_ALL_PIECES] = _bitboards[WHITE_PAWNS].getData() |
-    _bitboards[WHITE_KNIGHTS].getData() |
-    _bitboards[WHITE_BISHOPS].getData() |
-    _bitboards[WHITE_ROOKS].getData() |
-    _bitboards[WHITE_QUEENS].getData() |
-    _bitboards[WHITE_KING].getData();
-
-    _bitboards[BLACK_ALL_PIECES] = _bitboards[BLACK_PAWNS].getData() |
-    _bitboards[BLACK_KNIGHTS].getData() |
-    _bitboards[BLACK_BISHOPS].getData() |
-    _bitboards[BLACK_ROOKS].getData() |
-    _bitboards[BLACK_QUEENS].getData() |
-    _bitboards[BLACK_KING].getData();
-
-    _bitboards[OCCUPANCY] = _bitboards[WHITE_ALL_PIECES].getData() | _bitboards[BLACK_ALL_PIECES].getData();
-    int bitIndex = _currentPlayer == WHITE ? WHITE_PAWNS : BLACK_PAWNS;
-    int oppBitIndex = _currentPlayer == WHITE ? BLACK_PAWNS : WHITE_PAWNS;
-
-    generateKnightMoves(moves, _bitboards[WHITE_KNIGHTS + bitIndex], ~_bitboards[OCCUPANCY].getData());
-    generatePawnMoveList(moves, _bitboards[WHITE_PAWNS + bitIndex], ~_bitboards[OCCUPANCY].getData(), _bitboards[WHITE_ALL_PIECES + oppBitIndex].getData(), _currentPlayer);
-    generateKingMoves(moves, _bitboards[WHITE_KING + bitIndex], ~_bitboards[OCCUPANCY].getData());
-    generateBishopMoves(moves, _bitboards[WHITE_BISHOPS + bitIndex], _bitboards[OCCUPANCY].getData(), _bitboards[WHITE_ALL_PIECES + bitIndex].getData());
-    generateRookMoves(moves, _bitboards[WHITE_ROOKS + bitIndex], _bitboards[OCCUPANCY].getData(), _bitboards[WHITE_ALL_PIECES + bitIndex].getData());
-    generateQueenMoves(moves, _bitboards[WHITE_QUEENS + bitIndex], _bitboards[OCCUPANCY].getData(), _bitboards[WHITE_ALL_PIECES + bitIndex].getData());
-
-    return moves;
 }
-
-// void Chess::updateAI() 
-// {
-//     int bestVal = negInfinite;
-//     BitMove* bestMove = nullptr;
-//     std::string state = stateString();
-
-//     for(auto move : newMoves) {
-//         int srcSquare = move.from;
-//         int dstSquare = move.to;
-
-//         char oldDst = state[dstSquare];
-//         char srcPce = state[srcSquare];
-//         state[dstSquare] = state[srcSquare];
-//         state[srcSquare] = '0';
-//         // Undo Move
-//         int moveVal = negamax(state, 5, negInfinite);
-//         state[dstSquare] = oldDst;
-//         state[srcSquare] = srcPce;
-//         // If the value of the current move is more than the best value, update best
-//         if (moveVal > bestVal) {
-//             bestMove = move;
-//             bestVal = moveVal;
-//         }
-//     }
-//     // Make the best move
-// }
-
-// int Chess::negamax(std::string& state, int depth, int playerColor) 
-// {
-//     _countMoves++;
-
-//     if (depth == 0) {
-//         return evaluateBoard(state) * playerColor;
-//     }
-
-//     auto newMoves = generateAllMoves(state, playerColor);
-
-//     int bestVal = negamax(); // Min value
-
-//     return bestVal;
-// }
-
-// #define FLIP(x) (x^56)
-
-// int evaluateBoard(std::string state) {
-//     int values[128];
-//     values['P'] = 100;
-//     values['N'] = 300;
-//     values['B'] = 400;
-//     values['R'] = 500;
-//     values['Q'] = 900;
-//     values['K'] = 2000;
-//     values['p'] = -100;
-//     values['n'] = -300;
-//     values['b'] = -400;
-//     values['r'] = -500;
-//     values['q'] = -900;
-//     values['k'] = -2000;
-
-//     values['0'] = 0;
-//     int score = 0;
-//     for(char ch: state) {
-//         score += values[ch];
-//     }
-
-//     return score;
-// }
\ No newline at end of file
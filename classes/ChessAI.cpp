@@ -0,0 +1,883 @@
+#include "ChessAI.h"
+#include "MagicBitboards.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <type_traits>
+
+namespace {
+    const int kInfinite = 2 * ChessAI::kWinScore;
+    // scores beyond this are mates, counted in plies
+    const int kMateBound = ChessAI::kWinScore - ChessAI::kMaxPly;
+
+    // mates are stored relative to the position rather than the root, so they stay right when
+    // the position is reached at a different ply
+    int toTable(int score, int ply)
+    {
+        if (score >= kMateBound) return score + ply;
+        if (score <= -kMateBound) return score - ply;
+        return score;
+    }
+
+    int fromTable(int score, int ply)
+    {
+        if (score >= kMateBound) return score - ply;
+        if (score <= -kMateBound) return score + ply;
+        return score;
+    }
+
+    //
+    // evaluation, middlegame and endgame halves blended by how much material is left
+    //
+    const int kMaterial[2][King + 1] = { { 0, 82, 337, 365, 477, 1025, 0 }, { 0, 94, 281, 297, 512, 936, 0 } };
+    // game phase each piece is worth, 24 with everything on the board
+    const int kPhase[King + 1] = { 0, 0, 1, 1, 2, 4, 0 };
+
+    // piece squares from white's side, rank 8 first as the board is drawn
+    const int kPieceSquares[King + 1][64] = {
+        {},
+        {
+             0,  0,  0,  0,  0,  0,  0,  0,
+            50, 50, 50, 50, 50, 50, 50, 50,
+            10, 10, 20, 30, 30, 20, 10, 10,
+             5,  5, 10, 25, 25, 10,  5,  5,
+             0,  0,  0, 20, 20,  0,  0,  0,
+             5, -5,-10,  0,  0,-10, -5,  5,
+             5, 10, 10,-20,-20, 10, 10,  5,
+             0,  0,  0,  0,  0,  0,  0,  0,
+        },
+        {
+            -50,-40,-30,-30,-30,-30,-40,-50,
+            -40,-20,  0,  0,  0,  0,-20,-40,
+            -30,  0, 10, 15, 15, 10,  0,-30,
+            -30,  5, 15, 20, 20, 15,  5,-30,
+            -30,  0, 15, 20, 20, 15,  0,-30,
+            -30,  5, 10, 15, 15, 10,  5,-30,
+            -40,-20,  0,  5,  5,  0,-20,-40,
+            -50,-40,-30,-30,-30,-30,-40,-50,
+        },
+        {
+            -20,-10,-10,-10,-10,-10,-10,-20,
+            -10,  0,  0,  0,  0,  0,  0,-10,
+            -10,  0,  5, 10, 10,  5,  0,-10,
+            -10,  5,  5, 10, 10,  5,  5,-10,
+            -10,  0, 10, 10, 10, 10,  0,-10,
+            -10, 10, 10, 10, 10, 10, 10,-10,
+            -10,  5,  0,  0,  0,  0,  5,-10,
+            -20,-10,-10,-10,-10,-10,-10,-20,
+        },
+        {
+             0,  0,  0,  0,  0,  0,  0,  0,
+             5, 10, 10, 10, 10, 10, 10,  5,
+            -5,  0,  0,  0,  0,  0,  0, -5,
+            -5,  0,  0,  0,  0,  0,  0, -5,
+            -5,  0,  0,  0,  0,  0,  0, -5,
+            -5,  0,  0,  0,  0,  0,  0, -5,
+            -5,  0,  0,  0,  0,  0,  0, -5,
+             0,  0,  0,  5,  5,  0,  0,  0,
+        },
+        {
+            -20,-10,-10, -5, -5,-10,-10,-20,
+            -10,  0,  0,  0,  0,  0,  0,-10,
+            -10,  0,  5,  5,  5,  5,  0,-10,
+             -5,  0,  5,  5,  5,  5,  0, -5,
+              0,  0,  5,  5,  5,  5,  0, -5,
+            -10,  5,  5,  5,  5,  5,  0,-10,
+            -10,  0,  5,  0,  0,  0,  0,-10,
+            -20,-10,-10, -5, -5,-10,-10,-20,
+        },
+        {
+            -30,-40,-40,-50,-50,-40,-40,-30,
+            -30,-40,-40,-50,-50,-40,-40,-30,
+            -30,-40,-40,-50,-50,-40,-40,-30,
+            -30,-40,-40,-50,-50,-40,-40,-30,
+            -20,-30,-30,-40,-40,-30,-30,-20,
+            -10,-20,-20,-20,-20,-20,-20,-10,
+             20, 20,  0,  0,  0,  0, 20, 20,
+             20, 30, 10,  0,  0, 10, 30, 20,
+        },
+    };
+    // the king walks to the centre once the queens are gone
+    const int kKingEndgame[64] = {
+        -50,-40,-30,-20,-20,-30,-40,-50,
+        -30,-20,-10,  0,  0,-10,-20,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-30,  0,  0,  0,  0,-30,-30,
+        -50,-30,-30,-30,-30,-30,-30,-50,
+    };
+
+    // by how far up the board the passed pawn has got
+    const int kPassedPawn[2][8] = { { 0, 5, 10, 15, 25, 40, 60, 0 }, { 0, 10, 15, 25, 45, 70, 110, 0 } };
+    const int kDoubledPawn[2] = { -10, -20 };
+    const int kIsolatedPawn[2] = { -10, -10 };
+    const int kBishopPair[2] = { 30, 50 };
+    const int kRookOpenFile[2] = { 25, 10 };
+    const int kRookHalfOpenFile[2] = { 12, 5 };
+    // per square a piece reaches, counted from an average number of squares
+    const int kMobility[2][King + 1] = { { 0, 0, 4, 5, 2, 1, 0 }, { 0, 0, 4, 5, 4, 2, 0 } };
+    const int kAverageMobility[King + 1] = { 0, 0, 4, 7, 7, 14, 0 };
+    const int kTempo = 10;
+
+    // the files either side of each file, and everything ahead of a pawn a passer can't have
+    struct PawnMasks
+    {
+        uint64_t adjacentFiles[8];
+        uint64_t passed[2][64];
+    };
+
+    constexpr PawnMasks makePawnMasks()
+    {
+        PawnMasks masks{};
+        for (int file = 0; file < 8; file++) {
+            masks.adjacentFiles[file] = (file > 0 ? FILE_A << (file - 1) : 0) | (file < 7 ? FILE_A << (file + 1) : 0);
+        }
+        for (int square = 0; square < 64; square++) {
+            int file = square % 8, rank = square / 8;
+            uint64_t files = masks.adjacentFiles[file] | (FILE_A << file);
+            uint64_t above = rank < 7 ? ~0ULL << (8 * (rank + 1)) : 0;
+            uint64_t below = rank > 0 ? ~0ULL >> (8 * (8 - rank)) : 0;
+            masks.passed[ChessBoard::kWhite][square] = files & above;
+            masks.passed[ChessBoard::kBlack][square] = files & below;
+        }
+        return masks;
+    }
+    constexpr PawnMasks kPawnMasks = makePawnMasks();
+
+    // the search's evaluation keeps no record of the weights it used
+    struct NoTrace
+    {
+        void add(const int *, int, int) {}
+    };
+
+    struct WeightTrace
+    {
+        const int *weights;
+        ChessEvalTrace &trace;
+
+        void add(const int *weight, int middlegame, int endgame) { trace.terms.push_back(ChessEvalTrace::Term{ (uint16_t)(weight - weights), (int16_t)middlegame, (int16_t)endgame }); }
+    };
+
+    //
+    // the evaluation itself, for the side to move. every weight goes in through add, which a
+    // tracing evaluation also hands to the trace
+    //
+    template <typename Trace>
+    int evaluateTerms(const ChessBoard &board, const ChessEvalParams &params, Trace &trace)
+    {
+        int score[2][2] = { { 0, 0 }, { 0, 0 } };
+        int phase = 0;
+        uint64_t occupancy = board.occupied();
+
+        // count uses of a middlegame and an endgame weight, which for piece squares are one
+        auto add = [&](int side, const int &middlegame, const int &endgame, int count) {
+            score[side][0] += middlegame * count;
+            score[side][1] += endgame * count;
+            int signedCount = side == ChessBoard::kWhite ? count : -count;
+            if (&middlegame == &endgame) {
+                trace.add(&middlegame, signedCount, signedCount);
+            } else {
+                trace.add(&middlegame, signedCount, 0);
+                trace.add(&endgame, 0, signedCount);
+            }
+        };
+
+        for (int side = 0; side < 2; side++) {
+            int them = side ^ 1;
+            uint64_t ownPawns = board.pieces(side, Pawn);
+            uint64_t enemyPawns = board.pieces(them, Pawn);
+            // squares enemy pawns guard don't count towards mobility
+            uint64_t guarded = 0;
+            for (uint64_t pawns = enemyPawns; pawns; pawns &= pawns - 1) {
+                guarded |= ChessBoard::pawnAttacks(them, std::countr_zero(pawns));
+            }
+            uint64_t available = ~board.occupied(side) & ~guarded;
+
+            for (int piece = Pawn; piece <= King; piece++) {
+                for (uint64_t bits = board.pieces(side, piece); bits; bits &= bits - 1) {
+                    int square = std::countr_zero(bits);
+                    // the tables are drawn from white's side with rank 8 first
+                    int index = side == ChessBoard::kWhite ? square ^ 56 : square;
+                    phase += kPhase[piece];
+                    add(side, params.material[0][piece], params.material[1][piece], 1);
+                    add(side, params.pieceSquares[piece][index], piece == King ? params.kingEndgame[index] : params.pieceSquares[piece][index], 1);
+
+                    uint64_t reach = 0;
+                    int file = ChessBoard::fileOf(square);
+                    switch (piece) {
+                        case Pawn: {
+                            if (!(kPawnMasks.passed[side][square] & enemyPawns)) {
+                                int rank = side == ChessBoard::kWhite ? ChessBoard::rankOf(square) : 7 - ChessBoard::rankOf(square);
+                                add(side, params.passedPawn[0][rank], params.passedPawn[1][rank], 1);
+                            }
+                            if (!(kPawnMasks.adjacentFiles[file] & ownPawns)) {
+                                add(side, params.isolatedPawn[0], params.isolatedPawn[1], 1);
+                            }
+                            break;
+                        }
+                        case Knight: reach = KnightAttacks[square]; break;
+                        case Bishop: reach = getBishopAttacks(square, occupancy); break;
+                        case Rook: {
+                            reach = getRookAttacks(square, occupancy);
+                            uint64_t fileMask = FILE_A << file;
+                            if (!(fileMask & ownPawns)) {
+                                if (!(fileMask & enemyPawns)) {
+                                    add(side, params.rookOpenFile[0], params.rookOpenFile[1], 1);
+                                } else {
+                                    add(side, params.rookHalfOpenFile[0], params.rookHalfOpenFile[1], 1);
+                                }
+                            }
+                            break;
+                        }
+                        case Queen: reach = getQueenAttacks(square, occupancy); break;
+                        default: break;
+                    }
+                    if (piece != Pawn && piece != King) {
+                        int squares = std::popcount(reach & available) - kAverageMobility[piece];
+                        add(side, params.mobility[0][piece], params.mobility[1][piece], squares);
+                    }
+                }
+            }
+
+            for (int file = 0; file < 8; file++) {
+                int pawns = std::popcount(ownPawns & (FILE_A << file));
+                if (pawns > 1) {
+                    add(side, params.doubledPawn[0], params.doubledPawn[1], pawns - 1);
+                }
+            }
+            if (std::popcount(board.pieces(side, Bishop)) >= 2) {
+                add(side, params.bishopPair[0], params.bishopPair[1], 1);
+            }
+        }
+
+        int us = board.sideToMove(), them = us ^ 1;
+        trace.add(&params.tempo, us == ChessBoard::kWhite ? 1 : -1, 0);
+        int middlegame = score[us][0] - score[them][0] + params.tempo;
+        int endgame = score[us][1] - score[them][1];
+        phase = std::min(phase, ChessAI::kTotalPhase);
+        if constexpr (!std::is_same_v<Trace, NoTrace>) {
+            trace.trace.phase = phase;
+        }
+        return (middlegame * phase + endgame * (ChessAI::kTotalPhase - phase)) / ChessAI::kTotalPhase;
+    }
+
+    //
+    // move ordering bands: the table move, captures and promotions by most valuable victim
+    // then least valuable attacker, killers, then quiet moves by history
+    //
+    const int kTableMoveScore = 1 << 30;
+    const int kCaptureScore = 1 << 24;
+    const int kKillerScore = 1 << 22;
+    const int kMaxHistory = 16384;
+
+    const ChessSearchParams::Option kOptions[] = {
+        { "lmrBase", &ChessSearchParams::lmrBase, 0, 200 },
+        { "lmrDivisor", &ChessSearchParams::lmrDivisor, 100, 500 },
+        { "lmrDepth", &ChessSearchParams::lmrDepth, 0, 8 },
+        { "lmrMoves", &ChessSearchParams::lmrMoves, 1, 10 },
+        { "reverseFutilityDepth", &ChessSearchParams::reverseFutilityDepth, 0, 12 },
+        { "reverseFutilityMargin", &ChessSearchParams::reverseFutilityMargin, 20, 300 },
+        { "futilityDepth", &ChessSearchParams::futilityDepth, 0, 10 },
+        { "futilityBase", &ChessSearchParams::futilityBase, 0, 300 },
+        { "futilityMargin", &ChessSearchParams::futilityMargin, 20, 300 },
+        { "razorDepth", &ChessSearchParams::razorDepth, 0, 6 },
+        { "razorBase", &ChessSearchParams::razorBase, 0, 600 },
+        { "razorMargin", &ChessSearchParams::razorMargin, 50, 500 },
+        { "lateMoveDepth", &ChessSearchParams::lateMoveDepth, 0, 12 },
+        { "lateMoveBase", &ChessSearchParams::lateMoveBase, 0, 10 },
+        { "nullMoveDepth", &ChessSearchParams::nullMoveDepth, 0, 8 },
+        { "nullMoveReduction", &ChessSearchParams::nullMoveReduction, 1, 6 },
+        { "checkExtension", &ChessSearchParams::checkExtension, 0, 1 },
+        { "singularDepth", &ChessSearchParams::singularDepth, 0, 12 },
+        { "singularMargin", &ChessSearchParams::singularMargin, 0, 8 },
+    };
+}
+
+std::span<const ChessSearchParams::Option> ChessSearchParams::options()
+{
+    return kOptions;
+}
+
+bool ChessSearchParams::set(const std::string &name, int value)
+{
+    for (const Option &option : kOptions) {
+        if (name == option.name) {
+            this->*option.value = std::clamp(value, option.min, option.max);
+            return true;
+        }
+    }
+    return false;
+}
+
+ChessAI::ChessAI(size_t tableEntries)
+{
+    size_t size = 1;
+    while (size * 2 <= tableEntries) {
+        size *= 2;
+    }
+    _table.resize(size);
+    setParams(ChessSearchParams());
+    clear();
+    _rootDepth = 0;
+    _aborted = false;
+    _nodes = 0;
+    _lastScore = 0;
+    _lastDepth = 0;
+}
+
+void ChessAI::setParams(const ChessSearchParams &params)
+{
+    _params = params;
+    double base = params.lmrBase / 100.0;
+    double divisor = std::max(params.lmrDivisor, 1) / 100.0;
+    for (int depth = 0; depth < 64; depth++) {
+        for (int move = 0; move < 64; move++) {
+            _reductions[depth][move] = (depth && move) ? (int)(base + std::log(depth) * std::log(move) / divisor) : 0;
+        }
+    }
+}
+
+void ChessAI::clear()
+{
+    std::fill(_table.begin(), _table.end(), TableEntry{ 0, 0, 0, kNone, ChessMove() });
+    for (auto &side : _history) {
+        for (auto &from : side) {
+            std::fill(std::begin(from), std::end(from), 0);
+        }
+    }
+    for (auto &killers : _killers) {
+        killers[0] = killers[1] = ChessMove();
+    }
+}
+
+ChessEvalParams::ChessEvalParams()
+{
+    std::copy(&kMaterial[0][0], &kMaterial[0][0] + std::size(kMaterial) * std::size(kMaterial[0]), &material[0][0]);
+    std::copy(&kPieceSquares[0][0], &kPieceSquares[0][0] + std::size(kPieceSquares) * std::size(kPieceSquares[0]), &pieceSquares[0][0]);
+    std::copy(std::begin(kKingEndgame), std::end(kKingEndgame), kingEndgame);
+    std::copy(&kPassedPawn[0][0], &kPassedPawn[0][0] + std::size(kPassedPawn) * std::size(kPassedPawn[0]), &passedPawn[0][0]);
+    std::copy(std::begin(kDoubledPawn), std::end(kDoubledPawn), doubledPawn);
+    std::copy(std::begin(kIsolatedPawn), std::end(kIsolatedPawn), isolatedPawn);
+    std::copy(std::begin(kBishopPair), std::end(kBishopPair), bishopPair);
+    std::copy(std::begin(kRookOpenFile), std::end(kRookOpenFile), rookOpenFile);
+    std::copy(std::begin(kRookHalfOpenFile), std::end(kRookHalfOpenFile), rookHalfOpenFile);
+    std::copy(&kMobility[0][0], &kMobility[0][0] + std::size(kMobility) * std::size(kMobility[0]), &mobility[0][0]);
+    tempo = kTempo;
+}
+
+std::span<const ChessEvalParams::Table> ChessEvalParams::tables()
+{
+    static const Table kTables[] = {
+        { "material", offsetof(ChessEvalParams, material), 2 * (King + 1), King + 1 },
+        { "pieceSquares", offsetof(ChessEvalParams, pieceSquares), (King + 1) * 64, 8 },
+        { "kingEndgame", offsetof(ChessEvalParams, kingEndgame), 64, 8 },
+        { "passedPawn", offsetof(ChessEvalParams, passedPawn), 2 * 8, 8 },
+        { "doubledPawn", offsetof(ChessEvalParams, doubledPawn), 2, 2 },
+        { "isolatedPawn", offsetof(ChessEvalParams, isolatedPawn), 2, 2 },
+        { "bishopPair", offsetof(ChessEvalParams, bishopPair), 2, 2 },
+        { "rookOpenFile", offsetof(ChessEvalParams, rookOpenFile), 2, 2 },
+        { "rookHalfOpenFile", offsetof(ChessEvalParams, rookHalfOpenFile), 2, 2 },
+        { "mobility", offsetof(ChessEvalParams, mobility), 2 * (King + 1), King + 1 },
+        { "tempo", offsetof(ChessEvalParams, tempo), 1, 1 },
+    };
+    return kTables;
+}
+
+int ChessAI::evaluate(const ChessBoard &board)
+{
+    static const ChessEvalParams defaults;
+    return evaluate(board, defaults);
+}
+
+//
+// tapered evaluation, summed for white and black and returned for the side to move. a trace
+// comes back with each weight once, sorted
+//
+int ChessAI::evaluate(const ChessBoard &board, const ChessEvalParams &params, ChessEvalTrace *trace)
+{
+    if (!trace) {
+        NoTrace none;
+        return evaluateTerms(board, params, none);
+    }
+    trace->terms.clear();
+    WeightTrace weights{ params.weights().data(), *trace };
+    int score = evaluateTerms(board, params, weights);
+
+    std::sort(trace->terms.begin(), trace->terms.end(), [](const ChessEvalTrace::Term &a, const ChessEvalTrace::Term &b) { return a.weight < b.weight; });
+    size_t kept = 0;
+    for (const ChessEvalTrace::Term &term : trace->terms) {
+        if (kept > 0 && trace->terms[kept - 1].weight == term.weight) {
+            trace->terms[kept - 1].middlegame += term.middlegame;
+            trace->terms[kept - 1].endgame += term.endgame;
+        } else {
+            trace->terms[kept++] = term;
+        }
+    }
+    trace->terms.resize(kept);
+    return score;
+}
+
+bool ChessAI::findMove(const ChessBoard &board, int maxDepth, int timeLimitMs, ChessMove &bestMove)
+{
+    Limits limits;
+    limits.maxDepth = maxDepth > 0 ? maxDepth : limits.maxDepth;
+    limits.timeLimitMs = timeLimitMs;
+    Result result = search(board, limits);
+    bestMove = result.bestMove;
+    return result.hasMove;
+}
+
+ChessAI::Result ChessAI::search(const ChessBoard &board, const Limits &limits)
+{
+    Result result;
+    _board = board;
+    _limits = limits;
+    _start = std::chrono::steady_clock::now();
+    _aborted = false;
+    _nodes = 0;
+    _hashes[0] = board.hash();
+    _nullMove[0] = false;
+
+    ChessMoveList list;
+    board.generateMoves(list);
+    if (list.count == 0) {
+        result.score = board.inCheck() ? -kWinScore : 0;
+        return result;
+    }
+    result.hasMove = true;
+    result.bestMove = list.moves[0];
+
+    // killers belong to the last search's plies, history just fades
+    for (auto &killers : _killers) {
+        killers[0] = killers[1] = ChessMove();
+    }
+    for (auto &side : _history) {
+        for (auto &from : side) {
+            for (int &score : from) {
+                score /= 2;
+            }
+        }
+    }
+
+    int depthLimit = std::clamp(limits.maxDepth, 1, kMaxPly - 1);
+    int lineCount = std::clamp(limits.multiPV, 1, list.count);
+    for (int depth = 1; depth <= depthLimit; depth++) {
+        _rootDepth = depth;
+        std::vector<Line> lines;
+        _rootExcluded.clear();
+        for (int line = 0; line < lineCount; line++) {
+            int score = alphaBeta(depth, 0, -kInfinite, kInfinite);
+            if (_aborted) {
+                break;
+            }
+            lines.push_back(Line{ _pv[0][0], score, std::vector<ChessMove>(_pv[0], _pv[0] + _pvLength[0]) });
+            _rootExcluded.push_back(_pv[0][0]);
+        }
+        _rootExcluded.clear();
+        if (_aborted) {
+            break;
+        }
+        // a later line can come out ahead of an earlier one through the table
+        std::stable_sort(lines.begin(), lines.end(), [](const Line &a, const Line &b) { return a.score > b.score; });
+        result.bestMove = lines[0].move;
+        result.score = lines[0].score;
+        result.depth = depth;
+        result.pv = lines[0].pv;
+        result.lines = std::move(lines);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start);
+        result.iterations.push_back(Iteration{ depth, result.bestMove, result.score, _nodes, (int)elapsed.count() });
+        // forced mates won't change with more depth
+        bool allMates = std::all_of(result.lines.begin(), result.lines.end(), [](const Line &line) { return std::abs(line.score) >= kMateBound; });
+        if (allMates) {
+            break;
+        }
+    }
+    result.nodes = _nodes;
+    _lastScore = result.score;
+    _lastDepth = result.depth;
+    return result;
+}
+
+int ChessAI::alphaBeta(int depth, int ply, int alpha, int beta, const ChessMove *excluded)
+{
+    _pvLength[ply] = ply;
+    if (depth <= 0) {
+        return quiescence(ply, alpha, beta);
+    }
+    // checked before the node is counted, so a search never goes past its node limit
+    if (limitReached()) {
+        _aborted = true;
+    }
+    if (_aborted) {
+        return 0;
+    }
+    _nodes++;
+    if (ply > 0) {
+        if (isDraw(ply)) {
+            return 0;
+        }
+        // no line from here can beat a mate already found nearer the root
+        alpha = std::max(alpha, -kWinScore + ply);
+        beta = std::min(beta, kWinScore - ply - 1);
+        if (alpha >= beta) {
+            return alpha;
+        }
+    }
+    if (ply >= kMaxPly) {
+        return evaluate(_board, _evalParams);
+    }
+
+    const ChessSearchParams &params = _params;
+    bool pvNode = beta - alpha > 1;
+    bool inCheck = _board.inCheck();
+    uint64_t hash = _board.hash();
+
+    // copied out, the slot can be overwritten further down
+    bool hasTableMove = false;
+    ChessMove tableMove;
+    int tableScore = 0, tableDepth = 0;
+    Bound tableBound = kNone;
+    if (const TableEntry *entry = excluded ? nullptr : probe(hash)) {
+        hasTableMove = entry->bound != kNone && !(entry->move == ChessMove());
+        tableMove = entry->move;
+        tableScore = fromTable(entry->score, ply);
+        tableDepth = entry->depth;
+        tableBound = entry->bound;
+        if (!pvNode && ply > 0 && tableDepth >= depth) {
+            if (tableBound == kExact) return tableScore;
+            if (tableBound == kLower && tableScore >= beta) return tableScore;
+            if (tableBound == kUpper && tableScore <= alpha) return tableScore;
+        }
+    }
+
+    int eval = inCheck ? -kInfinite : evaluate(_board, _evalParams);
+    _staticEval[ply] = eval;
+    bool improving = !inCheck && ply >= 2 && eval > _staticEval[ply - 2];
+
+    if (!pvNode && !inCheck && !excluded) {
+        // so far above beta that nothing short of a blunder brings it back
+        if (depth <= params.reverseFutilityDepth && std::abs(beta) < kMateBound && eval - params.reverseFutilityMargin * (depth - improving) >= beta) {
+            return eval;
+        }
+        // so far below alpha that only captures could help
+        if (depth <= params.razorDepth && eval + params.razorBase + params.razorMargin * depth <= alpha) {
+            int score = quiescence(ply, alpha, alpha + 1);
+            if (score <= alpha) {
+                return score;
+            }
+        }
+        // give the opponent a free move, still failing high means this node will too
+        int us = _board.sideToMove();
+        bool hasPieces = _board.occupied(us) & ~(_board.pieces(us, Pawn) | _board.pieces(us, King));
+        if (params.nullMoveDepth > 0 && depth >= params.nullMoveDepth && eval >= beta && !_nullMove[ply] && hasPieces) {
+            int reduction = params.nullMoveReduction + depth / 4;
+            _board.makeNull(_undo[ply]);
+            _hashes[ply + 1] = _board.hash();
+            _nullMove[ply + 1] = true;
+            int score = -alphaBeta(depth - 1 - reduction, ply + 1, -beta, -beta + 1);
+            _board.unmakeNull(_undo[ply]);
+            if (_aborted) {
+                return 0;
+            }
+            if (score >= beta) {
+                return score >= kMateBound ? beta : score;
+            }
+        }
+    }
+
+    ChessMoveList list;
+    _board.generateMoves(list);
+    if (list.count == 0) {
+        return inCheck ? -kWinScore + ply : 0;
+    }
+    int order[ChessMoveList::kMaxMoves];
+    orderMoves(list, hasTableMove ? &tableMove : nullptr, ply, order);
+
+    ChessMove quiets[64];
+    int quietCount = 0;
+    int originalAlpha = alpha;
+    int bestScore = -kInfinite;
+    ChessMove bestMove = list.moves[order[0]];
+    int moveCount = 0;
+    for (int i = 0; i < list.count; i++) {
+        const ChessMove &move = list.moves[order[i]];
+        if (excluded && move == *excluded) {
+            continue;
+        }
+        if (ply == 0 && std::find(_rootExcluded.begin(), _rootExcluded.end(), move) != _rootExcluded.end()) {
+            continue;
+        }
+        bool quiet = !_board.isCapture(move) && move.promotion == NoPiece;
+        bool checks = _board.givesCheck(move);
+        moveCount++;
+
+        // once something is safe, late quiet moves near the leaves aren't worth a look
+        if (ply > 0 && bestScore > -kMateBound && quiet && !inCheck && !checks) {
+            if (depth <= params.lateMoveDepth && moveCount > (params.lateMoveBase + depth * depth) / (improving ? 1 : 2)) {
+                continue;
+            }
+            if (depth <= params.futilityDepth && eval + params.futilityBase + params.futilityMargin * depth <= alpha) {
+                continue;
+            }
+        }
+
+        // extensions stop at twice the nominal depth so checks can't run away with the search
+        int extension = 0;
+        if (ply < 2 * _rootDepth) {
+            extension = checks ? params.checkExtension : 0;
+            // a table move that beats everything else by a margin is worth a closer look
+            if (params.singularDepth > 0 && depth >= params.singularDepth && hasTableMove && move == tableMove && !excluded && ply > 0 &&
+                tableDepth >= depth - 3 && (tableBound == kLower || tableBound == kExact) && std::abs(tableScore) < kMateBound) {
+                int singularBeta = tableScore - params.singularMargin * depth;
+                int score = alphaBeta((depth - 1) / 2, ply, singularBeta - 1, singularBeta, &move);
+                if (_aborted) {
+                    return 0;
+                }
+                if (score < singularBeta) {
+                    extension = 1;
+                } else if (singularBeta >= beta) {
+                    // more than one move beats beta, this node will too
+                    return singularBeta;
+                }
+            }
+        }
+
+        make(move, ply);
+        int newDepth = depth - 1 + extension;
+        int score;
+        if (moveCount == 1) {
+            score = -alphaBeta(newDepth, ply + 1, -beta, -alpha);
+        } else {
+            // late quiet moves are searched shallower first, and again in full if they surprise
+            int reduction = 0;
+            if (params.lmrDepth > 0 && depth >= params.lmrDepth && moveCount > params.lmrMoves && quiet && !inCheck && !checks) {
+                reduction = _reductions[std::min(depth, 63)][std::min(moveCount, 63)];
+                reduction += improving ? 0 : 1;
+                reduction -= pvNode ? 1 : 0;
+                reduction -= (move == _killers[ply][0] || move == _killers[ply][1]) ? 1 : 0;
+                reduction = std::clamp(reduction, 0, newDepth - 1);
+            }
+            score = -alphaBeta(newDepth - reduction, ply + 1, -alpha - 1, -alpha);
+            if (score > alpha && reduction > 0) {
+                score = -alphaBeta(newDepth, ply + 1, -alpha - 1, -alpha);
+            }
+            if (score > alpha && score < beta) {
+                score = -alphaBeta(newDepth, ply + 1, -beta, -alpha);
+            }
+        }
+        unmake(move, ply);
+        if (_aborted) {
+            return 0;
+        }
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+            if (score > alpha) {
+                alpha = score;
+                _pv[ply][ply] = move;
+                std::copy(_pv[ply + 1] + ply + 1, _pv[ply + 1] + _pvLength[ply + 1], _pv[ply] + ply + 1);
+                _pvLength[ply] = std::max(_pvLength[ply + 1], ply + 1);
+                if (alpha >= beta) {
+                    if (quiet) {
+                        updateHistory(move, quiets, quietCount, depth, ply);
+                    }
+                    break;
+                }
+            }
+        }
+        if (quiet && quietCount < 64) {
+            quiets[quietCount++] = move;
+        }
+    }
+
+    // only excluded moves were legal
+    if (moveCount == 0) {
+        return alpha;
+    }
+    // a root that left moves out hasn't found the position's best move
+    if (!excluded && (ply > 0 || _rootExcluded.empty())) {
+        Bound bound = bestScore >= beta ? kLower : (bestScore > originalAlpha ? kExact : kUpper);
+        store(hash, bestScore, depth, bound, bestMove, ply);
+    }
+    return bestScore;
+}
+
+//
+// captures only until the position is quiet, standing pat on the evaluation unless in check
+//
+int ChessAI::quiescence(int ply, int alpha, int beta)
+{
+    _pvLength[ply] = ply;
+    // checked before the node is counted, so a search never goes past its node limit
+    if (limitReached()) {
+        _aborted = true;
+    }
+    if (_aborted) {
+        return 0;
+    }
+    _nodes++;
+    if (ply > 0 && isDraw(ply)) {
+        return 0;
+    }
+    bool inCheck = _board.inCheck();
+    if (ply >= kMaxPly) {
+        return inCheck ? 0 : evaluate(_board, _evalParams);
+    }
+
+    int bestScore = -kInfinite;
+    int standPat = 0;
+    if (!inCheck) {
+        standPat = evaluate(_board, _evalParams);
+        if (standPat >= beta) {
+            return standPat;
+        }
+        alpha = std::max(alpha, standPat);
+        bestScore = standPat;
+    }
+
+    ChessMoveList list;
+    _board.generateCaptures(list);
+    if (inCheck && list.count == 0) {
+        return -kWinScore + ply;
+    }
+    int order[ChessMoveList::kMaxMoves];
+    orderMoves(list, nullptr, ply, order);
+    for (int i = 0; i < list.count; i++) {
+        const ChessMove &move = list.moves[order[i]];
+        // even winning the piece outright wouldn't reach alpha
+        if (!inCheck && move.promotion == NoPiece) {
+            int victim = ChessBoard::typeOf(_board.pieceAt(move.to));
+            if (standPat + kMaterial[1][victim ? victim : Pawn] + 200 <= alpha) {
+                continue;
+            }
+        }
+        make(move, ply);
+        int score = -quiescence(ply + 1, -beta, -alpha);
+        unmake(move, ply);
+        if (_aborted) {
+            return 0;
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                alpha = score;
+                _pv[ply][ply] = move;
+                std::copy(_pv[ply + 1] + ply + 1, _pv[ply + 1] + _pvLength[ply + 1], _pv[ply] + ply + 1);
+                _pvLength[ply] = std::max(_pvLength[ply + 1], ply + 1);
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+    }
+    return bestScore;
+}
+
+//
+// fifty moves, bare material, or a repeat of a position earlier in this line
+//
+bool ChessAI::isDraw(int ply) const
+{
+    int clock = _board.halfmoveClock();
+    if (clock >= 100 || _board.insufficientMaterial()) {
+        return true;
+    }
+    // back through the line searched, then on into the game before the root
+    int before = (int)_limits.history.size();
+    for (int back = ply - 2; back >= -before && back >= ply - clock; back -= 2) {
+        uint64_t hash = back >= 0 ? _hashes[back] : _limits.history[before + back];
+        if (hash == _hashes[ply]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ChessAI::orderMoves(const ChessMoveList &list, const ChessMove *tableMove, int ply, int *order) const
+{
+    int scores[ChessMoveList::kMaxMoves];
+    int side = _board.sideToMove();
+    for (int i = 0; i < list.count; i++) {
+        const ChessMove &move = list.moves[i];
+        int score;
+        if (tableMove && move == *tableMove) {
+            score = kTableMoveScore;
+        } else if (_board.isCapture(move) || move.promotion != NoPiece) {
+            int victim = ChessBoard::typeOf(_board.pieceAt(move.to));
+            int attacker = ChessBoard::typeOf(_board.pieceAt(move.from));
+            score = kCaptureScore + 16 * (kMaterial[0][victim] + kMaterial[0][move.promotion]) - attacker;
+        } else if (move == _killers[ply][0]) {
+            score = kKillerScore + 1;
+        } else if (move == _killers[ply][1]) {
+            score = kKillerScore;
+        } else {
+            score = _history[side][move.from][move.to];
+        }
+        int at = i;
+        while (at > 0 && scores[at - 1] < score) {
+            scores[at] = scores[at - 1];
+            order[at] = order[at - 1];
+            at--;
+        }
+        scores[at] = score;
+        order[at] = i;
+    }
+}
+
+//
+// the quiet move that cut off becomes a killer and gains history, the quiet moves tried
+// before it lose some
+//
+void ChessAI::updateHistory(const ChessMove &best, const ChessMove *quiets, int quietCount, int depth, int ply)
+{
+    if (!(best == _killers[ply][0])) {
+        _killers[ply][1] = _killers[ply][0];
+        _killers[ply][0] = best;
+    }
+    int side = _board.sideToMove();
+    int bonus = std::min(depth * depth, 400);
+    // pulled towards the bonus, so scores stay within kMaxHistory
+    int &score = _history[side][best.from][best.to];
+    score += bonus - score * bonus / kMaxHistory;
+    for (int i = 0; i < quietCount; i++) {
+        int &malus = _history[side][quiets[i].from][quiets[i].to];
+        malus -= bonus + malus * bonus / kMaxHistory;
+    }
+}
+
+bool ChessAI::limitReached() const
+{
+    return searchLimitReached(_nodes, _limits.nodeLimit, _limits.timeLimitMs, _start);
+}
+
+const ChessAI::TableEntry *ChessAI::probe(uint64_t hash) const
+{
+    const TableEntry &entry = _table[hash & (_table.size() - 1)];
+    return (entry.bound != kNone && entry.hash == hash) ? &entry : nullptr;
+}
+
+void ChessAI::store(uint64_t hash, int score, int depth, Bound bound, const ChessMove &move, int ply)
+{
+    TableEntry &slot = _table[hash & (_table.size() - 1)];
+    // keep deeper results for the same position
+    if (slot.bound != kNone && slot.hash == hash && slot.depth > depth && bound != kExact) {
+        return;
+    }
+    slot = TableEntry{ hash, toTable(score, ply), (int16_t)depth, bound, move };
+}
+
+void ChessAI::make(const ChessMove &move, int ply)
+{
+    _board.make(move, _undo[ply]);
+    _hashes[ply + 1] = _board.hash();
+    _nullMove[ply + 1] = false;
+}
+
+void ChessAI::unmake(const ChessMove &move, int ply)
+{
+    _board.unmake(move, _undo[ply]);
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "ChessBoard.h"
+#include "Search.h"
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+//
+// the selective search's knobs. every one can be set by name, so the settings panel and the
+// headless tools tune them the same way, and a depth of 0 switches its technique off
+//
+struct ChessSearchParams
+{
+    // late move reductions, in plies: (base + log(depth) * log(move number) / divisor) / 100
+    int lmrBase = 75;
+    int lmrDivisor = 225;
+    int lmrDepth = 3;
+    // moves searched at full depth before the rest are reduced
+    int lmrMoves = 3;
+    // reverse futility: a static eval margin * depth above beta fails high without searching
+    int reverseFutilityDepth = 8;
+    int reverseFutilityMargin = 80;
+    // futility: quiet moves are skipped when eval + base + margin * depth can't reach alpha
+    int futilityDepth = 6;
+    int futilityBase = 80;
+    int futilityMargin = 90;
+    // razoring: that far below alpha near the leaves, quiescence decides
+    int razorDepth = 3;
+    int razorBase = 250;
+    int razorMargin = 200;
+    // late move pruning: quiet moves after base + depth * depth are skipped
+    int lateMoveDepth = 8;
+    int lateMoveBase = 3;
+    // null move pruning, reduced by reduction + depth / 4
+    int nullMoveDepth = 3;
+    int nullMoveReduction = 3;
+    // plies added for a move that checks
+    int checkExtension = 1;
+    // singular extensions: the table move gets a ply when nothing else comes within margin * depth
+    int singularDepth = 8;
+    int singularMargin = 2;
+
+    struct Option
+    {
+        const char *name;
+        int ChessSearchParams::*value;
+        int min;
+        int max;
+    };
+    static std::span<const Option> options();
+    // false if there is no option of that name
+    bool set(const std::string &name, int value);
+};
+
+//
+// the evaluation's weights, middlegame then endgame where a term has both. a default constructed
+// set holds the engine's own values. every member is an int, so the tuner can treat the set as
+// one flat array of weights
+//
+struct ChessEvalParams
+{
+    int material[2][King + 1];
+    // piece squares from white's side, rank 8 first as the board is drawn, for both halves
+    int pieceSquares[King + 1][64];
+    // the king walks to the centre once the queens are gone
+    int kingEndgame[64];
+    // by how far up the board the passed pawn has got
+    int passedPawn[2][8];
+    int doubledPawn[2];
+    int isolatedPawn[2];
+    int bishopPair[2];
+    int rookOpenFile[2];
+    int rookHalfOpenFile[2];
+    // per square a piece reaches beyond the average
+    int mobility[2][King + 1];
+    // middlegame only, for the side to move
+    int tempo;
+
+    ChessEvalParams();
+
+    std::span<int> weights() { return std::span<int>(&material[0][0], sizeof(ChessEvalParams) / sizeof(int)); }
+    std::span<const int> weights() const { return std::span<const int>(&material[0][0], sizeof(ChessEvalParams) / sizeof(int)); }
+
+    // the members by name, as runs of weights, for printing a tuned set back as source
+    struct Table
+    {
+        const char *name;
+        size_t offset;
+        size_t count;
+        // values per row when printed
+        size_t rowLength;
+    };
+    static std::span<const Table> tables();
+};
+
+//
+// how often an evaluation counted each weight: one term per use, white's uses positive and
+// black's negative, so the evaluation from white's side is the blend of the sums
+//
+struct ChessEvalTrace
+{
+    struct Term
+    {
+        uint16_t weight;
+        int16_t middlegame;
+        int16_t endgame;
+    };
+    std::vector<Term> terms;
+    // 0 for a bare endgame up to 24 with everything on the board
+    int phase = 0;
+};
+
+//
+// chess player: principal variation search with a transposition table, quiescence, killer
+// and history ordering and the pruning, reductions and extensions in ChessSearchParams.
+// scores are centipawns from the side to move's point of view
+//
+// it keeps its own loop rather than running on Search<State>. the selective search needs a
+// null move, a static eval before any move is tried, quiet and capture moves told apart for
+// the late move and futility cuts, a search with one root move excluded (singular extensions
+// and multiPV), a principal variation triangle, killers and history fed back from cutoffs, the
+// game's earlier positions for repetitions and a quiescence search with its own move list.
+// each of those would be a hook on Search that no other game has a use for, and the inner
+// loop is where chess spends its time. what the two do share lives in Search.h: the score
+// scale and searchLimitReached()
+//
+class ChessAI
+{
+public:
+    static const int kWinScore = kSearchWinScore;
+    static const int kMaxPly = 128;
+
+    struct Limits
+    {
+        int maxDepth = 64;
+        // 0 for no limit
+        int timeLimitMs = 0;
+        uint64_t nodeLimit = 0;
+        // root moves to report, each with its own score and line
+        int multiPV = 1;
+        // hashes of the game's positions before the one searched, oldest first, back to at least
+        // the last capture or pawn move, so repeating one of them scores as the draw it heads for
+        std::vector<uint64_t> history;
+    };
+
+    struct Line
+    {
+        ChessMove move;
+        int score = 0;
+        std::vector<ChessMove> pv;
+    };
+
+    // where an iteration of the deepening left the search
+    struct Iteration
+    {
+        int depth = 0;
+        ChessMove bestMove;
+        int score = 0;
+        uint64_t nodes = 0;
+        int elapsedMs = 0;
+    };
+
+    struct Result
+    {
+        // false when the side to move has no moves
+        bool hasMove = false;
+        ChessMove bestMove;
+        int score = 0;
+        // deepest iteration that finished
+        int depth = 0;
+        uint64_t nodes = 0;
+        std::vector<ChessMove> pv;
+        // best first, multiPV of them or every legal move if there are fewer
+        std::vector<Line> lines;
+        // every iteration that finished, the last one last
+        std::vector<Iteration> iterations;
+    };
+
+    ChessAI(size_t tableEntries = 1 << 20);
+
+    // iterative deepening from board. with multiPV above 1 each iteration searches the root
+    // again for every further line, leaving out the moves earlier lines chose, so all the lines
+    // share one table
+    Result search(const ChessBoard &board, const Limits &limits);
+    // best move for the side to move, false if it has none, searching up to maxDepth plies and
+    // stopping after timeLimitMs (0 for no limit)
+    bool findMove(const ChessBoard &board, int maxDepth, int timeLimitMs, ChessMove &bestMove);
+
+    // material, piece squares, pawn structure and mobility, tapered between middlegame and endgame
+    static int evaluate(const ChessBoard &board);
+    // the same with other weights, and with trace set, the weights it used
+    static int evaluate(const ChessBoard &board, const ChessEvalParams &params, ChessEvalTrace *trace = nullptr);
+    static constexpr int kTotalPhase = 24;
+
+    const ChessSearchParams &params() const { return _params; }
+    void setParams(const ChessSearchParams &params);
+    const ChessEvalParams &evalParams() const { return _evalParams; }
+    void setEvalParams(const ChessEvalParams &params) { _evalParams = params; }
+    // forget the table and the move ordering history, for a new game
+    void clear();
+
+    uint64_t nodes() const { return _nodes; }
+    int lastScore() const { return _lastScore; }
+    int lastDepth() const { return _lastDepth; }
+
+private:
+    enum Bound : uint8_t { kNone, kExact, kLower, kUpper };
+    struct TableEntry
+    {
+        uint64_t hash;
+        int32_t score;
+        int16_t depth;
+        Bound bound;
+        ChessMove move;
+    };
+
+    // excluded leaves one move out, for the singular extension's verification search
+    int alphaBeta(int depth, int ply, int alpha, int beta, const ChessMove *excluded = nullptr);
+    int quiescence(int ply, int alpha, int beta);
+    bool isDraw(int ply) const;
+    void orderMoves(const ChessMoveList &list, const ChessMove *tableMove, int ply, int *order) const;
+    void updateHistory(const ChessMove &best, const ChessMove *quiets, int quietCount, int depth, int ply);
+    bool limitReached() const;
+
+    const TableEntry *probe(uint64_t hash) const;
+    void store(uint64_t hash, int score, int depth, Bound bound, const ChessMove &move, int ply);
+
+    void make(const ChessMove &move, int ply);
+    void unmake(const ChessMove &move, int ply);
+
+    ChessSearchParams _params;
+    ChessEvalParams _evalParams;
+    // _reductions[depth][move number] in plies
+    int _reductions[64][64];
+
+    std::vector<TableEntry> _table;
+    ChessBoard _board;
+    // root moves already reported as lines in this iteration
+    std::vector<ChessMove> _rootExcluded;
+    ChessBoard::Undo _undo[kMaxPly + 1];
+    // hashes along the line being searched, for repetitions
+    uint64_t _hashes[kMaxPly + 1];
+    int _staticEval[kMaxPly + 1];
+    // whether the move into each ply was a null move
+    bool _nullMove[kMaxPly + 1];
+    ChessMove _killers[kMaxPly + 1][2];
+    int _history[2][64][64];
+    ChessMove _pv[kMaxPly + 1][kMaxPly + 1];
+    int _pvLength[kMaxPly + 1];
+
+    Limits _limits;
+    int _rootDepth;
+    std::chrono::steady_clock::time_point _start;
+    bool _aborted;
+    uint64_t _nodes;
+    int _lastScore;
+    int _lastDepth;
+};
@@ -0,0 +1,872 @@
+#include "ChessBoard.h"
+#include "MagicBitboards.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace {
+    const char kPieceLetters[] = " pnbrqk";
+
+    // zobrist keys: [side][piece][square], then castling rights, en passant file and black to move
+    const int kCastlingKeys = 2 * (King + 1) * 64;
+    const int kEnPassantKeys = kCastlingKeys + 16;
+    const int kSideKey = kEnPassantKeys + 8;
+
+    constexpr std::array<uint64_t, kSideKey + 1> makeKeys()
+    {
+        std::array<uint64_t, kSideKey + 1> keys{};
+        uint64_t seed = 0x6a09e667f3bcc908ULL;
+        for (uint64_t &key : keys) {
+            // splitmix64
+            seed += 0x9e3779b97f4a7c15ULL;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            key = z ^ (z >> 31);
+        }
+        return keys;
+    }
+    constexpr std::array<uint64_t, kSideKey + 1> kKeys = makeKeys();
+
+    uint64_t pieceKey(int side, int piece, int square) { return kKeys[(side * (King + 1) + piece) * 64 + square]; }
+
+    constexpr std::array<std::array<uint64_t, 64>, 2> makePawnAttacks()
+    {
+        std::array<std::array<uint64_t, 64>, 2> attacks{};
+        for (int square = 0; square < 64; square++) {
+            uint64_t bit = 1ULL << square;
+            attacks[ChessBoard::kWhite][square] = ((bit & NOT_FILE_A) << 7) | ((bit & NOT_FILE_H) << 9);
+            attacks[ChessBoard::kBlack][square] = ((bit & NOT_FILE_A) >> 9) | ((bit & NOT_FILE_H) >> 7);
+        }
+        return attacks;
+    }
+    constexpr std::array<std::array<uint64_t, 64>, 2> kPawnAttacks = makePawnAttacks();
+
+    //
+    // between and line tables, walking the eight directions out of every square
+    //
+    struct Lines
+    {
+        std::array<std::array<uint64_t, 64>, 64> between{};
+        std::array<std::array<uint64_t, 64>, 64> line{};
+    };
+
+    constexpr Lines makeLines()
+    {
+        Lines lines;
+        const int directions[8][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 1, 1 }, { -1, -1 }, { 1, -1 }, { -1, 1 } };
+        for (int from = 0; from < 64; from++) {
+            for (const auto &direction : directions) {
+                int df = direction[0], dr = direction[1];
+                // the full line runs both ways through from
+                uint64_t full = 1ULL << from;
+                for (int sign = -1; sign <= 1; sign += 2) {
+                    int file = from % 8 + sign * df, rank = from / 8 + sign * dr;
+                    while (file >= 0 && file < 8 && rank >= 0 && rank < 8) {
+                        full |= 1ULL << (rank * 8 + file);
+                        file += sign * df;
+                        rank += sign * dr;
+                    }
+                }
+                uint64_t passed = 0;
+                int file = from % 8 + df, rank = from / 8 + dr;
+                while (file >= 0 && file < 8 && rank >= 0 && rank < 8) {
+                    int to = rank * 8 + file;
+                    lines.between[from][to] = passed;
+                    lines.line[from][to] = full;
+                    passed |= 1ULL << to;
+                    file += df;
+                    rank += dr;
+                }
+            }
+        }
+        return lines;
+    }
+    constexpr Lines kLines = makeLines();
+
+    // castling rights that survive a move touching each square
+    constexpr std::array<uint8_t, 64> makeCastlingMasks()
+    {
+        std::array<uint8_t, 64> masks{};
+        for (uint8_t &mask : masks) {
+            mask = 15;
+        }
+        masks[0] = (uint8_t)~ChessBoard::kWhiteQueenside & 15;
+        masks[4] = (uint8_t)~(ChessBoard::kWhiteKingside | ChessBoard::kWhiteQueenside) & 15;
+        masks[7] = (uint8_t)~ChessBoard::kWhiteKingside & 15;
+        masks[56] = (uint8_t)~ChessBoard::kBlackQueenside & 15;
+        masks[60] = (uint8_t)~(ChessBoard::kBlackKingside | ChessBoard::kBlackQueenside) & 15;
+        masks[63] = (uint8_t)~ChessBoard::kBlackKingside & 15;
+        return masks;
+    }
+    constexpr std::array<uint8_t, 64> kCastlingMasks = makeCastlingMasks();
+
+    int pieceFromLetter(char letter)
+    {
+        for (int piece = Pawn; piece <= King; piece++) {
+            if (kPieceLetters[piece] == tolower(letter)) {
+                return piece;
+            }
+        }
+        return NoPiece;
+    }
+
+    int squareFromText(const std::string &text)
+    {
+        if (text.size() != 2 || text[0] < 'a' || text[0] > 'h' || text[1] < '1' || text[1] > '8') {
+            return -1;
+        }
+        return (text[1] - '1') * 8 + (text[0] - 'a');
+    }
+
+    std::string squareText(int square)
+    {
+        return std::string(1, (char)('a' + square % 8)) + (char)('1' + square / 8);
+    }
+}
+
+std::string ChessMove::toString() const
+{
+    std::string text = squareText(from) + squareText(to);
+    if (promotion != NoPiece) {
+        text += kPieceLetters[promotion];
+    }
+    return text;
+}
+
+uint64_t ChessBoard::pawnAttacks(int side, int square) { return kPawnAttacks[side][square]; }
+uint64_t ChessBoard::knightAttacks(int square) { return KnightAttacks[square]; }
+uint64_t ChessBoard::kingAttacks(int square) { return KingAttacks[square]; }
+uint64_t ChessBoard::bishopAttacks(int square, uint64_t occupancy) { return getBishopAttacks(square, occupancy); }
+uint64_t ChessBoard::rookAttacks(int square, uint64_t occupancy) { return getRookAttacks(square, occupancy); }
+uint64_t ChessBoard::between(int from, int to) { return kLines.between[from][to]; }
+uint64_t ChessBoard::line(int from, int to) { return kLines.line[from][to]; }
+
+ChessBoard::ChessBoard()
+{
+    initMagicBitboards();
+    clear();
+}
+
+void ChessBoard::clear()
+{
+    for (int side = 0; side < 2; side++) {
+        for (int piece = 0; piece <= King; piece++) {
+            _pieces[side][piece] = 0;
+        }
+        _occupied[side] = 0;
+    }
+    for (uint8_t &square : _squares) {
+        square = 0;
+    }
+    _side = kWhite;
+    _castling = 0;
+    _enPassant = -1;
+    _halfmoveClock = 0;
+    _fullmoveNumber = 1;
+    _hash = 0;
+}
+
+ChessBoard ChessBoard::startPosition()
+{
+    ChessBoard board;
+    board.setFEN(kStartFEN);
+    return board;
+}
+
+void ChessBoard::addPiece(int side, int piece, int square)
+{
+    uint64_t bit = 1ULL << square;
+    _pieces[side][piece] |= bit;
+    _occupied[side] |= bit;
+    _squares[square] = (uint8_t)(piece | side << 3);
+    _hash ^= pieceKey(side, piece, square);
+}
+
+void ChessBoard::removePiece(int side, int piece, int square)
+{
+    uint64_t bit = 1ULL << square;
+    _pieces[side][piece] &= ~bit;
+    _occupied[side] &= ~bit;
+    _squares[square] = 0;
+    _hash ^= pieceKey(side, piece, square);
+}
+
+void ChessBoard::movePiece(int side, int piece, int from, int to)
+{
+    uint64_t bits = (1ULL << from) | (1ULL << to);
+    _pieces[side][piece] ^= bits;
+    _occupied[side] ^= bits;
+    _squares[to] = _squares[from];
+    _squares[from] = 0;
+    _hash ^= pieceKey(side, piece, from) ^ pieceKey(side, piece, to);
+}
+
+void ChessBoard::computeHash()
+{
+    _hash = kKeys[kCastlingKeys + _castling];
+    if (_enPassant >= 0) {
+        _hash ^= kKeys[kEnPassantKeys + fileOf(_enPassant)];
+    }
+    if (_side == kBlack) {
+        _hash ^= kKeys[kSideKey];
+    }
+    for (int square = 0; square < 64; square++) {
+        if (_squares[square]) {
+            _hash ^= pieceKey(sideOf(_squares[square]), typeOf(_squares[square]), square);
+        }
+    }
+}
+
+bool ChessBoard::setFEN(const std::string &fen)
+{
+    std::istringstream stream(fen);
+    std::string placement, side = "w", castling = "-", enPassant = "-";
+    int halfmoveClock = 0, fullmoveNumber = 1;
+    stream >> placement >> side >> castling >> enPassant >> halfmoveClock >> fullmoveNumber;
+
+    ChessBoard board;
+    int rank = 7, file = 0;
+    for (char character : placement) {
+        if (character == '/') {
+            rank--;
+            file = 0;
+        } else if (isdigit(character)) {
+            file += character - '0';
+        } else {
+            int piece = pieceFromLetter(character);
+            if (piece == NoPiece || file > 7 || rank < 0) {
+                return false;
+            }
+            board.addPiece(isupper(character) ? kWhite : kBlack, piece, rank * 8 + file);
+            file++;
+        }
+    }
+    if (std::popcount(board._pieces[kWhite][King]) != 1 || std::popcount(board._pieces[kBlack][King]) != 1) {
+        return false;
+    }
+
+    board._side = side == "b" ? kBlack : kWhite;
+    // rights are only kept while the king and rook are where they started
+    const struct { char letter; int right; int king; int rook; } rights[] = {
+        { 'K', kWhiteKingside, 4, 7 }, { 'Q', kWhiteQueenside, 4, 0 }, { 'k', kBlackKingside, 60, 63 }, { 'q', kBlackQueenside, 60, 56 }
+    };
+    for (const auto &right : rights) {
+        int owner = isupper(right.letter) ? kWhite : kBlack;
+        if (castling.find(right.letter) != std::string::npos && board._squares[right.king] == (King | owner << 3) && board._squares[right.rook] == (Rook | owner << 3)) {
+            board._castling |= right.right;
+        }
+    }
+    // only kept when a pawn could actually take, so equal positions hash equally
+    int square = squareFromText(enPassant);
+    if (square >= 0 && (pawnAttacks(board._side ^ 1, square) & board._pieces[board._side][Pawn])) {
+        board._enPassant = square;
+    }
+    board._halfmoveClock = std::max(halfmoveClock, 0);
+    board._fullmoveNumber = std::max(fullmoveNumber, 1);
+    board.computeHash();
+    *this = board;
+    return true;
+}
+
+static_assert(sizeof(PackedChessBoard) == 32, "packed boards are written to disk as they are");
+
+PackedChessBoard ChessBoard::pack() const
+{
+    PackedChessBoard packed{};
+    packed.occupancy = occupied();
+    int index = 0;
+    for (uint64_t bits = packed.occupancy; bits; bits &= bits - 1, index++) {
+        packed.pieces[index / 2] |= _squares[std::countr_zero(bits)] << (index % 2 * 4);
+    }
+    packed.sideToMove = (uint8_t)_side;
+    packed.castling = (uint8_t)_castling;
+    packed.enPassant = (int8_t)_enPassant;
+    packed.halfmoveClock = (uint8_t)std::min(_halfmoveClock, 255);
+    packed.fullmoveNumber = (uint32_t)_fullmoveNumber;
+    return packed;
+}
+
+bool ChessBoard::unpack(const PackedChessBoard &packed)
+{
+    if (std::popcount(packed.occupancy) > 32 || packed.sideToMove > kBlack || packed.castling > 15 || packed.enPassant < -1 || packed.enPassant > 63) {
+        return false;
+    }
+    ChessBoard board;
+    int index = 0;
+    for (uint64_t bits = packed.occupancy; bits; bits &= bits - 1, index++) {
+        int code = packed.pieces[index / 2] >> (index % 2 * 4) & 15;
+        if (typeOf(code) < Pawn || typeOf(code) > King) {
+            return false;
+        }
+        board.addPiece(sideOf(code), typeOf(code), std::countr_zero(bits));
+    }
+    if (std::popcount(board._pieces[kWhite][King]) != 1 || std::popcount(board._pieces[kBlack][King]) != 1) {
+        return false;
+    }
+    // a right whose king or rook has moved would have castling move a piece that isn't there
+    const struct { int right; int side; int king; int rook; } rights[] = {
+        { kWhiteKingside, kWhite, 4, 7 }, { kWhiteQueenside, kWhite, 4, 0 }, { kBlackKingside, kBlack, 60, 63 }, { kBlackQueenside, kBlack, 60, 56 }
+    };
+    for (const auto &right : rights) {
+        if ((packed.castling & right.right) && (board._squares[right.king] != (King | right.side << 3) || board._squares[right.rook] != (Rook | right.side << 3))) {
+            return false;
+        }
+    }
+    board._side = packed.sideToMove;
+    board._castling = packed.castling;
+    board._enPassant = packed.enPassant;
+    board._halfmoveClock = packed.halfmoveClock;
+    board._fullmoveNumber = std::max<int>(packed.fullmoveNumber, 1);
+    board.computeHash();
+    *this = board;
+    return true;
+}
+
+std::string ChessBoard::fen() const
+{
+    std::string text;
+    for (int rank = 7; rank >= 0; rank--) {
+        int empty = 0;
+        for (int file = 0; file < 8; file++) {
+            int code = _squares[rank * 8 + file];
+            if (!code) {
+                empty++;
+                continue;
+            }
+            if (empty) {
+                text += (char)('0' + empty);
+                empty = 0;
+            }
+            char letter = kPieceLetters[typeOf(code)];
+            text += sideOf(code) == kWhite ? (char)toupper(letter) : letter;
+        }
+        if (empty) {
+            text += (char)('0' + empty);
+        }
+        if (rank > 0) {
+            text += '/';
+        }
+    }
+    std::string castling;
+    if (_castling & kWhiteKingside) castling += 'K';
+    if (_castling & kWhiteQueenside) castling += 'Q';
+    if (_castling & kBlackKingside) castling += 'k';
+    if (_castling & kBlackQueenside) castling += 'q';
+    text += _side == kWhite ? " w " : " b ";
+    text += castling.empty() ? "-" : castling;
+    text += ' ';
+    text += _enPassant >= 0 ? squareText(_enPassant) : std::string("-");
+    text += ' ';
+    text += std::to_string(_halfmoveClock);
+    text += ' ';
+    text += std::to_string(_fullmoveNumber);
+    return text;
+}
+
+bool ChessBoard::setState(const std::string &state)
+{
+    if (state.size() < 64) {
+        return false;
+    }
+    // the squares become a FEN placement, rank 8 first
+    std::string placement;
+    for (int rank = 7; rank >= 0; rank--) {
+        for (int file = 0; file < 8; file++) {
+            char letter = state[rank * 8 + file];
+            placement += letter == '0' ? '1' : letter;
+        }
+        if (rank > 0) {
+            placement += '/';
+        }
+    }
+    std::string rest = state.size() > 65 ? state.substr(65) : "w KQkq - 0 1";
+    return setFEN(placement + " " + rest);
+}
+
+std::string ChessBoard::stateString() const
+{
+    std::string state;
+    state.reserve(96);
+    for (int square = 0; square < 64; square++) {
+        int code = _squares[square];
+        char letter = code ? kPieceLetters[typeOf(code)] : '0';
+        state += code && sideOf(code) == kWhite ? (char)toupper(letter) : letter;
+    }
+    std::string full = fen();
+    return state + full.substr(full.find(' '));
+}
+
+uint64_t ChessBoard::attackersTo(int square, uint64_t occupancy) const
+{
+    uint64_t diagonal = _pieces[kWhite][Bishop] | _pieces[kWhite][Queen] | _pieces[kBlack][Bishop] | _pieces[kBlack][Queen];
+    uint64_t straight = _pieces[kWhite][Rook] | _pieces[kWhite][Queen] | _pieces[kBlack][Rook] | _pieces[kBlack][Queen];
+    return (kPawnAttacks[kWhite][square] & _pieces[kBlack][Pawn]) | (kPawnAttacks[kBlack][square] & _pieces[kWhite][Pawn]) |
+           (KnightAttacks[square] & (_pieces[kWhite][Knight] | _pieces[kBlack][Knight])) |
+           (KingAttacks[square] & (_pieces[kWhite][King] | _pieces[kBlack][King])) |
+           (getBishopAttacks(square, occupancy) & diagonal) | (getRookAttacks(square, occupancy) & straight);
+}
+
+uint64_t ChessBoard::pinned(int side) const
+{
+    int king = kingSquare(side);
+    int them = side ^ 1;
+    uint64_t occupancy = occupied();
+    uint64_t snipers = (getRookAttacks(king, 0) & (_pieces[them][Rook] | _pieces[them][Queen])) |
+                       (getBishopAttacks(king, 0) & (_pieces[them][Bishop] | _pieces[them][Queen]));
+    uint64_t result = 0;
+    for (; snipers; snipers &= snipers - 1) {
+        uint64_t blockers = kLines.between[king][std::countr_zero(snipers)] & occupancy;
+        if (blockers && !(blockers & (blockers - 1))) {
+            result |= blockers & _occupied[side];
+        }
+    }
+    return result;
+}
+
+void ChessBoard::generateMoves(ChessMoveList &list) const
+{
+    generate(list, false);
+}
+
+void ChessBoard::generateCaptures(ChessMoveList &list) const
+{
+    generate(list, true);
+}
+
+void ChessBoard::generateChecks(ChessMoveList &list) const
+{
+    generate(list, false);
+    int kept = 0;
+    for (int i = 0; i < list.count; i++) {
+        if (givesCheck(list.moves[i])) {
+            list.moves[kept++] = list.moves[i];
+        }
+    }
+    list.count = kept;
+}
+
+//
+// legal moves straight off the bitboards: pinned pieces stay on their pin line, in check
+// only captures of the checker and blocks count, the king never steps onto an attacked square
+// and en passant, which can uncover the king along the rank, is checked by trying it
+//
+void ChessBoard::generate(ChessMoveList &list, bool capturesOnly) const
+{
+    list.count = 0;
+    int us = _side, them = us ^ 1;
+    uint64_t own = _occupied[us], enemy = _occupied[them], occupancy = own | enemy;
+    int king = kingSquare(us);
+    uint64_t checking = attackersTo(king, occupancy) & enemy;
+    // in check every evasion is searched, captures or not
+    bool quietsToo = !capturesOnly || checking;
+
+    uint64_t kingTargets = KingAttacks[king] & ~own & (quietsToo ? ~0ULL : enemy);
+    uint64_t withoutKing = occupancy ^ (1ULL << king);
+    for (; kingTargets; kingTargets &= kingTargets - 1) {
+        int to = std::countr_zero(kingTargets);
+        if (!(attackersTo(to, withoutKing) & enemy)) {
+            list.add(king, to);
+        }
+    }
+    if (checking & (checking - 1)) {
+        return;
+    }
+
+    uint64_t targets = ~own;
+    if (checking) {
+        targets = kLines.between[king][std::countr_zero(checking)] | checking;
+    } else if (capturesOnly) {
+        targets = enemy;
+    }
+    uint64_t pins = pinned(us);
+
+    for (uint64_t knights = _pieces[us][Knight] & ~pins; knights; knights &= knights - 1) {
+        int from = std::countr_zero(knights);
+        for (uint64_t moves = KnightAttacks[from] & targets; moves; moves &= moves - 1) {
+            list.add(from, std::countr_zero(moves));
+        }
+    }
+    for (uint64_t sliders = _pieces[us][Bishop] | _pieces[us][Queen]; sliders; sliders &= sliders - 1) {
+        int from = std::countr_zero(sliders);
+        uint64_t moves = getBishopAttacks(from, occupancy) & targets;
+        if (pins & (1ULL << from)) {
+            moves &= kLines.line[king][from];
+        }
+        for (; moves; moves &= moves - 1) {
+            list.add(from, std::countr_zero(moves));
+        }
+    }
+    for (uint64_t sliders = _pieces[us][Rook] | _pieces[us][Queen]; sliders; sliders &= sliders - 1) {
+        int from = std::countr_zero(sliders);
+        uint64_t moves = getRookAttacks(from, occupancy) & targets;
+        if (pins & (1ULL << from)) {
+            moves &= kLines.line[king][from];
+        }
+        for (; moves; moves &= moves - 1) {
+            list.add(from, std::countr_zero(moves));
+        }
+    }
+
+    int forward = us == kWhite ? 8 : -8;
+    uint64_t lastRank = us == kWhite ? RANK_8 : RANK_1;
+    uint64_t doubleRank = us == kWhite ? RANK_2 : RANK_7;
+    auto addPawnMoves = [&](int from, uint64_t moves) {
+        for (; moves; moves &= moves - 1) {
+            int to = std::countr_zero(moves);
+            if (!((1ULL << to) & lastRank)) {
+                list.add(from, to);
+            } else if (!quietsToo) {
+                list.add(from, to, Queen);
+            } else {
+                for (int piece = Queen; piece >= Knight; piece--) {
+                    list.add(from, to, piece);
+                }
+            }
+        }
+    };
+    for (uint64_t pawns = _pieces[us][Pawn]; pawns; pawns &= pawns - 1) {
+        int from = std::countr_zero(pawns);
+        uint64_t pinLine = (pins & (1ULL << from)) ? kLines.line[king][from] : ~0ULL;
+        uint64_t moves = kPawnAttacks[us][from] & enemy;
+        uint64_t push = 1ULL << (from + forward);
+        if (!(push & occupancy)) {
+            // quiet pushes only count for quiescence when they promote
+            if (quietsToo || (push & lastRank)) {
+                moves |= push;
+            }
+            uint64_t push2 = 1ULL << (from + 2 * forward);
+            if (quietsToo && ((1ULL << from) & doubleRank) && !(push2 & occupancy)) {
+                moves |= push2;
+            }
+        }
+        addPawnMoves(from, moves & targets & pinLine);
+
+        if (_enPassant >= 0 && (kPawnAttacks[us][from] & (1ULL << _enPassant))) {
+            int taken = _enPassant - forward;
+            uint64_t after = (occupancy ^ (1ULL << from) ^ (1ULL << taken)) | (1ULL << _enPassant);
+            uint64_t attackers = (getRookAttacks(king, after) & (_pieces[them][Rook] | _pieces[them][Queen])) |
+                                 (getBishopAttacks(king, after) & (_pieces[them][Bishop] | _pieces[them][Queen])) |
+                                 (KnightAttacks[king] & _pieces[them][Knight]) |
+                                 (kPawnAttacks[us][king] & _pieces[them][Pawn] & ~(1ULL << taken));
+            if (!attackers) {
+                list.add(from, _enPassant);
+            }
+        }
+    }
+
+    if (quietsToo && !checking) {
+        int rank = us == kWhite ? 0 : 56;
+        int kingside = us == kWhite ? kWhiteKingside : kBlackKingside;
+        int queenside = us == kWhite ? kWhiteQueenside : kBlackQueenside;
+        if ((_castling & kingside) && !(occupancy & (3ULL << (rank + 5))) && !isAttacked(rank + 5, them) && !isAttacked(rank + 6, them)) {
+            list.add(rank + 4, rank + 6);
+        }
+        if ((_castling & queenside) && !(occupancy & (7ULL << (rank + 1))) && !isAttacked(rank + 3, them) && !isAttacked(rank + 2, them)) {
+            list.add(rank + 4, rank + 2);
+        }
+    }
+}
+
+bool ChessBoard::isCapture(const ChessMove &move) const
+{
+    return _squares[move.to] != 0 || (move.to == _enPassant && typeOf(_squares[move.from]) == Pawn);
+}
+
+//
+// direct checks from the moved (or promoted) piece, then discovered ones by looking from the
+// enemy king through the squares the move empties
+//
+bool ChessBoard::givesCheck(const ChessMove &move) const
+{
+    int us = _side;
+    int king = kingSquare(us ^ 1);
+    int piece = move.promotion != NoPiece ? move.promotion : typeOf(_squares[move.from]);
+    uint64_t occupancy = (occupied() ^ (1ULL << move.from)) | (1ULL << move.to);
+    int rookFrom = -1, rookTo = -1;
+    if (piece == King && std::abs(move.to - move.from) == 2) {
+        rookFrom = move.to > move.from ? move.from + 3 : move.from - 4;
+        rookTo = move.to > move.from ? move.from + 1 : move.from - 1;
+        occupancy = (occupancy ^ (1ULL << rookFrom)) | (1ULL << rookTo);
+    }
+    if (piece == Pawn && move.to == _enPassant) {
+        occupancy ^= 1ULL << (move.to - (us == kWhite ? 8 : -8));
+    }
+
+    uint64_t kingBit = 1ULL << king;
+    switch (piece) {
+        case Pawn: if (kPawnAttacks[us][move.to] & kingBit) return true; break;
+        case Knight: if (KnightAttacks[move.to] & kingBit) return true; break;
+        case Bishop: if (getBishopAttacks(move.to, occupancy) & kingBit) return true; break;
+        case Rook: if (getRookAttacks(move.to, occupancy) & kingBit) return true; break;
+        case Queen: if (getQueenAttacks(move.to, occupancy) & kingBit) return true; break;
+        default: break;
+    }
+    if (rookTo >= 0 && (getRookAttacks(rookTo, occupancy) & kingBit)) {
+        return true;
+    }
+    // our sliders, less whatever the move took or replaced, seen from the king
+    uint64_t moved = (1ULL << move.from) | (1ULL << move.to);
+    uint64_t diagonal = (_pieces[us][Bishop] | _pieces[us][Queen]) & ~moved;
+    uint64_t straight = (_pieces[us][Rook] | _pieces[us][Queen]) & ~moved;
+    if (rookFrom >= 0) {
+        straight &= ~(1ULL << rookFrom);
+    }
+    return (getBishopAttacks(king, occupancy) & diagonal) || (getRookAttacks(king, occupancy) & straight);
+}
+
+void ChessBoard::make(const ChessMove &move, Undo &undo)
+{
+    int us = _side, them = us ^ 1;
+    int from = move.from, to = move.to;
+    int piece = typeOf(_squares[from]);
+    int taken = (piece == Pawn && to == _enPassant) ? to - (us == kWhite ? 8 : -8) : to;
+    int captured = _squares[taken];
+    undo = Undo{ _hash, (uint8_t)captured, (uint8_t)_castling, (int8_t)_enPassant, (uint8_t)std::min(_halfmoveClock, 255) };
+
+    if (_enPassant >= 0) {
+        _hash ^= kKeys[kEnPassantKeys + fileOf(_enPassant)];
+        _enPassant = -1;
+    }
+    if (captured) {
+        removePiece(them, typeOf(captured), taken);
+    }
+    movePiece(us, piece, from, to);
+    if (move.promotion != NoPiece) {
+        removePiece(us, Pawn, to);
+        addPiece(us, move.promotion, to);
+    }
+    if (piece == King && std::abs(to - from) == 2) {
+        if (to > from) {
+            movePiece(us, Rook, from + 3, from + 1);
+        } else {
+            movePiece(us, Rook, from - 4, from - 1);
+        }
+    }
+    int castling = _castling & kCastlingMasks[from] & kCastlingMasks[to];
+    if (castling != _castling) {
+        _hash ^= kKeys[kCastlingKeys + _castling] ^ kKeys[kCastlingKeys + castling];
+        _castling = castling;
+    }
+    if (piece == Pawn && std::abs(to - from) == 16) {
+        int square = (from + to) / 2;
+        if (kPawnAttacks[us][square] & _pieces[them][Pawn]) {
+            _enPassant = square;
+            _hash ^= kKeys[kEnPassantKeys + fileOf(square)];
+        }
+    }
+    _halfmoveClock = (piece == Pawn || captured) ? 0 : _halfmoveClock + 1;
+    if (us == kBlack) {
+        _fullmoveNumber++;
+    }
+    _side = them;
+    _hash ^= kKeys[kSideKey];
+}
+
+void ChessBoard::unmake(const ChessMove &move, const Undo &undo)
+{
+    _side ^= 1;
+    int us = _side, them = us ^ 1;
+    int from = move.from, to = move.to;
+    if (us == kBlack) {
+        _fullmoveNumber--;
+    }
+    int piece = typeOf(_squares[to]);
+    if (move.promotion != NoPiece) {
+        removePiece(us, move.promotion, to);
+        addPiece(us, Pawn, to);
+        piece = Pawn;
+    }
+    movePiece(us, piece, to, from);
+    if (piece == King && std::abs(to - from) == 2) {
+        if (to > from) {
+            movePiece(us, Rook, from + 1, from + 3);
+        } else {
+            movePiece(us, Rook, from - 1, from - 4);
+        }
+    }
+    if (undo.captured) {
+        int taken = (piece == Pawn && to == undo.enPassant) ? to - (us == kWhite ? 8 : -8) : to;
+        addPiece(them, typeOf(undo.captured), taken);
+    }
+    _castling = undo.castling;
+    _enPassant = undo.enPassant;
+    _halfmoveClock = undo.halfmoveClock;
+    _hash = undo.hash;
+}
+
+void ChessBoard::makeNull(Undo &undo)
+{
+    undo = Undo{ _hash, 0, (uint8_t)_castling, (int8_t)_enPassant, (uint8_t)std::min(_halfmoveClock, 255) };
+    if (_enPassant >= 0) {
+        _hash ^= kKeys[kEnPassantKeys + fileOf(_enPassant)];
+        _enPassant = -1;
+    }
+    _halfmoveClock++;
+    _side ^= 1;
+    _hash ^= kKeys[kSideKey];
+}
+
+void ChessBoard::unmakeNull(const Undo &undo)
+{
+    _side ^= 1;
+    _enPassant = undo.enPassant;
+    _halfmoveClock = undo.halfmoveClock;
+    _hash = undo.hash;
+}
+
+bool ChessBoard::insufficientMaterial() const
+{
+    for (int side = 0; side < 2; side++) {
+        if (_pieces[side][Pawn] | _pieces[side][Rook] | _pieces[side][Queen]) {
+            return false;
+        }
+    }
+    uint64_t minors = _pieces[kWhite][Knight] | _pieces[kWhite][Bishop] | _pieces[kBlack][Knight] | _pieces[kBlack][Bishop];
+    return std::popcount(minors) <= 1;
+}
+
+bool ChessBoard::parseMove(const std::string &text, ChessMove &move) const
+{
+    ChessMoveList list;
+    generateMoves(list);
+    for (const ChessMove &legal : list) {
+        if (legal.toString() == text) {
+            move = legal;
+            return true;
+        }
+    }
+    return false;
+}
+
+//
+// the piece, destination and promotion pick the move, any file or rank given before the
+// destination narrows it down. check marks, annotations and the capture x are ignored
+//
+bool ChessBoard::parseSAN(const std::string &text, ChessMove &move) const
+{
+    std::string san;
+    for (char character : text) {
+        if (!strchr("+#!?x", character)) {
+            san += character == '0' ? 'O' : character;
+        }
+    }
+
+    ChessMoveList list;
+    generateMoves(list);
+    if (san == "O-O" || san == "O-O-O") {
+        int king = kingSquare(_side);
+        int to = king + (san == "O-O" ? 2 : -2);
+        for (const ChessMove &legal : list) {
+            if (legal.from == king && legal.to == to && typeOf(_squares[king]) == King) {
+                move = legal;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int promotion = NoPiece;
+    std::size_t equals = san.find('=');
+    if (equals != std::string::npos) {
+        promotion = equals + 1 < san.length() ? pieceFromLetter(san[equals + 1]) : NoPiece;
+        san.erase(equals);
+    } else if (san.length() > 2 && isupper(san.back()) && strchr("NBRQ", san.back())) {
+        // "e8Q"
+        promotion = pieceFromLetter(san.back());
+        san.pop_back();
+    }
+    int piece = Pawn;
+    if (!san.empty() && strchr("NBRQK", san[0])) {
+        piece = pieceFromLetter(san[0]);
+        san.erase(0, 1);
+    }
+    if (san.length() < 2) {
+        return false;
+    }
+    int to = squareFromText(san.substr(san.length() - 2));
+    std::string from = san.substr(0, san.length() - 2);
+    if (to < 0 || from.length() > 2) {
+        return false;
+    }
+
+    int matches = 0;
+    for (const ChessMove &legal : list) {
+        if (legal.to != to || typeOf(_squares[legal.from]) != piece || legal.promotion != promotion) {
+            continue;
+        }
+        bool fits = true;
+        for (char hint : from) {
+            if (hint >= 'a' && hint <= 'h') {
+                fits = fits && fileOf(legal.from) == hint - 'a';
+            } else if (hint >= '1' && hint <= '8') {
+                fits = fits && rankOf(legal.from) == hint - '1';
+            } else {
+                fits = false;
+            }
+        }
+        if (fits) {
+            move = legal;
+            matches++;
+        }
+    }
+    return matches == 1;
+}
+
+std::string ChessBoard::toSAN(const ChessMove &move) const
+{
+    int piece = typeOf(_squares[move.from]);
+    std::string text;
+    if (piece == King && std::abs(move.to - move.from) == 2) {
+        text = move.to > move.from ? "O-O" : "O-O-O";
+    } else {
+        std::string destination = squareText(move.to);
+        bool capture = isCapture(move);
+        if (piece == Pawn) {
+            if (capture) {
+                text += (char)('a' + fileOf(move.from));
+                text += 'x';
+            }
+            text += destination;
+            if (move.promotion != NoPiece) {
+                text += '=';
+                text += (char)toupper(kPieceLetters[move.promotion]);
+            }
+        } else {
+            text += (char)toupper(kPieceLetters[piece]);
+            // the file if that tells the other candidates apart, else the rank, else both
+            ChessMoveList list;
+            generateMoves(list);
+            bool ambiguous = false, sameFile = false, sameRank = false;
+            for (const ChessMove &other : list) {
+                if (other.to == move.to && other.from != move.from && typeOf(_squares[other.from]) == piece) {
+                    ambiguous = true;
+                    sameFile = sameFile || fileOf(other.from) == fileOf(move.from);
+                    sameRank = sameRank || rankOf(other.from) == rankOf(move.from);
+                }
+            }
+            if (ambiguous && (!sameFile || sameRank)) {
+                text += (char)('a' + fileOf(move.from));
+            }
+            if (ambiguous && sameFile) {
+                text += (char)('1' + rankOf(move.from));
+            }
+            if (capture) {
+                text += 'x';
+            }
+            text += destination;
+        }
+    }
+
+    if (givesCheck(move)) {
+        ChessBoard after = *this;
+        Undo undo;
+        after.make(move, undo);
+        ChessMoveList replies;
+        after.generateMoves(replies);
+        text += replies.count == 0 ? '#' : '+';
+    }
+    return text;
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "Bitboard.h"
+#include <bit>
+#include <cstdint>
+#include <string>
+
+//
+// a chess move: the squares it goes from and to (0 = a1 .. 63 = h8, the grid's square index)
+// and the piece a pawn promotes to. castling is the king's two square move, captures and en
+// passant are read off the board when the move is made
+//
+struct ChessMove
+{
+    uint8_t from = 0;
+    uint8_t to = 0;
+    uint8_t promotion = NoPiece;
+
+    bool operator==(const ChessMove &other) const { return from == other.from && to == other.to && promotion == other.promotion; }
+    // long algebraic, "e2e4" or "e7e8q"
+    std::string toString() const;
+};
+
+struct ChessMoveList
+{
+    static const int kMaxMoves = 256;
+
+    ChessMove moves[kMaxMoves];
+    int count = 0;
+
+    ChessMove *begin() { return moves; }
+    ChessMove *end() { return moves + count; }
+    const ChessMove *begin() const { return moves; }
+    const ChessMove *end() const { return moves + count; }
+    void add(int from, int to, int promotion = NoPiece) { moves[count++] = ChessMove{ (uint8_t)from, (uint8_t)to, (uint8_t)promotion }; }
+};
+
+//
+// a position in 32 bytes, for keeping millions of them in memory or on disk: the occupied
+// squares, then a nibble per occupied square from a1 up holding its piece | side << 3
+//
+struct PackedChessBoard
+{
+    uint64_t occupancy;
+    uint8_t pieces[16];
+    uint8_t sideToMove;
+    uint8_t castling;
+    int8_t enPassant;
+    // capped at 255
+    uint8_t halfmoveClock;
+    uint32_t fullmoveNumber;
+};
+
+//
+// bitboard chess position with a square by square copy alongside, make and unmake, strictly
+// legal move generation and an incrementally kept zobrist hash. pieces are indexed by
+// ChessPiece, white is side 0 and moves up the board
+//
+class ChessBoard
+{
+public:
+    static const int kWhite = 0;
+    static const int kBlack = 1;
+
+    // castling rights
+    static const int kWhiteKingside = 1;
+    static const int kWhiteQueenside = 2;
+    static const int kBlackKingside = 4;
+    static const int kBlackQueenside = 8;
+
+    static constexpr const char *kStartFEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    // what make overwrites, handed back to unmake
+    struct Undo
+    {
+        uint64_t hash;
+        uint8_t captured;
+        uint8_t castling;
+        int8_t enPassant;
+        uint8_t halfmoveClock;
+    };
+
+    // an empty board, white to move
+    ChessBoard();
+
+    static ChessBoard startPosition();
+
+    // false, leaving the board alone, for a FEN that can't be read
+    bool setFEN(const std::string &fen);
+    std::string fen() const;
+
+    // the Chess game's state string: a piece letter per square from a1 to h8 ('0' for empty)
+    // followed by the rest of a FEN, side to move, castling, en passant and the clocks
+    bool setState(const std::string &state);
+    std::string stateString() const;
+
+    PackedChessBoard pack() const;
+    // false, leaving the board alone, for bytes that aren't a position
+    bool unpack(const PackedChessBoard &packed);
+
+    uint64_t pieces(int side, int piece) const { return _pieces[side][piece]; }
+    uint64_t occupied(int side) const { return _occupied[side]; }
+    uint64_t occupied() const { return _occupied[kWhite] | _occupied[kBlack]; }
+    // 0 for an empty square, otherwise the piece | side << 3
+    int pieceAt(int square) const { return _squares[square]; }
+    static int typeOf(int code) { return code & 7; }
+    static int sideOf(int code) { return code >> 3; }
+
+    int sideToMove() const { return _side; }
+    int castling() const { return _castling; }
+    // the square a pawn can take en passant on, -1 for none
+    int enPassant() const { return _enPassant; }
+    int halfmoveClock() const { return _halfmoveClock; }
+    int fullmoveNumber() const { return _fullmoveNumber; }
+    uint64_t hash() const { return _hash; }
+    int kingSquare(int side) const { return std::countr_zero(_pieces[side][King]); }
+
+    // pieces of either side attacking square, sliders seeing through anything not in occupancy
+    uint64_t attackersTo(int square, uint64_t occupancy) const;
+    bool isAttacked(int square, int bySide) const { return (attackersTo(square, occupied()) & _occupied[bySide]) != 0; }
+    uint64_t checkers() const { return attackersTo(kingSquare(_side), occupied()) & _occupied[_side ^ 1]; }
+    bool inCheck() const { return checkers() != 0; }
+
+    // the legal moves for the side to move
+    void generateMoves(ChessMoveList &list) const;
+    // what quiescence looks at: legal captures and queen promotions, or every evasion in check
+    void generateCaptures(ChessMoveList &list) const;
+    // the legal moves that check the other side, what a mate solver's attacker plays
+    void generateChecks(ChessMoveList &list) const;
+    bool isCapture(const ChessMove &move) const;
+    // does the move, which must be legal, check the other side
+    bool givesCheck(const ChessMove &move) const;
+
+    void make(const ChessMove &move, Undo &undo);
+    void unmake(const ChessMove &move, const Undo &undo);
+    // pass the turn, for null move pruning
+    void makeNull(Undo &undo);
+    void unmakeNull(const Undo &undo);
+
+    // neither side has the material left to mate
+    bool insufficientMaterial() const;
+    // a legal move from its long algebraic text
+    bool parseMove(const std::string &text, ChessMove &move) const;
+    // a legal move from standard algebraic notation, "Nbd7", "exd6", "e8=Q+" or "O-O"
+    bool parseSAN(const std::string &text, ChessMove &move) const;
+    // standard algebraic notation for a legal move, with + or # for check and mate
+    std::string toSAN(const ChessMove &move) const;
+
+    // squares a pawn of side on square attacks
+    static uint64_t pawnAttacks(int side, int square);
+    static uint64_t knightAttacks(int square);
+    static uint64_t kingAttacks(int square);
+    static uint64_t bishopAttacks(int square, uint64_t occupancy);
+    static uint64_t rookAttacks(int square, uint64_t occupancy);
+    // squares strictly between two squares on a line, 0 when they don't share one
+    static uint64_t between(int from, int to);
+    // the whole line through two squares, 0 when they don't share one
+    static uint64_t line(int from, int to);
+
+    static int fileOf(int square) { return square & 7; }
+    static int rankOf(int square) { return square >> 3; }
+
+private:
+    void generate(ChessMoveList &list, bool capturesOnly) const;
+    // pieces of side that can't leave the line between their king and an enemy slider
+    uint64_t pinned(int side) const;
+
+    void addPiece(int side, int piece, int square);
+    void removePiece(int side, int piece, int square);
+    void movePiece(int side, int piece, int from, int to);
+    void clear();
+    void computeHash();
+
+    uint64_t _pieces[2][King + 1];
+    uint64_t _occupied[2];
+    uint8_t _squares[64];
+    int _side;
+    int _castling;
+    int _enPassant;
+    int _halfmoveClock;
+    int _fullmoveNumber;
+    uint64_t _hash;
+};
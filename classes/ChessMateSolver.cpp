@@ -0,0 +1,213 @@
+#include "ChessMateSolver.h"
+#include <algorithm>
+
+namespace {
+    // a proof or disproof number that can't be met, the node is solved the other way
+    const uint32_t kInfinite = 1u << 30;
+
+    uint32_t saturatingAdd(uint32_t a, uint32_t b)
+    {
+        return std::min<uint64_t>((uint64_t)a + b, kInfinite);
+    }
+
+    bool solved(uint32_t phi, uint32_t delta)
+    {
+        return phi == 0 || delta == 0;
+    }
+}
+
+ChessMateSolver::ChessMateSolver(size_t tableEntries)
+{
+    size_t size = 2;
+    while (size * 2 <= tableEntries) {
+        size *= 2;
+    }
+    _table.resize(size);
+    clear();
+    _nodes = 0;
+    _nodeLimit = 0;
+    _aborted = false;
+}
+
+void ChessMateSolver::clear()
+{
+    std::fill(_table.begin(), _table.end(), Entry{ 0, { 1, 1 } });
+}
+
+ChessMateSolver::Result ChessMateSolver::solve(const ChessBoard &board, int maxMoves, uint64_t nodeLimit)
+{
+    Result result;
+    _board = board;
+    _nodes = 0;
+    _nodeLimit = nodeLimit;
+    _aborted = false;
+
+    // one move deeper at a time, so the first mate found is the shortest
+    for (int moves = 1; moves <= maxMoves && !_aborted; moves++) {
+        if (proven(2 * moves - 1)) {
+            result.found = true;
+            result.moves = moves;
+            // the line is read back without a limit, the proof is already in the table
+            _nodeLimit = 0;
+            extractLine(2 * moves - 1, result.line);
+            break;
+        }
+    }
+    result.nodes = _nodes;
+    result.aborted = !result.found && _aborted;
+    return result;
+}
+
+//
+// the attacker moves with an odd number of plies left and the defender with an even number,
+// a defender still standing at 0 has escaped
+//
+void ChessMateSolver::mid(int remaining, uint32_t thresholdPhi, uint32_t thresholdDelta)
+{
+    _nodes++;
+    if (_nodeLimit != 0 && _nodes >= _nodeLimit) {
+        _aborted = true;
+        return;
+    }
+
+    uint64_t key = keyFor(_board.hash(), remaining);
+    bool attacker = remaining & 1;
+    ChessMoveList moves;
+    if (attacker) {
+        _board.generateChecks(moves);
+    } else {
+        _board.generateMoves(moves);
+    }
+    if (moves.count == 0) {
+        // an attacker out of checks has failed, a defender out of moves is mated unless it's stalemate
+        bool stalemate = !attacker && !_board.inCheck();
+        store(key, stalemate ? Numbers{ 0, kInfinite } : Numbers{ kInfinite, 0 });
+        return;
+    }
+    if (remaining == 0) {
+        store(key, Numbers{ 0, kInfinite });
+        return;
+    }
+
+    uint64_t childKeys[ChessMoveList::kMaxMoves];
+    for (int i = 0; i < moves.count; i++) {
+        ChessBoard::Undo undo;
+        _board.make(moves.moves[i], undo);
+        childKeys[i] = keyFor(_board.hash(), remaining - 1);
+        _board.unmake(moves.moves[i], undo);
+    }
+
+    while (true) {
+        // phi is the smallest child delta, delta the sum of the child phis
+        uint32_t phi = kInfinite, secondPhi = kInfinite, delta = 0, bestChildPhi = 0;
+        int best = 0;
+        for (int i = 0; i < moves.count; i++) {
+            Numbers child = lookup(childKeys[i]);
+            delta = saturatingAdd(delta, child.phi);
+            if (child.delta < phi) {
+                secondPhi = phi;
+                phi = child.delta;
+                bestChildPhi = child.phi;
+                best = i;
+            } else if (child.delta < secondPhi) {
+                secondPhi = child.delta;
+            }
+        }
+        if (phi >= thresholdPhi || delta >= thresholdDelta || _aborted) {
+            store(key, Numbers{ phi, delta });
+            return;
+        }
+
+        // the best child may grow until it's no longer best, or until the node's delta passes its threshold
+        uint32_t childPhi = std::min<uint64_t>((uint64_t)thresholdDelta + bestChildPhi - delta, kInfinite);
+        uint32_t childDelta = std::min(thresholdPhi, saturatingAdd(secondPhi, 1));
+        ChessBoard::Undo undo;
+        _board.make(moves.moves[best], undo);
+        mid(remaining - 1, childPhi, childDelta);
+        _board.unmake(moves.moves[best], undo);
+    }
+}
+
+bool ChessMateSolver::proven(int remaining)
+{
+    uint64_t key = keyFor(_board.hash(), remaining);
+    Numbers numbers = lookup(key);
+    if (!solved(numbers.phi, numbers.delta)) {
+        mid(remaining, kInfinite, kInfinite);
+        numbers = lookup(key);
+    }
+    return (remaining & 1) ? numbers.phi == 0 : numbers.delta == 0;
+}
+
+int ChessMateSolver::shortestMate(int remaining)
+{
+    for (int plies = remaining & 1; plies <= remaining; plies += 2) {
+        if (proven(plies)) {
+            return plies;
+        }
+    }
+    return -1;
+}
+
+//
+// follows the proof: the attacker's quickest mate against the defender's longest defence
+//
+void ChessMateSolver::extractLine(int remaining, std::vector<ChessMove> &line)
+{
+    bool attacker = remaining & 1;
+    ChessMoveList moves;
+    if (attacker) {
+        _board.generateChecks(moves);
+    } else {
+        _board.generateMoves(moves);
+    }
+    if (remaining == 0 || moves.count == 0) {
+        return;
+    }
+
+    int best = -1, bestRemaining = 0;
+    for (int i = 0; i < moves.count; i++) {
+        ChessBoard::Undo undo;
+        _board.make(moves.moves[i], undo);
+        int plies = shortestMate(remaining - 1);
+        _board.unmake(moves.moves[i], undo);
+        if (plies >= 0 && (best < 0 || (attacker ? plies < bestRemaining : plies > bestRemaining))) {
+            best = i;
+            bestRemaining = plies;
+        }
+    }
+    if (best < 0) {
+        return;
+    }
+
+    ChessBoard::Undo undo;
+    line.push_back(moves.moves[best]);
+    _board.make(moves.moves[best], undo);
+    extractLine(bestRemaining, line);
+    _board.unmake(moves.moves[best], undo);
+}
+
+//
+// two entry buckets: a key's own entry is updated in place, otherwise an unsolved entry makes
+// way before a solved one, so proofs survive the churn of the nodes still being worked on
+//
+ChessMateSolver::Numbers ChessMateSolver::lookup(uint64_t key) const
+{
+    size_t index = key & (_table.size() - 2);
+    for (size_t i = index; i < index + 2; i++) {
+        if (_table[i].key == key) {
+            return _table[i].numbers;
+        }
+    }
+    return Numbers{ 1, 1 };
+}
+
+void ChessMateSolver::store(uint64_t key, Numbers numbers)
+{
+    size_t index = key & (_table.size() - 2);
+    Entry *slot = &_table[index + 1];
+    if (_table[index].key == key || (_table[index + 1].key != key && !solved(_table[index].numbers.phi, _table[index].numbers.delta))) {
+        slot = &_table[index];
+    }
+    *slot = Entry{ key, numbers };
+}
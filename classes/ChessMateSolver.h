@@ -0,0 +1,67 @@
+#pragma once
+
+#include "ChessBoard.h"
+#include <vector>
+
+//
+// mate in N solver: depth first proof number search over ChessBoard. the attacker, the side to
+// move at the root, only plays checks and the defender plays every evasion, so the tree stays
+// narrow enough for puzzle batches. proof and disproof numbers live in the solver's own table,
+// keyed by position and plies left
+//
+class ChessMateSolver
+{
+public:
+    struct Result
+    {
+        bool found = false;
+        // attacker moves in the shortest mate
+        int moves = 0;
+        // attacker and defender moves to the mate, the defender holding out longest
+        std::vector<ChessMove> line;
+        uint64_t nodes = 0;
+        // the node limit ran out first, so no mate found doesn't mean there is none
+        bool aborted = false;
+    };
+
+    ChessMateSolver(size_t tableEntries = 1 << 20);
+
+    // the shortest mate in at most maxMoves for the side to move, giving up after nodeLimit
+    // nodes (0 for no limit)
+    Result solve(const ChessBoard &board, int maxMoves, uint64_t nodeLimit = 0);
+
+    // forget every proof, the table is kept between solves otherwise
+    void clear();
+
+private:
+    // proof and disproof numbers from the side to move's point of view: phi is 0 once it's
+    // shown to win, delta once it's shown to lose
+    struct Numbers
+    {
+        uint32_t phi;
+        uint32_t delta;
+    };
+    struct Entry
+    {
+        uint64_t key;
+        Numbers numbers;
+    };
+
+    // expands the node at _board until its numbers reach either threshold
+    void mid(int remaining, uint32_t thresholdPhi, uint32_t thresholdDelta);
+    // does the attacker mate from _board with remaining plies left
+    bool proven(int remaining);
+    // fewest plies, of remaining's parity, the attacker mates in from _board, -1 for none
+    int shortestMate(int remaining);
+    void extractLine(int remaining, std::vector<ChessMove> &line);
+
+    static uint64_t keyFor(uint64_t hash, int remaining) { return hash ^ (uint64_t)remaining * 0x9e3779b97f4a7c15ull; }
+    Numbers lookup(uint64_t key) const;
+    void store(uint64_t key, Numbers numbers);
+
+    std::vector<Entry> _table;
+    ChessBoard _board;
+    uint64_t _nodes;
+    uint64_t _nodeLimit;
+    bool _aborted;
+};
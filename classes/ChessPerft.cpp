@@ -0,0 +1,108 @@
+#include "ChessPerft.h"
+#include "ThreadPool.h"
+#include <future>
+
+ChessPerft::ChessPerft(size_t cacheEntries) : _cacheSize(0)
+{
+    if (cacheEntries > 0) {
+        _cacheSize = 1;
+        while (_cacheSize * 2 <= cacheEntries) {
+            _cacheSize *= 2;
+        }
+        _cache.reset(new Entry[_cacheSize]);
+        clearCache();
+    }
+}
+
+void ChessPerft::clearCache()
+{
+    for (size_t i = 0; i < _cacheSize; i++) {
+        _cache[i].check.store(0, std::memory_order_relaxed);
+        _cache[i].nodes.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t ChessPerft::count(const ChessBoard &board, int depth, ThreadPool &pool)
+{
+    // the board itself is the one leaf, where divide has no root moves to split it by
+    if (depth <= 0) {
+        return 1;
+    }
+    uint64_t nodes = 0;
+    for (const Division &division : divide(board, depth, pool)) {
+        nodes += division.nodes;
+    }
+    return nodes;
+}
+
+//
+// one job per root move, each on its own copy of the board. the first moves take longest, the
+// queue hands them out in order so the quick ones fill in behind
+//
+std::vector<ChessPerft::Division> ChessPerft::divide(const ChessBoard &board, int depth, ThreadPool &pool)
+{
+    std::vector<Division> divisions;
+    if (depth <= 0) {
+        return divisions;
+    }
+    ChessMoveList moves;
+    board.generateMoves(moves);
+
+    std::vector<std::future<uint64_t>> counts;
+    for (const ChessMove &move : moves) {
+        counts.push_back(pool.submit([this, board, move, depth]() {
+            ChessBoard child = board;
+            ChessBoard::Undo undo;
+            child.make(move, undo);
+            return depth == 1 ? 1 : perft(child, depth - 1);
+        }));
+    }
+    for (int i = 0; i < moves.count; i++) {
+        divisions.push_back(Division{ moves.moves[i], counts[i].get() });
+    }
+    return divisions;
+}
+
+uint64_t ChessPerft::perft(ChessBoard &board, int depth)
+{
+    ChessMoveList moves;
+    board.generateMoves(moves);
+    // the moves themselves are the leaves, nothing to make
+    if (depth == 1) {
+        return moves.count;
+    }
+
+    uint64_t key = keyFor(board.hash(), depth);
+    uint64_t nodes = 0;
+    if (_cacheSize > 0 && probe(key, nodes)) {
+        return nodes;
+    }
+    for (const ChessMove &move : moves) {
+        ChessBoard::Undo undo;
+        board.make(move, undo);
+        nodes += perft(board, depth - 1);
+        board.unmake(move, undo);
+    }
+    if (_cacheSize > 0) {
+        store(key, nodes);
+    }
+    return nodes;
+}
+
+bool ChessPerft::probe(uint64_t key, uint64_t &nodes) const
+{
+    const Entry &entry = _cache[key & (_cacheSize - 1)];
+    uint64_t stored = entry.nodes.load(std::memory_order_relaxed);
+    if ((entry.check.load(std::memory_order_relaxed) ^ stored) != key) {
+        return false;
+    }
+    nodes = stored;
+    return true;
+}
+
+void ChessPerft::store(uint64_t key, uint64_t nodes)
+{
+    Entry &entry = _cache[key & (_cacheSize - 1)];
+    entry.check.store(key ^ nodes, std::memory_order_relaxed);
+    entry.nodes.store(nodes, std::memory_order_relaxed);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ChessBoard.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class ThreadPool;
+
+//
+// perft, the leaf count of the legal move tree, for validating ChessBoard's move generation.
+// root moves are counted in parallel on a thread pool, and an optional cache keyed by position
+// and depth, shared by every thread, counts each transposition once
+//
+class ChessPerft
+{
+public:
+    struct Division
+    {
+        ChessMove move;
+        uint64_t nodes;
+    };
+
+    // 0 entries for no cache
+    ChessPerft(size_t cacheEntries = 0);
+
+    // leaf nodes depth plies below board, 1 at depth 0
+    uint64_t count(const ChessBoard &board, int depth, ThreadPool &pool);
+    // the same count split by root move, in move generation order, empty at depth 0
+    std::vector<Division> divide(const ChessBoard &board, int depth, ThreadPool &pool);
+
+    // cache entries actually allocated, a power of two
+    size_t cacheSize() const { return _cacheSize; }
+    void clearCache();
+
+private:
+    // the node count is stored next to the key xored with it, so an entry torn by two threads
+    // writing at once reads as a miss rather than a wrong count
+    struct Entry
+    {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> nodes;
+    };
+
+    uint64_t perft(ChessBoard &board, int depth);
+
+    static uint64_t keyFor(uint64_t hash, int depth) { return hash ^ (uint64_t)depth * 0x9e3779b97f4a7c15ull; }
+    bool probe(uint64_t key, uint64_t &nodes) const;
+    void store(uint64_t key, uint64_t nodes);
+
+    std::unique_ptr<Entry[]> _cache;
+    size_t _cacheSize;
+};
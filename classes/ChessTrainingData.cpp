@@ -0,0 +1,194 @@
+#include "ChessTrainingData.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    const char kMagic[4] = { 'C', 'T', 'D', '1' };
+    // start, result and ply count
+    const size_t kGameHeaderBytes = 32 + 1 + 2;
+    const size_t kPlyBytes = 3;
+
+    void put(std::string &bytes, uint64_t value, int size)
+    {
+        for (int i = 0; i < size; i++) {
+            bytes += (char)(value >> (8 * i) & 0xff);
+        }
+    }
+
+    uint64_t get(const uint8_t *bytes, int size)
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < size; i++) {
+            value |= (uint64_t)bytes[i] << (8 * i);
+        }
+        return value;
+    }
+
+    void putBoard(std::string &bytes, const PackedChessBoard &packed)
+    {
+        put(bytes, packed.occupancy, 8);
+        bytes.append((const char *)packed.pieces, sizeof(packed.pieces));
+        put(bytes, packed.sideToMove, 1);
+        put(bytes, packed.castling, 1);
+        put(bytes, (uint8_t)packed.enPassant, 1);
+        put(bytes, packed.halfmoveClock, 1);
+        put(bytes, packed.fullmoveNumber, 4);
+    }
+
+    PackedChessBoard getBoard(const uint8_t *bytes)
+    {
+        PackedChessBoard packed{};
+        packed.occupancy = get(bytes, 8);
+        std::memcpy(packed.pieces, bytes + 8, sizeof(packed.pieces));
+        packed.sideToMove = bytes[24];
+        packed.castling = bytes[25];
+        packed.enPassant = (int8_t)bytes[26];
+        packed.halfmoveClock = bytes[27];
+        packed.fullmoveNumber = (uint32_t)get(bytes + 28, 4);
+        return packed;
+    }
+}
+
+ChessTrainingWriter::ChessTrainingWriter(const std::string &prefix, int gamesPerFile)
+    : _prefix(prefix), _gamesPerFile(std::max(gamesPerFile, 1)), _gamesInFile(0), _files(0), _bytes(0), _failed(false)
+{
+}
+
+std::string ChessTrainingWriter::fileName(const std::string &prefix, int index)
+{
+    char number[16];
+    std::snprintf(number, sizeof(number), "_%04d.bin", index);
+    return prefix + number;
+}
+
+bool ChessTrainingWriter::write(const ChessTrainingGame &game)
+{
+    if (game.plies.size() > 0xffff) {
+        return false;
+    }
+    std::string bytes;
+    putBoard(bytes, game.start.pack());
+    put(bytes, (uint8_t)game.result, 1);
+    put(bytes, (uint16_t)game.plies.size(), 2);
+    ChessBoard board = game.start;
+    for (const ChessTrainingGame::Ply &ply : game.plies) {
+        ChessMoveList list;
+        board.generateMoves(list);
+        int index = 0;
+        while (index < list.count && !(list.moves[index] == ply.move)) {
+            index++;
+        }
+        if (index == list.count) {
+            return false;
+        }
+        put(bytes, (uint8_t)index, 1);
+        int score = ply.score == ChessTrainingGame::kNoScore ? ply.score : std::clamp(ply.score, -ChessTrainingGame::kMaxScore, ChessTrainingGame::kMaxScore);
+        put(bytes, (uint16_t)(int16_t)score, 2);
+        ChessBoard::Undo undo;
+        board.make(ply.move, undo);
+    }
+
+    if (!_file.is_open() || _gamesInFile == _gamesPerFile) {
+        if (!close()) {
+            return false;
+        }
+        _file.open(fileName(_prefix, _files), std::ios::binary);
+        if (!_file) {
+            _failed = true;
+            return false;
+        }
+        _file.write(kMagic, sizeof(kMagic));
+        _bytes += sizeof(kMagic);
+        _files++;
+        _gamesInFile = 0;
+    }
+    _file.write(bytes.data(), (std::streamsize)bytes.size());
+    _bytes += bytes.size();
+    _gamesInFile++;
+    _failed = _failed || !_file;
+    return !_failed;
+}
+
+bool ChessTrainingWriter::close()
+{
+    if (_file.is_open()) {
+        _file.close();
+        _failed = _failed || !_file;
+    }
+    return !_failed;
+}
+
+bool ChessTrainingReader::open(const std::string &path)
+{
+    _file.close();
+    _file.clear();
+    _file.open(path, std::ios::binary);
+    char magic[sizeof(kMagic)];
+    _failed = false;
+    _game = ChessTrainingGame();
+    _ply = 0;
+    return _file.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool ChessTrainingReader::nextGame(ChessTrainingGame &game)
+{
+    uint8_t header[kGameHeaderBytes];
+    _file.read((char *)header, sizeof(header));
+    if (_file.gcount() == 0) {
+        return false;
+    }
+    if (_file.gcount() != (std::streamsize)sizeof(header) || !game.start.unpack(getBoard(header)) || header[32] > 2) {
+        _failed = true;
+        return false;
+    }
+    game.result = header[32];
+    size_t plyCount = (size_t)get(header + 33, 2);
+    std::vector<uint8_t> bytes(plyCount * kPlyBytes);
+    if (!_file.read((char *)bytes.data(), (std::streamsize)bytes.size())) {
+        _failed = true;
+        return false;
+    }
+
+    game.plies.resize(plyCount);
+    ChessBoard board = game.start;
+    for (size_t i = 0; i < plyCount; i++) {
+        const uint8_t *ply = bytes.data() + i * kPlyBytes;
+        ChessMoveList list;
+        board.generateMoves(list);
+        if (ply[0] >= list.count) {
+            _failed = true;
+            return false;
+        }
+        game.plies[i].move = list.moves[ply[0]];
+        game.plies[i].score = (int16_t)get(ply + 1, 2);
+        ChessBoard::Undo undo;
+        board.make(game.plies[i].move, undo);
+    }
+    return true;
+}
+
+bool ChessTrainingReader::next(ChessTrainingPosition &position)
+{
+    while (true) {
+        while (_ply < _game.plies.size()) {
+            const ChessTrainingGame::Ply &ply = _game.plies[_ply++];
+            bool scored = ply.score != ChessTrainingGame::kNoScore;
+            if (scored) {
+                position.board = _board;
+                position.score = ply.score;
+                position.result = _game.result;
+            }
+            ChessBoard::Undo undo;
+            _board.make(ply.move, undo);
+            if (scored) {
+                return true;
+            }
+        }
+        if (!nextGame(_game)) {
+            return false;
+        }
+        _board = _game.start;
+        _ply = 0;
+    }
+}
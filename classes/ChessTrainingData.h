@@ -0,0 +1,100 @@
+#pragma once
+
+#include "ChessBoard.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+//
+// a self-play game as training data: where it started, each move with the search's score for
+// the position it was played from, and how the game ended
+//
+struct ChessTrainingGame
+{
+    // a position not to train on, such as one from the random opening or one in check
+    static constexpr int kNoScore = -32768;
+    // scores are kept in 16 bits, so mates come down to this
+    static constexpr int kMaxScore = 32000;
+
+    struct Ply
+    {
+        ChessMove move;
+        // for the side to move
+        int score = kNoScore;
+    };
+
+    ChessBoard start;
+    // white's result: 0 lost, 1 drawn, 2 won
+    int result = 1;
+    std::vector<Ply> plies;
+};
+
+// one scored position out of a game
+struct ChessTrainingPosition
+{
+    ChessBoard board;
+    // for the side to move
+    int score = 0;
+    // white's result: 0 lost, 1 drawn, 2 won
+    int result = 1;
+};
+
+//
+// the binary format: a file is "CTD1" then games back to back. a game is its start as a packed
+// board, a result byte and a 16 bit ply count, then 3 bytes a ply, the move's index in the legal
+// moves as generateMoves orders them and a 16 bit score. numbers are little endian. a position
+// costs a little over 3 bytes where a FEN takes 60 or so, and reads back by playing the moves
+// rather than parsing text. the move order is part of the format, so changing generateMoves
+// means a new magic
+//
+class ChessTrainingWriter
+{
+public:
+    // writes prefix_0000.bin, prefix_0001.bin and so on, a new file every gamesPerFile games
+    ChessTrainingWriter(const std::string &prefix, int gamesPerFile);
+
+    // false if the file can't be written or a move isn't legal where it's played
+    bool write(const ChessTrainingGame &game);
+    // false if anything failed to write
+    bool close();
+
+    int files() const { return _files; }
+    uint64_t bytes() const { return _bytes; }
+
+    static std::string fileName(const std::string &prefix, int index);
+
+private:
+    std::string _prefix;
+    int _gamesPerFile;
+    int _gamesInFile;
+    int _files;
+    uint64_t _bytes;
+    bool _failed;
+    std::ofstream _file;
+};
+
+//
+// streams a file back a game at a time, so files of any size read in constant memory
+//
+class ChessTrainingReader
+{
+public:
+    // false if the file can't be read or isn't in the format
+    bool open(const std::string &path);
+
+    // false at the end of the file, or at a game that's cut short or doesn't replay
+    bool nextGame(ChessTrainingGame &game);
+    // the next scored position, moving through the games as each one runs out
+    bool next(ChessTrainingPosition &position);
+    // reading stopped short of the end of the file
+    bool failed() const { return _failed; }
+
+private:
+    std::ifstream _file;
+    bool _failed = false;
+    // the game next() is in, and its board before plies[_ply]
+    ChessTrainingGame _game;
+    ChessBoard _board;
+    size_t _ply = 0;
+};
@@ -1,10 +1,27 @@
 #include "Connect4.h"
+#include "BitPool.h"
+#include "Connect4Book.h"
 #include <limits>
 #include <cmath>
+#include <bit>
+
+// how long the AI may think about a move
+static const int kAIThinkTimeMs = 1000;
+
+// the grid's row 0 is the top row, the bitboards count rows from the bottom
+static int cellForSquare(int col, int row)
+{
+    return Connect4Board::cellIndex(col, CONNECT4_ROWS - 1 - row);
+}
 
 Connect4::Connect4()
 {
     _grid = new Grid(CONNECT4_COLS, CONNECT4_ROWS);
+    _stones[0] = 0;
+    _stones[1] = 0;
+    // depth of the fallback search when the position can't be solved in time
+    _gameOptions.AIMAXDepth = 12;
+    _solver.setBook(&Connect4Book::sharedBook());
 }
 
 Connect4::~Connect4()
@@ -14,10 +31,7 @@ Connect4::~Connect4()
 
 Bit* Connect4::PieceForPlayer(const int playerNumber)
 {
-    Bit *bit = new Bit();
-    bit->LoadTextureFromFile(playerNumber == AI_PLAYER ? "yellow.png" : "red.png");
-    bit->setOwner(getPlayerAt(playerNumber == AI_PLAYER ? 1 : 0));
-    return bit;
+    return BitPool::sharedPool().acquire(getPlayerAt(playerNumber == AI_PLAYER ? 1 : 0), playerNumber == AI_PLAYER ? "yellow.png" : "red.png");
 }
 
 void Connect4::setUpBoard()
@@ -27,6 +41,12 @@ void Connect4::setUpBoard()
     _gameOptions.rowY = CONNECT4_ROWS;
 
     _grid->initializeSquares(80, "square.png");
+    _stones[0] = 0;
+    _stones[1] = 0;
+
+    if (gameHasAI()) {
+        setAIPlayer(AI_PLAYER);
+    }
 
     startGame();
 }
@@ -53,8 +73,10 @@ bool Connect4::actionForEmptyHolder(BitHolder &holder)
         return false;
     }
 
-    Bit *bit = PieceForPlayer(getCurrentPlayer()->playerNumber() == 0 ? HUMAN_PLAYER : AI_PLAYER);
+    int playerNumber = getCurrentPlayer()->playerNumber();
+    Bit *bit = PieceForPlayer(playerNumber == 0 ? HUMAN_PLAYER : AI_PLAYER);
     if (bit) {
+        _stones[playerNumber] |= 1ULL << cellForSquare(col, targetRow);
         ChessSquare* topSquare = _grid->getSquare(col, 0);
         ChessSquare* targetSquare = _grid->getSquare(col, targetRow);
 
@@ -75,19 +97,13 @@ bool Connect4::actionForEmptyHolder(BitHolder &holder)
 
 int Connect4::getLowestEmptyRow(int col)
 {
-    for (int row = CONNECT4_ROWS - 1; row >= 0; row--) {
-        ChessSquare* square = _grid->getSquare(col, row);
-        if (square && !square->bit()) {
-            return row;
-        }
-    }
-    return -1;
+    int height = std::popcount((_stones[0] | _stones[1]) & Connect4Board::columnMask(col));
+    return height < CONNECT4_ROWS ? CONNECT4_ROWS - 1 - height : -1;
 }
 
 bool Connect4::isColumnFull(int col)
 {
-    ChessSquare* topSquare = _grid->getSquare(col, 0);
-    return topSquare && topSquare->bit() != nullptr;
+    return ((_stones[0] | _stones[1]) & Connect4Board::topMask(col)) != 0;
 }
 
 bool Connect4::canBitMoveFrom(Bit &bit, BitHolder &src)
@@ -105,66 +121,16 @@ void Connect4::stopGame()
     _grid->forEachSquare([](ChessSquare* square, int x, int y) {
         square->destroyBit();
     });
+    _stones[0] = 0;
+    _stones[1] = 0;
 }
 
-Player* Connect4::ownerAt(int x, int y) const
-{
-    if (x < 0 || x >= CONNECT4_COLS || y < 0 || y >= CONNECT4_ROWS) {
-        return nullptr;
-    }
-
-    auto square = _grid->getSquare(x, y);
-    if (!square || !square->bit()) {
-        return nullptr;
-    }
-    return square->bit()->getOwner();
-}
-
-// Searches in a specific direction (dx, dy) from a starting point (startX, startY)
-// to check if there are 4 consecutive pieces belonging to the same player.
-bool Connect4::checkDirection(int startX, int startY, int dx, int dy, Player* player)
-{
-    int count = 0;
-    for (int i = 0; i < 4; i++) {
-        int x = startX + i * dx;
-        int y = startY + i * dy;
-
-        if (ownerAt(x, y) == player) {
-            count++;
-        } else {
-            break;
-        }
-    }
-    return count >= 4;
-}
-
-// Checks for a Connect 4 winner by examining all possible 4-in-a-row combinations:
-// horizontal, vertical, and both diagonal directions.
-
+// four in a row, found by shifting each player's bitboard along the four directions
 Player* Connect4::checkForWinner()
 {
-    for (int y = 0; y < CONNECT4_ROWS; y++) {
-        for (int x = 0; x < CONNECT4_COLS; x++) {
-            Player* player = ownerAt(x, y);
-            if (player) {
-                if (x <= CONNECT4_COLS - 4 && checkDirection(x, y, 1, 0, player)) {
-                    return player;
-                }
-
-                if (y <= CONNECT4_ROWS - 4 && checkDirection(x, y, 0, 1, player)) {
-                    return player;
-                }
-
-                if (x <= CONNECT4_COLS - 4 && y <= CONNECT4_ROWS - 4 &&
-                    checkDirection(x, y, 1, 1, player)) {
-                    return player;
-                }
-
-                if (x >= 3 && y <= CONNECT4_ROWS - 4 &&
-                    checkDirection(x, y, -1, 1, player)) {
-                    return player;
-                }
-            }
+    for (int playerNumber = 0; playerNumber < 2; playerNumber++) {
+        if (Connect4Board::hasFour(_stones[playerNumber])) {
+            return getPlayerAt(playerNumber);
         }
     }
     return nullptr;
@@ -172,12 +138,7 @@ Player* Connect4::checkForWinner()
 
 bool Connect4::checkForDraw()
 {
-    for (int x = 0; x < CONNECT4_COLS; x++) {
-        if (!isColumnFull(x)) {
-            return false;
-        }
-    }
-    return true;
+    return std::popcount(_stones[0] | _stones[1]) == CONNECT4_COLS * CONNECT4_ROWS && !checkForWinner();
 }
 
 std::string Connect4::initialStateString()
@@ -188,12 +149,12 @@ std::string Connect4::initialStateString()
 std::string Connect4::stateString()
 {
     std::string s(CONNECT4_COLS * CONNECT4_ROWS, '0');
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        Bit *bit = square->bit();
+    for (ChessSquare& square : _grid->squares()) {
+        Bit *bit = square.bit();
         if (bit) {
-            s[y * CONNECT4_COLS + x] = std::to_string(bit->getOwner()->playerNumber() + 1)[0];
+            s[square.getRow() * CONNECT4_COLS + square.getColumn()] = '1' + bit->getOwner()->playerNumber();
         }
-    });
+    }
     return s;
 }
 
@@ -208,5 +169,57 @@ void Connect4::setStateString(const std::string &s)
             square->setBit(nullptr);
         }
     });
+    stonesFromState(s, _stones[0], _stones[1]);
+}
+
+void Connect4::stonesFromState(const std::string &state, uint64_t &first, uint64_t &second)
+{
+    first = 0;
+    second = 0;
+    for (int y = 0; y < CONNECT4_ROWS; y++) {
+        for (int x = 0; x < CONNECT4_COLS; x++) {
+            size_t index = y * CONNECT4_COLS + x;
+            if (index >= state.length()) {
+                continue;
+            }
+            if (state[index] == '1') {
+                first |= 1ULL << cellForSquare(x, y);
+            } else if (state[index] == '2') {
+                second |= 1ULL << cellForSquare(x, y);
+            }
+        }
+    }
+}
+
+void Connect4::updateAI()
+{
+    applyAIMove(searchAIMove(stateString(), getCurrentPlayer()->playerNumber(), aiOptions()));
+}
+
+//
+// runs on a worker thread from a state snapshot, returns the column to drop into
+//
+std::string Connect4::searchAIMove(const std::string &state, int playerNumber, const AIOptions &options)
+{
+    uint64_t stones[2];
+    stonesFromState(state, stones[0], stones[1]);
+    Connect4Board board(stones[playerNumber], stones[0] | stones[1], std::popcount(stones[0] | stones[1]));
+    if (board.isFull()) {
+        return "";
+    }
+    if (options.useMCTS) {
+        MCTS<Connect4MCTSState, Connect4Playout>::Result result = _mcts.search(Connect4MCTSState(board), { kAIThinkTimeMs, 0 });
+        return result.hasMove ? std::to_string(result.bestMove) : "";
+    }
+    return std::to_string(_solver.findMove(board, options.maxDepth, kAIThinkTimeMs));
+}
+
+bool Connect4::applyAIMove(const std::string &move)
+{
+    if (move.empty()) {
+        return false;
+    }
+    ChessSquare* square = _grid->getSquare(std::stoi(move), 0);
+    return square && actionForEmptyHolder(*square);
 }
 
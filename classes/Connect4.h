@@ -2,6 +2,9 @@
 
 #include "Game.h"
 #include "Grid.h"
+#include "Connect4Board.h"
+#include "Connect4Solver.h"
+#include "Connect4MCTS.h"
 
 const int CONNECT4_COLS = 7;
 const int CONNECT4_ROWS = 6;
@@ -27,14 +30,27 @@ public:
     std::string stateString() override;
     void setStateString(const std::string &s) override;
 
+    void updateAI() override;
+    bool gameHasAI() override { return true; }
+    bool gameHasBackgroundAI() override { return true; }
+    bool gameHasMCTS() override { return true; }
+    std::string searchAIMove(const std::string &state, int playerNumber, const AIOptions &options) override;
+    bool applyAIMove(const std::string &move) override;
+
     Grid* getGrid() override { return _grid; }
 
 private:
     Bit* PieceForPlayer(const int playerNumber);
     int getLowestEmptyRow(int col);
     bool isColumnFull(int col);
-    Player* ownerAt(int x, int y) const;
-    bool checkDirection(int startX, int startY, int dx, int dy, Player* player);
+
+    // state strings -> bitboards in the Connect4Board layout, one per player
+    static void stonesFromState(const std::string &state, uint64_t &first, uint64_t &second);
 
     Grid* _grid;
+    // the rules run on these, the grid mirrors them
+    uint64_t _stones[2];
+    // only ever used by this game's one pending AI job
+    Connect4Solver _solver;
+    MCTS<Connect4MCTSState, Connect4Playout> _mcts;
 };
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <bit>
+#include <initializer_list>
+
+//
+// bitboard connect 4 position
+// each column takes kHeight + 1 bits (bottom row first), the spare bit on top of every column
+// keeps shifted lines from running into the next column. the position is the stones of the
+// side to move plus a mask of every stone, and a column is played by adding its bottom bit
+// to the mask so the carry lands on the first empty cell
+//
+class Connect4Board
+{
+public:
+    static const int kWidth = 7;
+    static const int kHeight = 6;
+    static const int kCells = kWidth * kHeight;
+
+    Connect4Board() : _current(0), _mask(0), _moves(0) {}
+    Connect4Board(uint64_t current, uint64_t mask, int moves) : _current(current), _mask(mask), _moves(moves) {}
+
+    // stones of the side to move, and every stone on the board
+    uint64_t current() const { return _current; }
+    uint64_t mask() const { return _mask; }
+    uint64_t opponent() const { return _current ^ _mask; }
+    int moveCount() const { return _moves; }
+    // unique for every position, for transposition tables and opening books
+    uint64_t key() const { return _current + _mask; }
+    // the same key for a position and its mirror image
+    uint64_t canonicalKey() const
+    {
+        uint64_t key = this->key();
+        uint64_t mirror = mirroredBits(key);
+        return mirror < key ? mirror : key;
+    }
+
+    bool canPlay(int column) const { return (_mask & topMask(column)) == 0; }
+    void play(int column) { playMove((_mask + bottomMask(column)) & columnMask(column)); }
+    // play the single bit of a cell from possible()
+    void playMove(uint64_t move)
+    {
+        _current ^= _mask;
+        _mask |= move;
+        _moves++;
+    }
+
+    // the cell every playable column would take
+    uint64_t possible() const { return (_mask + kBottomMask) & kBoardMask; }
+    bool isFull() const { return _moves >= kCells; }
+    bool isWinningMove(int column) const { return winningCells(_current, _mask) & possible() & columnMask(column); }
+    bool canWinNext() const { return winningCells(_current, _mask) & possible(); }
+
+    // the moves that don't let the opponent win straight away, 0 if every move loses
+    // (only meaningful when the side to move can't win immediately)
+    uint64_t nonLosingMoves() const
+    {
+        uint64_t moves = possible();
+        uint64_t opponentWins = winningCells(opponent(), _mask);
+        uint64_t forced = moves & opponentWins;
+        if (forced) {
+            // two threats at once can't both be blocked
+            if (forced & (forced - 1)) {
+                return 0;
+            }
+            moves = forced;
+        }
+        // never play directly under one of the opponent's winning cells
+        return moves & ~(opponentWins >> 1);
+    }
+
+    // number of open winning cells the side to move would have after playing move
+    int moveScore(uint64_t move) const { return std::popcount(winningCells(_current | move, _mask)); }
+
+    static uint64_t columnMask(int column) { return ((1ULL << kHeight) - 1) << (column * (kHeight + 1)); }
+    static uint64_t bottomMask(int column) { return 1ULL << (column * (kHeight + 1)); }
+    static uint64_t topMask(int column) { return 1ULL << (kHeight - 1 + column * (kHeight + 1)); }
+    static int cellIndex(int column, int rowFromBottom) { return column * (kHeight + 1) + rowFromBottom; }
+
+    // bits with the columns in reverse order, the carries in a key never leave their column
+    // so mirroring a key gives the key of the mirrored position
+    static uint64_t mirroredBits(uint64_t bits)
+    {
+        uint64_t mirror = 0;
+        for (int column = 0; column < kWidth; column++) {
+            uint64_t columnBits = (bits >> (column * (kHeight + 1))) & ((1ULL << (kHeight + 1)) - 1);
+            mirror |= columnBits << ((kWidth - 1 - column) * (kHeight + 1));
+        }
+        return mirror;
+    }
+
+    // four in a row anywhere in stones: vertical, horizontal and both diagonals
+    static bool hasFour(uint64_t stones)
+    {
+        for (int shift : { 1, kHeight + 1, kHeight, kHeight + 2 }) {
+            uint64_t pairs = stones & (stones >> shift);
+            if (pairs & (pairs >> (2 * shift))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // empty cells that would complete four in a row for stones
+    static uint64_t winningCells(uint64_t stones, uint64_t mask)
+    {
+        // vertical
+        uint64_t cells = (stones << 1) & (stones << 2) & (stones << 3);
+        // horizontal, then the two diagonals, each with the gap at any of the four places
+        for (int shift : { kHeight + 1, kHeight, kHeight + 2 }) {
+            uint64_t pair = (stones << shift) & (stones << (2 * shift));
+            cells |= pair & (stones << (3 * shift));
+            cells |= pair & (stones >> shift);
+            pair = (stones >> shift) & (stones >> (2 * shift));
+            cells |= pair & (stones << shift);
+            cells |= pair & (stones >> (3 * shift));
+        }
+        return cells & (kBoardMask ^ mask);
+    }
+
+private:
+    // bit 0 of every column
+    static constexpr uint64_t kBottomMask = 0x0000040810204081ULL;
+    static constexpr uint64_t kBoardMask = kBottomMask * ((1ULL << kHeight) - 1);
+
+    uint64_t _current;
+    uint64_t _mask;
+    int _moves;
+};
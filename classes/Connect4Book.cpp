@@ -0,0 +1,88 @@
+#include "Connect4Book.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+Connect4Book::Connect4Book()
+{
+    _entries = nullptr;
+    _count = 0;
+    _maxPly = -1;
+}
+
+Connect4Book::~Connect4Book()
+{
+    close();
+}
+
+bool Connect4Book::open(const std::string &path)
+{
+    close();
+    if (!_file.open(path) || _file.size() < sizeof(Header)) {
+        close();
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, _file.data(), sizeof(Header));
+    if (std::memcmp(header.magic, "C4BK", 4) != 0 || header.version != kVersion ||
+        header.count > (_file.size() - sizeof(Header)) / sizeof(uint64_t)) {
+        close();
+        return false;
+    }
+    _entries = reinterpret_cast<const uint64_t *>(_file.data() + sizeof(Header));
+    _count = (size_t)header.count;
+    _maxPly = (int)header.maxPly;
+    return true;
+}
+
+void Connect4Book::close()
+{
+    _file.close();
+    _entries = nullptr;
+    _count = 0;
+    _maxPly = -1;
+}
+
+bool Connect4Book::lookup(const Connect4Board &board, int &score) const
+{
+    if (!_entries || board.moveCount() > _maxPly) {
+        return false;
+    }
+    uint64_t key = board.canonicalKey();
+    // every entry for key sorts at or after key << 8, and the first one is the only one
+    const uint64_t *end = _entries + _count;
+    const uint64_t *entry = std::lower_bound(_entries, end, key << 8);
+    if (entry == end || (*entry >> 8) != key) {
+        return false;
+    }
+    score = (int)(*entry & 0xff) - 128;
+    return true;
+}
+
+bool Connect4Book::write(const std::string &path, std::vector<uint64_t> entries, int maxPly)
+{
+    std::sort(entries.begin(), entries.end());
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    Header header;
+    std::memcpy(header.magic, "C4BK", 4);
+    header.version = kVersion;
+    header.maxPly = (uint32_t)maxPly;
+    header.reserved = 0;
+    header.count = entries.size();
+    bool written = std::fwrite(&header, sizeof(Header), 1, file) == 1 &&
+                   std::fwrite(entries.data(), sizeof(uint64_t), entries.size(), file) == entries.size();
+    return std::fclose(file) == 0 && written;
+}
+
+const Connect4Book &Connect4Book::sharedBook()
+{
+    static Connect4Book book;
+    static bool opened = book.open((std::filesystem::path("resources") / "connect4.book").string());
+    (void)opened;
+    return book;
+}
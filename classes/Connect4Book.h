@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Connect4Board.h"
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+//
+// connect 4 opening book: exact scores of every position up to some ply, solved offline by
+// tools/connect4_book and memory mapped at runtime
+//
+// file layout (little endian): a Header, then count uint64 entries sorted ascending, each the
+// canonical position key shifted up 8 bits with the score + 128 in the low byte. mirror images
+// share one entry, so lookups binary search a read-only mapping shared between processes
+//
+class Connect4Book
+{
+public:
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t maxPly;
+        uint32_t reserved;
+        uint64_t count;
+    };
+    static const uint32_t kVersion = 1;
+
+    Connect4Book();
+    ~Connect4Book();
+    Connect4Book(const Connect4Book &) = delete;
+    Connect4Book &operator=(const Connect4Book &) = delete;
+
+    // map a book file, false if it's missing or malformed
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const { return _entries != nullptr; }
+
+    // exact score of board (see Connect4Solver), false if it isn't in the book
+    bool lookup(const Connect4Board &board, int &score) const;
+
+    int maxPly() const { return _maxPly; }
+    size_t size() const { return _count; }
+
+    // pack entries and write a book file, used by the generator
+    static uint64_t packEntry(uint64_t canonicalKey, int score) { return (canonicalKey << 8) | (uint64_t)(score + 128); }
+    static bool write(const std::string &path, std::vector<uint64_t> entries, int maxPly);
+
+    // the book the games share, opened from resources/connect4.book on first use
+    static const Connect4Book &sharedBook();
+
+private:
+    MappedFile _file;
+    const uint64_t *_entries;
+    size_t _count;
+    int _maxPly;
+};
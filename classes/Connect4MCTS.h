@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Connect4Board.h"
+#include "MCTS.h"
+
+//
+// Connect4Board as an MCTSState, remembering whether the last move won since the board only
+// keeps the side to move's stones
+//
+class Connect4MCTSState
+{
+public:
+    using Move = int;
+    struct MoveList
+    {
+        int moves[Connect4Board::kWidth];
+        int count = 0;
+
+        int *begin() { return moves; }
+        int *end() { return moves + count; }
+        const int *begin() const { return moves; }
+        const int *end() const { return moves + count; }
+    };
+
+    Connect4MCTSState() : _won(false) {}
+    Connect4MCTSState(const Connect4Board &board) : _board(board), _won(false) {}
+
+    const Connect4Board &board() const { return _board; }
+
+    void generateMoves(MoveList &list) const
+    {
+        list.count = 0;
+        if (_won) {
+            return;
+        }
+        for (int column = 0; column < Connect4Board::kWidth; column++) {
+            if (_board.canPlay(column)) {
+                list.moves[list.count++] = column;
+            }
+        }
+    }
+
+    void make(int column)
+    {
+        _won = _board.isWinningMove(column);
+        _board.play(column);
+    }
+
+    // the first player is side 0
+    int sideToMove() const { return _board.moveCount() & 1; }
+
+    double result(int side) const
+    {
+        if (!_won) {
+            return 0.5;
+        }
+        // the side that just moved won
+        return side == ((_board.moveCount() - 1) & 1) ? 1.0 : 0.0;
+    }
+
+    bool operator==(const Connect4MCTSState &other) const { return _board.key() == other._board.key() && _won == other._won; }
+
+private:
+    Connect4Board _board;
+    bool _won;
+};
+
+//
+// playouts that take a win when there is one and otherwise avoid handing one over, random
+// playouts blunder too often to tell good connect 4 moves from bad
+//
+struct Connect4Playout
+{
+    int choose(const Connect4MCTSState &state, const Connect4MCTSState::MoveList &list, MCTSRandom &random) const
+    {
+        const Connect4Board &board = state.board();
+        for (int column : list) {
+            if (board.isWinningMove(column)) {
+                return column;
+            }
+        }
+        uint64_t safe = board.nonLosingMoves();
+        if (safe) {
+            int columns[Connect4Board::kWidth];
+            int count = 0;
+            for (int column : list) {
+                if (safe & Connect4Board::columnMask(column)) {
+                    columns[count++] = column;
+                }
+            }
+            return columns[random.below(count)];
+        }
+        return list.moves[random.below(list.count)];
+    }
+};
@@ -0,0 +1,275 @@
+#include "Connect4Solver.h"
+#include "Connect4Book.h"
+#include <algorithm>
+
+namespace {
+    // columns from the centre out
+    const int kColumnOrder[Connect4Board::kWidth] = { 3, 2, 4, 1, 5, 0, 6 };
+
+    // heuristic scores stay clear of exact ones
+    const int kHeuristicWin = 10000;
+}
+
+Connect4Solver::Connect4Solver(size_t tableEntries)
+{
+    size_t size = 1;
+    while (size * 2 <= tableEntries) {
+        size *= 2;
+    }
+    _table.assign(size, TableEntry{ 0, 0, kNone });
+    _book = nullptr;
+    _nodes = 0;
+    _aborted = false;
+    _timeLimitMs = 0;
+}
+
+Connect4Solver::TableEntry *Connect4Solver::probe(uint64_t key)
+{
+    TableEntry *entry = &_table[(key * 0x9e3779b97f4a7c15ULL >> 20) & (_table.size() - 1)];
+    return (entry->bound != kNone && entry->key == key) ? entry : nullptr;
+}
+
+void Connect4Solver::store(uint64_t key, int score, Bound bound)
+{
+    _table[(key * 0x9e3779b97f4a7c15ULL >> 20) & (_table.size() - 1)] = TableEntry{ key, (int8_t)score, bound };
+}
+
+//
+// fills ordered with single-bit moves, the ones that open the most winning cells first and
+// centre columns ahead of outer ones on ties
+//
+int Connect4Solver::orderMoves(const Connect4Board &board, uint64_t moves, uint64_t *ordered)
+{
+    int scores[Connect4Board::kWidth];
+    int count = 0;
+    for (int column : kColumnOrder) {
+        uint64_t move = moves & Connect4Board::columnMask(column);
+        if (!move) {
+            continue;
+        }
+        int score = board.moveScore(move);
+        int at = count++;
+        while (at > 0 && scores[at - 1] < score) {
+            scores[at] = scores[at - 1];
+            ordered[at] = ordered[at - 1];
+            at--;
+        }
+        scores[at] = score;
+        ordered[at] = move;
+    }
+    return count;
+}
+
+//
+// the caller guarantees the side to move can't win immediately
+//
+int Connect4Solver::negamax(const Connect4Board &board, int alpha, int beta)
+{
+    _nodes++;
+    if ((_nodes & 4095) == 0 && _timeLimitMs > 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start);
+        if (elapsed.count() >= _timeLimitMs) {
+            _aborted = true;
+        }
+    }
+    if (_aborted) {
+        return 0;
+    }
+
+    uint64_t moves = board.nonLosingMoves();
+    if (!moves) {
+        // whatever we play the opponent wins next move
+        return -(Connect4Board::kCells - board.moveCount()) / 2;
+    }
+    if (board.moveCount() >= Connect4Board::kCells - 2) {
+        return 0;
+    }
+    int bookScore;
+    if (_book && _book->lookup(board, bookScore)) {
+        return bookScore;
+    }
+
+    // we can't win next move and the opponent can't win the move after, so the score is bounded
+    int lowest = -(Connect4Board::kCells - 2 - board.moveCount()) / 2;
+    if (alpha < lowest) {
+        alpha = lowest;
+        if (alpha >= beta) {
+            return alpha;
+        }
+    }
+    int highest = (Connect4Board::kCells - 1 - board.moveCount()) / 2;
+    if (TableEntry *entry = probe(board.key())) {
+        if (entry->bound == kLower) {
+            if (alpha < entry->score) {
+                alpha = entry->score;
+                if (alpha >= beta) {
+                    return alpha;
+                }
+            }
+        } else if (entry->score < highest) {
+            highest = entry->score;
+        }
+    }
+    if (highest < beta) {
+        beta = highest;
+        if (alpha >= beta) {
+            return beta;
+        }
+    }
+
+    uint64_t ordered[Connect4Board::kWidth];
+    int count = orderMoves(board, moves, ordered);
+    for (int i = 0; i < count; i++) {
+        Connect4Board child = board;
+        child.playMove(ordered[i]);
+        int score = -negamax(child, -beta, -alpha);
+        if (_aborted) {
+            return 0;
+        }
+        if (score >= beta) {
+            store(board.key(), score, kLower);
+            return score;
+        }
+        if (score > alpha) {
+            alpha = score;
+        }
+    }
+    store(board.key(), alpha, kUpper);
+    return alpha;
+}
+
+int Connect4Solver::solve(const Connect4Board &board, int timeLimitMs)
+{
+    _nodes = 0;
+    _aborted = false;
+    _timeLimitMs = timeLimitMs;
+    _start = std::chrono::steady_clock::now();
+
+    if (board.canWinNext()) {
+        return (Connect4Board::kCells + 1 - board.moveCount()) / 2;
+    }
+    int bookScore;
+    if (_book && _book->lookup(board, bookScore)) {
+        return bookScore;
+    }
+
+    // narrow the score range with null-window searches, probing near zero first since
+    // most positions are decided by small margins
+    int lowest = -(Connect4Board::kCells - board.moveCount()) / 2;
+    int highest = (Connect4Board::kCells + 1 - board.moveCount()) / 2;
+    while (lowest < highest) {
+        int middle = lowest + (highest - lowest) / 2;
+        if (middle <= 0 && lowest / 2 < middle) {
+            middle = lowest / 2;
+        } else if (middle >= 0 && highest / 2 > middle) {
+            middle = highest / 2;
+        }
+        int score = negamax(board, middle, middle + 1);
+        if (_aborted) {
+            return kAborted;
+        }
+        if (score <= middle) {
+            highest = score;
+        } else {
+            lowest = score;
+        }
+    }
+    return lowest;
+}
+
+int Connect4Solver::search(const Connect4Board &board, int depth, int alpha, int beta)
+{
+    _nodes++;
+    if (board.isFull()) {
+        return 0;
+    }
+    if (board.canWinNext()) {
+        return kHeuristicWin + (Connect4Board::kCells - board.moveCount());
+    }
+    uint64_t moves = board.nonLosingMoves();
+    if (!moves) {
+        return -kHeuristicWin - (Connect4Board::kCells - board.moveCount());
+    }
+    if (board.moveCount() >= Connect4Board::kCells - 2) {
+        return 0;
+    }
+    if (depth <= 0) {
+        // open winning cells, ours against theirs
+        return std::popcount(Connect4Board::winningCells(board.current(), board.mask())) - std::popcount(Connect4Board::winningCells(board.opponent(), board.mask()));
+    }
+
+    uint64_t ordered[Connect4Board::kWidth];
+    int count = orderMoves(board, moves, ordered);
+    int best = -kHeuristicWin * 2;
+    for (int i = 0; i < count; i++) {
+        Connect4Board child = board;
+        child.playMove(ordered[i]);
+        int score = -search(child, depth - 1, -beta, -alpha);
+        best = std::max(best, score);
+        alpha = std::max(alpha, score);
+        if (alpha >= beta) {
+            break;
+        }
+    }
+    return best;
+}
+
+int Connect4Solver::findMove(const Connect4Board &board, int maxDepth, int timeLimitMs)
+{
+    for (int column : kColumnOrder) {
+        if (board.canPlay(column) && board.isWinningMove(column)) {
+            return column;
+        }
+    }
+
+    // solve every reply exactly, sharing the budget (the table carries over between them)
+    auto start = std::chrono::steady_clock::now();
+    int bestColumn = -1;
+    int bestScore = -kAborted;
+    bool exact = true;
+    for (int column : kColumnOrder) {
+        if (!board.canPlay(column)) {
+            continue;
+        }
+        int remaining = 0;
+        if (timeLimitMs > 0) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            remaining = timeLimitMs - (int)elapsed.count();
+            if (remaining <= 0) {
+                exact = false;
+                break;
+            }
+        }
+        Connect4Board child = board;
+        child.play(column);
+        int score = solve(child, remaining);
+        if (score == kAborted) {
+            exact = false;
+            break;
+        }
+        if (-score > bestScore) {
+            bestScore = -score;
+            bestColumn = column;
+        }
+    }
+    if (exact && bestColumn >= 0) {
+        return bestColumn;
+    }
+
+    bestColumn = -1;
+    bestScore = -kHeuristicWin * 4;
+    int depth = std::max(1, maxDepth);
+    for (int column : kColumnOrder) {
+        if (!board.canPlay(column)) {
+            continue;
+        }
+        Connect4Board child = board;
+        child.play(column);
+        int score = -search(child, depth - 1, -kHeuristicWin * 4, -bestScore);
+        if (bestColumn < 0 || score > bestScore) {
+            bestScore = score;
+            bestColumn = column;
+        }
+    }
+    return bestColumn;
+}
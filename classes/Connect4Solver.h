@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Connect4Board.h"
+#include <vector>
+#include <chrono>
+
+class Connect4Book;
+
+//
+// connect 4 solver: negamax with alpha-beta over Connect4Board, a transposition table of
+// bounds, centre-first ordering (refined by the threats each move creates) and null-window
+// iterative deepening on the score range
+// a score is positive when the side to move wins: the number of its stones still unplayed
+// when it connects four, plus one. zero is a draw
+//
+class Connect4Solver
+{
+public:
+    // returned by solve when it runs out of time
+    static const int kAborted = 1000;
+
+    Connect4Solver(size_t tableEntries = 1 << 20);
+
+    // exact score of the position, or kAborted once timeLimitMs (0 for no limit) has passed
+    int solve(const Connect4Board &board, int timeLimitMs = 0);
+
+    // column to play: the best exact move if the solve finishes in time, otherwise the best
+    // move of a depth-limited search maxDepth plies deep
+    int findMove(const Connect4Board &board, int maxDepth, int timeLimitMs);
+
+    uint64_t nodes() const { return _nodes; }
+
+    // answer positions from an opening book instead of searching them, nullptr for none
+    void setBook(const Connect4Book *book) { _book = book; }
+
+private:
+    enum Bound : uint8_t { kNone, kLower, kUpper };
+    struct TableEntry
+    {
+        uint64_t key;
+        int8_t score;
+        Bound bound;
+    };
+
+    int negamax(const Connect4Board &board, int alpha, int beta);
+    // heuristic alpha-beta for when the exact solve doesn't finish
+    int search(const Connect4Board &board, int depth, int alpha, int beta);
+    int orderMoves(const Connect4Board &board, uint64_t moves, uint64_t *ordered);
+
+    TableEntry *probe(uint64_t key);
+    void store(uint64_t key, int score, Bound bound);
+
+    std::vector<TableEntry> _table;
+    const Connect4Book *_book;
+    uint64_t _nodes;
+    bool _aborted;
+    int _timeLimitMs;
+    std::chrono::steady_clock::time_point _start;
+};
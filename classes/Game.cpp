@@ -15,7 +15,10 @@ Game::Game()
 	_gameOptions.rowY = 0;
 	_gameOptions.score = 0;
 	_gameOptions.AIDepthSearches = 0;
+	_gameOptions.AIMAXDepth = 0;
 	_gameOptions.AIvsAI = false;
+	_gameOptions.AIUseMCTS = false;
+	_gameOptions.AIMultiPV = 1;
 
 	_table = nullptr;
 	_winner = nullptr;
@@ -97,7 +100,7 @@ void Game::endTurn()
 	turn->_score = _gameOptions.score;
 	turn->_gameNumber = _gameOptions.gameNumber;
 	_turns.push_back(turn);
-	ClassGame::EndOfTurn();
+	ClassGame::EndOfTurn(this);
 }
 
 //
@@ -108,7 +111,7 @@ void Game::endTurn()
 //
 void Game::scanForMouse()
 {
-	if (gameHasAI() && getCurrentPlayer()->isAIPlayer())
+	if (gameHasAI() && (getCurrentPlayer()->isAIPlayer() || _gameOptions.AIvsAI))
 	{
 		return;
 	}
@@ -120,18 +123,18 @@ void Game::scanForMouse()
 	mousePos.y -= ImGui::GetWindowPos().y;
 
 	Entity *entity = nullptr;
-	Grid* grid = getGrid();
-	grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
-		Bit *bit = square->bit();
+	for (ChessSquare &square : getGrid()->enabledSquares())
+	{
+		Bit *bit = square.bit();
 		if (bit && bit->isMouseOver(mousePos))
 		{
 			entity = bit;
 		}
-		else if (square->isMouseOver(mousePos))
+		else if (square.isMouseOver(mousePos))
 		{
-			entity = square;
+			entity = &square;
 		}
-	});
+	}
 	if (ImGui::IsMouseClicked(0))
 	{
 		mouseDown(mousePos, entity);
@@ -148,68 +151,58 @@ void Game::scanForMouse()
 
 void Game::findDropTarget(ImVec2 &pos)
 {
-	Grid* grid = getGrid();
-	grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
-		if (square == _oldHolder)
+	for (ChessSquare &square : getGrid()->enabledSquares())
+	{
+		if (&square == _oldHolder)
 		{
-			return;
+			continue;
 		}
-		if (square->isMouseOver(pos))
+		if (square.isMouseOver(pos))
 		{
-			if (_dropTarget && square != _dropTarget)
+			if (_dropTarget && &square != _dropTarget)
 			{
 				_dropTarget->willNotDropBit(_dragBit);
 				_dropTarget->setHighlighted(false);
 				_dropTarget = nullptr;
 			}
-			if (_oldHolder && square->canDropBitAtPoint(_dragBit, pos) && canBitMoveFromTo(*_dragBit, *_oldHolder, *square))
+			if (_oldHolder && square.canDropBitAtPoint(_dragBit, pos) && canBitMoveFromTo(*_dragBit, *_oldHolder, square))
 			{
-				_dropTarget = square;
+				_dropTarget = &square;
 				_dropTarget->setHighlighted(true);
 			}
 		}
-	});
+	}
 }
 
 //
 // draw the board and then the pieces
-// this will also go somewhere else when the heirarchy is set up
+// the renderer keeps a sorted render list and only rebuilds it when pieces change,
+// so a frame is a single pass of batched quads into the window's draw list
 //
 void Game::drawFrame()
 {
 	scanForMouse();
 
-	Grid* grid = getGrid();
+	// sprite positions are window local, the same space ImGui::SetCursorPos uses
+	ImVec2 origin = ImGui::GetWindowPos();
+	origin.x -= ImGui::GetScrollX();
+	origin.y -= ImGui::GetScrollY();
+	_renderer.draw(getGrid(), ImGui::GetWindowDrawList(), origin);
 
-	// Paint squares
-	grid->forEachEnabledSquare([](ChessSquare* square, int x, int y) {
-		square->paintSprite();
-	});
-
-	// Paint stationary pieces
-	grid->forEachEnabledSquare([](ChessSquare* square, int x, int y) {
-		if (square->bit() && !square->bit()->getPickedUp() && !square->bit()->getMoving())
-		{
-			square->bit()->paintSprite();
-		}
-	});
+	// reserve the board's area so the window sizes and scrolls around it
+	ImGui::SetCursorPos(ImVec2(0, 0));
+	ImGui::Dummy(_renderer.extent());
+}
 
-	// Paint moving pieces
-	grid->forEachEnabledSquare([](ChessSquare* square, int x, int y) {
-		if (square->bit() && square->bit()->getMoving() && !square->bit()->getPickedUp())
-		{
-			square->bit()->update();
-			square->bit()->paintSprite();
-		}
-	});
+void Game::drawThumbnail(ImDrawList *drawList, const ImVec2 &origin, float scale, bool animate)
+{
+	_renderer.draw(getGrid(), drawList, origin, scale, animate);
+}
 
-	// Paint picked up pieces
-	grid->forEachEnabledSquare([](ChessSquare* square, int x, int y) {
-		if (square->bit() && square->bit()->getPickedUp())
-		{
-			square->bit()->paintSprite();
-		}
-	});
+const ImVec2 &Game::boardExtent()
+{
+	_renderer.prepare(getGrid());
+	return _renderer.extent();
 }
 
 void Game::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst)
@@ -246,6 +239,15 @@ void Game::updateAI()
 {
 }
 
+AIOptions Game::aiOptions()
+{
+	AIOptions options;
+	options.maxDepth = _gameOptions.AIMAXDepth;
+	options.useMCTS = _gameOptions.AIUseMCTS;
+	options.multiPV = _gameOptions.AIMultiPV;
+	return options;
+}
+
 void Game::mouseDown(ImVec2 &location, Entity *entity)
 {
 	bool placing = false;
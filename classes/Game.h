@@ -22,6 +22,7 @@
 #include "Bit.h"
 #include "BitHolder.h"
 #include "Grid.h"
+#include "BoardRenderer.h"
 
 
 const int AI_PLAYER = 1;
@@ -42,13 +43,30 @@ struct GameOptions
 	int AIDepthSearches;
 	int AIMAXDepth;
 	bool AIvsAI;
+	// play with the monte carlo searcher, for games that have one
+	bool AIUseMCTS;
+	// lines the AI reports from each search, for games that analyse, 1 for just its move
+	int AIMultiPV;
+};
+
+// the settings a background search reads instead of the game's, copied on the UI thread when
+// the search is started so the settings panel can change the game's while it runs
+struct AIOptions
+{
+	int maxDepth = 0;
+	bool useMCTS = false;
+	int multiPV = 1;
+	// the game's own settings by name, the ones its drawAISettings shows
+	std::vector<std::pair<std::string, int>> settings;
+	// hashes of the positions before the current one, oldest first, for games with repetition draws
+	std::vector<uint64_t> history;
 };
 
 class Game
 {
 public:
 	Game();
-	~Game();
+	virtual ~Game();
 
 	void startGame();
 
@@ -95,6 +113,22 @@ public:
 	virtual void stopGame() = 0;
 	virtual bool gameHasAI();
 	virtual void updateAI();
+
+	// background AI: searchAIMove runs on a worker thread against a snapshot of the state string
+	// and of aiOptions, and its move is handed to applyAIMove back on the UI thread. searchAIMove
+	// must only read the snapshots, never the game options, the grid or its pieces
+	virtual bool gameHasBackgroundAI() { return false; }
+	// whether AIUseMCTS does anything for this game
+	virtual bool gameHasMCTS() { return false; }
+	virtual std::string searchAIMove(const std::string &state, int playerNumber, const AIOptions &options) { return ""; }
+	// the AI settings as they stand, for a search to take with it
+	virtual AIOptions aiOptions();
+	virtual bool applyAIMove(const std::string &move) { return false; }
+	// the game's own AI settings, drawn into the settings panel under the common ones
+	virtual void drawAISettings() {}
+	// whether AIMultiPV does anything for this game, and the lines from its last search
+	virtual bool gameHasMultiPV() { return false; }
+	virtual std::vector<std::string> analysisLines() { return {}; }
 	virtual void pieceTaken(Bit *bit){};
 
 	virtual std::string initialStateString() = 0;
@@ -106,6 +140,11 @@ public:
 	virtual int getAIDepathSearches() { return _gameOptions.AIDepthSearches; };
 	virtual int getAIMAXDepth() { return _gameOptions.AIMAXDepth; };
 
+	// draw a scaled copy of the board, used by the dashboard thumbnails
+	void drawThumbnail(ImDrawList *drawList, const ImVec2 &origin, float scale, bool animate);
+	// unscaled size of the board as drawn
+	const ImVec2 &boardExtent();
+
 	// mouse functions
 	void scanForMouse();
 	// grid access - replaces getHolderAt
@@ -151,4 +190,6 @@ protected:
 	BitHolder *_dropTarget;
 	BitHolder *_oldHolder;
 	bool _dragMoved;
+
+	BoardRenderer _renderer;
 };
@@ -1,59 +1,30 @@
 #include "Grid.h"
+#include <algorithm>
 
-Grid::Grid(int width, int height) : _width(width), _height(height)
+// squares are constructed in place and never move, so pointers to them stay valid
+Grid::Grid(int width, int height) : _squares(width * height), _width(width), _height(height), _count(width * height), _renderRevision(0)
 {
-    // Initialize 2D vectors
-    _squares.resize(height);
-    _enabled.resize(height);
-
-    for (int y = 0; y < height; y++) {
-        _squares[y].resize(width);
-        _enabled[y].resize(width);
-
-        for (int x = 0; x < width; x++) {
-            _squares[y][x] = new ChessSquare();
-            _enabled[y][x] = true; // All squares enabled by default
-        }
+    // all squares enabled by default
+    _enabled.assign((_count + 63) / 64, ~0ULL);
+    for (ChessSquare &square : _squares) {
+        square.setRenderRevision(&_renderRevision);
     }
 }
 
 Grid::~Grid()
 {
-    for (int y = 0; y < _height; y++) {
-        for (int x = 0; x < _width; x++) {
-            delete _squares[y][x];
-        }
-    }
-}
-
-ChessSquare* Grid::getSquare(int x, int y)
-{
-    if (!isValid(x, y)) return nullptr;
-    return _squares[y][x];
-}
-
-ChessSquare* Grid::getSquareByIndex(int index)
-{
-    int x, y;
-    getCoordinates(index, x, y);
-    return getSquare(x, y);
-}
-
-bool Grid::isValid(int x, int y) const
-{
-    return x >= 0 && x < _width && y >= 0 && y < _height;
-}
-
-bool Grid::isEnabled(int x, int y) const
-{
-    if (!isValid(x, y)) return false;
-    return _enabled[y][x];
 }
 
 void Grid::setEnabled(int x, int y, bool enabled)
 {
-    if (isValid(x, y)) {
-        _enabled[y][x] = enabled;
+    if (isValid(x, y) && isEnabled(x, y) != enabled) {
+        int index = getIndex(x, y);
+        if (enabled) {
+            _enabled[index >> 6] |= 1ULL << (index & 63);
+        } else {
+            _enabled[index >> 6] &= ~(1ULL << (index & 63));
+        }
+        _renderRevision++;
     }
 }
 
@@ -149,27 +120,6 @@ bool Grid::areConnected(int fromX, int fromY, int toX, int toY)
     return false;
 }
 
-// Iterator support
-void Grid::forEachSquare(std::function<void(ChessSquare*, int x, int y)> func)
-{
-    for (int y = 0; y < _height; y++) {
-        for (int x = 0; x < _width; x++) {
-            func(_squares[y][x], x, y);
-        }
-    }
-}
-
-void Grid::forEachEnabledSquare(std::function<void(ChessSquare*, int x, int y)> func)
-{
-    for (int y = 0; y < _height; y++) {
-        for (int x = 0; x < _width; x++) {
-            if (_enabled[y][x]) {
-                func(_squares[y][x], x, y);
-            }
-        }
-    }
-}
-
 // Initialize squares
 void Grid::initializeSquares(float squareSize, const char* spriteName)
 {
@@ -186,7 +136,7 @@ void Grid::initializeChessSquares(float squareSize, const char* spriteName)
     for (int y = 0; y < _height; y++) {
         for (int x = 0; x < _width; x++) {
             ImVec2 position(squareSize * x + squareSize/2, squareSize * (7-y) + squareSize/2);
-            _squares[y][x]->initHolder(position, spriteName, x, y);
+            _squares[getIndex(x, y)].initHolder(position, spriteName, x, y);
         }
     }
 }
@@ -195,7 +145,7 @@ void Grid::initializeSquare(int x, int y, float squareSize, const char* spriteNa
 {
     if (isValid(x, y)) {
         ImVec2 position(squareSize * x + squareSize/2, squareSize * y + squareSize/2);
-        _squares[y][x]->initHolder(position, spriteName, x, y);
+        _squares[getIndex(x, y)].initHolder(position, spriteName, x, y);
     }
 }
 
@@ -204,15 +154,14 @@ std::string Grid::getStateString() const
 {
     std::string state;
 
-    for (int y = 0; y < _height; y++) {
-        for (int x = 0; x < _width; x++) {
-            if (_enabled[y][x]) {
-                Bit* bit = _squares[y][x]->bit();
-                if (bit) {
-                    state += std::to_string(bit->gameTag());
-                } else {
-                    state += '0';
-                }
+    for (int index = 0; index < _count; index++) {
+        if (isEnabledIndex(index)) {
+            // non-const access so a bit that was dragged away isn't reported
+            Bit* bit = const_cast<ChessSquare&>(_squares[index]).bit();
+            if (bit) {
+                state += std::to_string(bit->gameTag());
+            } else {
+                state += '0';
             }
         }
     }
@@ -224,17 +173,15 @@ void Grid::setStateString(const std::string& state)
 {
     size_t index = 0;
 
-    for (int y = 0; y < _height && index < state.length(); y++) {
-        for (int x = 0; x < _width && index < state.length(); x++) {
-            if (_enabled[y][x]) {
-                char pieceChar = state[index++];
+    for (int square = 0; square < _count && index < state.length(); square++) {
+        if (isEnabledIndex(square)) {
+            index++;
 
-                // Clear existing piece
-                _squares[y][x]->destroyBit();
+            // Clear existing piece
+            _squares[square].destroyBit();
 
-                // This method just sets the state - games need to create their own pieces
-                // when loading from state string based on the piece type
-            }
+            // This method just sets the state - games need to create their own pieces
+            // when loading from state string based on the piece type
         }
     }
 }
\ No newline at end of file
@@ -3,20 +3,24 @@
 #include "ChessSquare.h"
 #include <vector>
 #include <unordered_map>
-#include <functional>
+#include <iterator>
 #include <string>
+#include <cstdint>
 
 class Grid
 {
 public:
     Grid(int width, int height);
     ~Grid();
+    // the squares point back at our render revision
+    Grid(const Grid &) = delete;
+    Grid &operator=(const Grid &) = delete;
 
-    // Basic access
-    ChessSquare* getSquare(int x, int y);
-    ChessSquare* getSquareByIndex(int index);
-    bool isValid(int x, int y) const;
-    bool isEnabled(int x, int y) const;
+    // Basic access - squares are stored row by row in one contiguous array
+    ChessSquare* getSquare(int x, int y) { return isValid(x, y) ? &_squares[y * _width + x] : nullptr; }
+    ChessSquare* getSquareByIndex(int index) { return index >= 0 && index < _count ? &_squares[index] : nullptr; }
+    bool isValid(int x, int y) const { return x >= 0 && x < _width && y >= 0 && y < _height; }
+    bool isEnabled(int x, int y) const { return isValid(x, y) && isEnabledIndex(y * _width + x); }
     void setEnabled(int x, int y, bool enabled);
 
     // Grid properties
@@ -24,6 +28,8 @@ public:
     int getHeight() const { return _height; }
     int getIndex(int x, int y) const { return y * _width + x; }
     void getCoordinates(int index, int& x, int& y) const;
+    // changes whenever the squares or pieces a renderer would draw change shape
+    unsigned int renderRevision() const { return _renderRevision; }
 
     // Directional helpers (built into Grid)
     ChessSquare* getFL(int x, int y);  // front-left (up-left diagonal)
@@ -49,9 +55,74 @@ public:
     std::vector<ChessSquare*> getConnectedSquares(int x, int y);
     bool areConnected(int fromX, int fromY, int toX, int toY);
 
-    // Iterator support
-    void forEachSquare(std::function<void(ChessSquare*, int x, int y)> func);
-    void forEachEnabledSquare(std::function<void(ChessSquare*, int x, int y)> func);
+    // Iterator support - templated so the callback inlines instead of going through std::function
+    template <typename Func>
+    void forEachSquare(Func func)
+    {
+        ChessSquare* square = _squares.data();
+        for (int y = 0; y < _height; y++) {
+            for (int x = 0; x < _width; x++) {
+                func(square++, x, y);
+            }
+        }
+    }
+    template <typename Func>
+    void forEachEnabledSquare(Func func)
+    {
+        int index = 0;
+        for (int y = 0; y < _height; y++) {
+            for (int x = 0; x < _width; x++, index++) {
+                if (isEnabledIndex(index)) {
+                    func(&_squares[index], x, y);
+                }
+            }
+        }
+    }
+
+    // Range support - for (ChessSquare& square : grid.enabledSquares()) { ... }
+    class SquareIterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ChessSquare;
+        using difference_type = std::ptrdiff_t;
+        using pointer = ChessSquare*;
+        using reference = ChessSquare&;
+
+        SquareIterator(Grid* grid, int index, bool enabledOnly) : _grid(grid), _index(index), _enabledOnly(enabledOnly) { skipDisabled(); }
+
+        ChessSquare& operator*() const { return _grid->_squares[_index]; }
+        ChessSquare* operator->() const { return &_grid->_squares[_index]; }
+        SquareIterator& operator++() { _index++; skipDisabled(); return *this; }
+        SquareIterator operator++(int) { SquareIterator it = *this; ++(*this); return it; }
+        bool operator==(const SquareIterator& other) const { return _index == other._index; }
+        bool operator!=(const SquareIterator& other) const { return _index != other._index; }
+
+    private:
+        void skipDisabled()
+        {
+            while (_enabledOnly && _index < _grid->_count && !_grid->isEnabledIndex(_index)) {
+                _index++;
+            }
+        }
+        Grid* _grid;
+        int _index;
+        bool _enabledOnly;
+    };
+
+    class SquareRange
+    {
+    public:
+        SquareRange(Grid* grid, bool enabledOnly) : _grid(grid), _enabledOnly(enabledOnly) {}
+        SquareIterator begin() const { return SquareIterator(_grid, 0, _enabledOnly); }
+        SquareIterator end() const { return SquareIterator(_grid, _grid->_count, false); }
+    private:
+        Grid* _grid;
+        bool _enabledOnly;
+    };
+
+    SquareRange squares() { return SquareRange(this, false); }
+    SquareRange enabledSquares() { return SquareRange(this, true); }
 
     // Initialize squares with positions and sprites
     void initializeChessSquares(float squareSize, const char* spriteName);
@@ -63,9 +134,14 @@ public:
     void setStateString(const std::string& state);
 
 private:
-    std::vector<std::vector<ChessSquare*>> _squares;
-    std::vector<std::vector<bool>> _enabled;
+    bool isEnabledIndex(int index) const { return (_enabled[index >> 6] >> (index & 63)) & 1; }
+
+    std::vector<ChessSquare> _squares;
+    // one bit per square, boards up to 8x8 fit in a single word
+    std::vector<uint64_t> _enabled;
     std::unordered_map<int, std::vector<int>> _connections;
     int _width;
     int _height;
+    int _count;
+    unsigned int _renderRevision;
 };
\ No newline at end of file
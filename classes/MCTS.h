@@ -0,0 +1,448 @@
+#pragma once
+
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <condition_variable>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+//
+// generic monte carlo tree search (UCT) for any game state that can be copied and played
+// forward, spread across threads that share one tree
+//
+// a state plugs in with
+//   Move, MoveList                a move and a random access range of them
+//   generateMoves(list) const     the legal moves, none once the game is over
+//   make(move)                    play a move
+//   sideToMove() const            0 or 1
+//   result(side) const            for a finished game: 1 if side won, 0.5 drawn, 0 lost
+// and tree reuse between moves needs operator==
+//
+// the nodes live in a preallocated arena, each node's children side by side, so nothing is
+// allocated while searching. threads descend the same tree, counting a virtual loss on every
+// node they pass so the others spread out, and take it back once their playout is scored
+//
+// the extra threads are jobs on a pool the searches share, ThreadPool::sharedPool() unless
+// one is given, rather than threads of each search's own. a helper that only gets a worker
+// after the search has finished does nothing, so searches running on the pool themselves
+// never wait on jobs queued behind them, and however many boards search at once they keep
+// to the pool's threads
+//
+
+// a small fast generator for playouts, one per thread
+class MCTSRandom
+{
+public:
+    MCTSRandom(uint64_t seed) : _state(seed ? seed : 0x9e3779b97f4a7c15ULL) {}
+
+    uint64_t next()
+    {
+        // xorshift64*
+        _state ^= _state >> 12;
+        _state ^= _state << 25;
+        _state ^= _state >> 27;
+        return _state * 0x2545f4914f6cdd1dULL;
+    }
+
+    // uniform in [0, bound)
+    uint32_t below(uint32_t bound) { return (uint32_t)(((next() >> 32) * bound) >> 32); }
+
+private:
+    uint64_t _state;
+};
+
+template <typename State>
+concept MCTSState = std::semiregular<State> && requires(State &state, const State &view, const typename State::Move &move, typename State::MoveList &list, int side) {
+    requires std::ranges::random_access_range<typename State::MoveList>;
+    view.generateMoves(list);
+    state.make(move);
+    { view.sideToMove() } -> std::convertible_to<int>;
+    { view.result(side) } -> std::convertible_to<double>;
+};
+
+// the default playout policy, any legal move with equal chance
+struct RandomPlayout
+{
+    template <typename State, typename MoveList>
+    auto choose(const State &, const MoveList &list, MCTSRandom &random) const
+    {
+        return std::ranges::begin(list)[random.below((uint32_t)std::ranges::size(list))];
+    }
+};
+
+template <MCTSState State, typename Playout = RandomPlayout>
+class MCTS
+{
+public:
+    using Move = typename State::Move;
+    using MoveList = typename State::MoveList;
+
+    struct Limits
+    {
+        // 0 for no limit, but then maxIterations has to be set
+        int timeLimitMs = 1000;
+        uint64_t maxIterations = 0;
+    };
+
+    struct Result
+    {
+        // false when the root has no moves
+        bool hasMove = false;
+        // the most visited move
+        Move bestMove{};
+        uint32_t visits = 0;
+        // how often the side to move won the playouts through bestMove
+        double winRate = 0.0;
+        uint64_t iterations = 0;
+        size_t nodes = 0;
+        // the tree grown for an earlier search was picked up again
+        bool reused = false;
+    };
+
+    // threads 0 means the calling thread and one more per thread in the pool, nullptr for the
+    // pool means ThreadPool::sharedPool()
+    MCTS(size_t maxNodes = 1 << 18, int threads = 0, Playout playout = Playout(), ThreadPool *pool = nullptr)
+        : _playout(playout), _capacity(maxNodes), _current(0), _used(0), _hasRoot(false), _seed(0)
+    {
+        _pool = pool;
+        _threads = threads;
+        _exploration = 1.4;
+        _virtualLoss = 3;
+    }
+
+    void setExploration(double exploration) { _exploration = exploration; }
+    void setVirtualLoss(int virtualLoss) { _virtualLoss = std::max(1, virtualLoss); }
+    void setPlayout(const Playout &playout) { _playout = playout; }
+    // playouts draw from seed rather than the clock, so a single threaded search with an
+    // iteration limit repeats exactly. 0 goes back to the clock
+    void setSeed(uint64_t seed) { _seed = seed; }
+
+    // forget the tree, the next search starts fresh
+    void clear() { _hasRoot = false; }
+
+    Result search(const State &state, const Limits &limits)
+    {
+        Result result;
+        if (!_arenas[0]) {
+            _arenas[0] = std::make_unique<Node[]>(_capacity);
+            _arenas[1] = std::make_unique<Node[]>(_capacity);
+        }
+        result.reused = reuseTree(state);
+        if (!result.reused) {
+            _used = 1;
+            resetNode(arena()[0], Move{});
+        }
+        _rootState = state;
+        _hasRoot = true;
+
+        _stop = false;
+        _iterations = 0;
+        _limits = limits;
+        _start = std::chrono::steady_clock::now();
+        int threads = _threads;
+        if (threads != 1 && !_pool) {
+            _pool = &ThreadPool::sharedPool();
+        }
+        if (threads <= 0) {
+            threads = (int)_pool->size() + 1;
+        }
+        // helpers check in through the gate, which closes once this thread's share is done, so
+        // one that starts late leaves straight away without touching the tree
+        auto gate = std::make_shared<HelperGate>();
+        for (int thread = 1; thread < threads; thread++) {
+            _pool->submit([this, gate, thread]() {
+                {
+                    std::lock_guard<std::mutex> lock(gate->mutex);
+                    if (gate->closed) {
+                        return;
+                    }
+                    gate->running++;
+                }
+                work(thread);
+                std::lock_guard<std::mutex> lock(gate->mutex);
+                gate->running--;
+                gate->finished.notify_all();
+            });
+        }
+        work(0);
+        {
+            std::unique_lock<std::mutex> lock(gate->mutex);
+            gate->closed = true;
+            gate->finished.wait(lock, [&gate]() { return gate->running == 0; });
+        }
+
+        const Node &root = arena()[0];
+        result.iterations = _iterations;
+        result.nodes = std::min<size_t>(_used, _capacity);
+        if (root.expansion != kExpanded || root.childCount == 0) {
+            return result;
+        }
+        const Node *best = &arena()[root.firstChild];
+        for (uint32_t i = 1; i < root.childCount; i++) {
+            const Node &child = arena()[root.firstChild + i];
+            if (child.visits > best->visits) {
+                best = &child;
+            }
+        }
+        result.hasMove = true;
+        result.bestMove = best->move;
+        result.visits = best->visits;
+        result.winRate = best->visits ? best->score / (2.0 * best->visits) : 0.0;
+        return result;
+    }
+
+private:
+    // kFull is a leaf the arena had no room to expand, played out from for the rest of the search
+    enum Expansion : uint8_t { kLeaf, kExpanding, kExpanded, kFull };
+
+    struct Node
+    {
+        Move move;
+        uint32_t firstChild;
+        uint32_t childCount;
+        std::atomic<uint8_t> expansion;
+        std::atomic<uint32_t> visits;
+        // half points won by the side that played move, so a draw counts 1
+        std::atomic<uint32_t> score;
+    };
+
+    struct HelperGate
+    {
+        std::mutex mutex;
+        std::condition_variable finished;
+        int running = 0;
+        bool closed = false;
+    };
+
+    // deepest the tree walk goes, playouts themselves aren't limited
+    static const int kMaxDepth = 512;
+
+    Node *arena() { return _arenas[_current].get(); }
+
+    static void resetNode(Node &node, const Move &move)
+    {
+        node.move = move;
+        node.firstChild = 0;
+        node.childCount = 0;
+        node.expansion.store(kLeaf, std::memory_order_relaxed);
+        node.visits.store(0, std::memory_order_relaxed);
+        node.score.store(0, std::memory_order_relaxed);
+    }
+
+    void work(int thread)
+    {
+        MCTSRandom random(0x8badf00dULL * (thread + 1) + (_seed ? _seed : (uint64_t)_start.time_since_epoch().count()));
+        uint64_t done = 0;
+        while (!_stop.load(std::memory_order_relaxed)) {
+            iterate(random);
+            done++;
+            uint64_t total = _iterations.fetch_add(1, std::memory_order_relaxed) + 1;
+            if ((_limits.maxIterations > 0 && total >= _limits.maxIterations) || ((done & 15) == 0 && timeUp())) {
+                _stop = true;
+            }
+        }
+    }
+
+    bool timeUp() const
+    {
+        if (_limits.timeLimitMs <= 0) {
+            return false;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start);
+        return elapsed.count() >= _limits.timeLimitMs;
+    }
+
+    //
+    // one selection, expansion, playout and backup
+    //
+    void iterate(MCTSRandom &random)
+    {
+        Node *nodes = arena();
+        State state = _rootState;
+        uint32_t path[kMaxDepth];
+        // the side that played into each node on the path
+        int mover[kMaxDepth];
+        int length = 0;
+        uint32_t index = 0;
+        nodes[0].visits.fetch_add(_virtualLoss, std::memory_order_relaxed);
+        path[length] = 0;
+        mover[length++] = -1;
+
+        while (length < kMaxDepth) {
+            Node &node = nodes[index];
+            uint8_t expansion = node.expansion.load(std::memory_order_acquire);
+            if (expansion == kLeaf && node.expansion.compare_exchange_strong(expansion, kExpanding, std::memory_order_acquire)) {
+                node.expansion.store(expand(node, state) ? kExpanded : kFull, std::memory_order_release);
+                expansion = node.expansion.load(std::memory_order_relaxed);
+            }
+            // another thread is still filling its children in, or there's no room for them, so
+            // play out from here
+            if (expansion != kExpanded || node.childCount == 0) {
+                break;
+            }
+            index = select(node);
+            int side = state.sideToMove();
+            state.make(nodes[index].move);
+            nodes[index].visits.fetch_add(_virtualLoss, std::memory_order_relaxed);
+            path[length] = index;
+            mover[length++] = side;
+        }
+
+        MoveList list;
+        for (state.generateMoves(list); !std::ranges::empty(list); state.generateMoves(list)) {
+            state.make(_playout.choose(state, list, random));
+        }
+
+        for (int i = 0; i < length; i++) {
+            Node &node = nodes[path[i]];
+            if (mover[i] >= 0) {
+                node.score.fetch_add((uint32_t)std::lround(2.0 * state.result(mover[i])), std::memory_order_relaxed);
+            }
+            // the virtual loss becomes the one real visit
+            node.visits.fetch_sub(_virtualLoss - 1, std::memory_order_relaxed);
+        }
+    }
+
+    // give node its children, false if the arena hasn't room for them
+    bool expand(Node &node, const State &state)
+    {
+        MoveList list;
+        state.generateMoves(list);
+        uint32_t count = (uint32_t)std::ranges::size(list);
+        // reserve only what fits, so a full arena's count stays put however often it's asked
+        uint32_t first = _used.load(std::memory_order_relaxed);
+        do {
+            if (count > _capacity - first) {
+                return false;
+            }
+        } while (!_used.compare_exchange_weak(first, first + count, std::memory_order_relaxed));
+        Node *nodes = arena();
+        auto moves = std::ranges::begin(list);
+        for (uint32_t i = 0; i < count; i++) {
+            resetNode(nodes[first + i], moves[i]);
+        }
+        node.firstChild = first;
+        node.childCount = count;
+        return true;
+    }
+
+    // UCT, unvisited children first
+    uint32_t select(const Node &node)
+    {
+        Node *nodes = arena();
+        double logVisits = std::log((double)std::max<uint32_t>(1, node.visits.load(std::memory_order_relaxed)));
+        uint32_t best = node.firstChild;
+        double bestValue = -1.0;
+        for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; i++) {
+            uint32_t visits = nodes[i].visits.load(std::memory_order_relaxed);
+            if (visits == 0) {
+                return i;
+            }
+            double value = nodes[i].score.load(std::memory_order_relaxed) / (2.0 * visits) + _exploration * std::sqrt(logVisits / visits);
+            if (value > bestValue) {
+                bestValue = value;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    //
+    // look for state one or two moves below the last root (our move, then the reply) and
+    // copy that subtree to the front of the other arena, breadth first so children stay
+    // side by side
+    //
+    bool reuseTree(const State &state)
+    {
+        if constexpr (std::equality_comparable<State>) {
+            if (!_hasRoot) {
+                return false;
+            }
+            Node *nodes = arena();
+            int found = -1;
+            if (state == _rootState) {
+                found = 0;
+            }
+            const Node &root = nodes[0];
+            for (uint32_t i = 0; found < 0 && root.expansion == kExpanded && i < root.childCount; i++) {
+                State child = _rootState;
+                child.make(nodes[root.firstChild + i].move);
+                if (child == state) {
+                    found = (int)(root.firstChild + i);
+                    break;
+                }
+                const Node &node = nodes[root.firstChild + i];
+                for (uint32_t j = 0; node.expansion == kExpanded && j < node.childCount; j++) {
+                    State grandchild = child;
+                    grandchild.make(nodes[node.firstChild + j].move);
+                    if (grandchild == state) {
+                        found = (int)(node.firstChild + j);
+                        break;
+                    }
+                }
+            }
+            if (found < 0) {
+                return false;
+            }
+
+            Node *target = _arenas[_current ^ 1].get();
+            auto copyNode = [](Node &to, const Node &from) {
+                resetNode(to, from.move);
+                to.visits.store(from.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                to.score.store(from.score.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            };
+            copyNode(target[0], nodes[found]);
+            uint32_t used = 1;
+            std::vector<std::pair<uint32_t, uint32_t>> queue = { { 0, (uint32_t)found } };
+            for (size_t next = 0; next < queue.size(); next++) {
+                auto [to, from] = queue[next];
+                const Node &source = nodes[from];
+                if (source.expansion != kExpanded || source.childCount == 0) {
+                    continue;
+                }
+                target[to].firstChild = used;
+                target[to].childCount = source.childCount;
+                target[to].expansion.store(kExpanded, std::memory_order_relaxed);
+                for (uint32_t i = 0; i < source.childCount; i++) {
+                    copyNode(target[used + i], nodes[source.firstChild + i]);
+                    queue.push_back({ used + i, source.firstChild + i });
+                }
+                used += source.childCount;
+            }
+            _current ^= 1;
+            _used = used;
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    Playout _playout;
+    size_t _capacity;
+    std::unique_ptr<Node[]> _arenas[2];
+    // the arena the tree is in, the other one is where reuse copies it to
+    int _current;
+    std::atomic<uint32_t> _used;
+    State _rootState;
+    bool _hasRoot;
+
+    int _threads;
+    ThreadPool *_pool;
+    double _exploration;
+    int _virtualLoss;
+    uint64_t _seed;
+
+    Limits _limits;
+    std::atomic<bool> _stop;
+    std::atomic<uint64_t> _iterations;
+    std::chrono::steady_clock::time_point _start;
+};
@@ -262,9 +262,9 @@ const int BAttackSize[64] = {
   64,
 };
 
-// Attack lookup tables
-static uint64_t* RAttacks[64];
-static uint64_t* BAttacks[64];
+// Attack lookup tables, one copy shared by every file that includes this header
+inline uint64_t* RAttacks[64];
+inline uint64_t* BAttacks[64];
 
 // Magic bitboard shift amounts
 const int RShifts[64] = {
@@ -827,46 +827,52 @@ static inline uint64_t getQueenAttacks(int square, uint64_t occupied) {
     return getRookAttacks(square, occupied) | getBishopAttacks(square, occupied);
 }
 
-// Initialize magic bitboards
-void initMagicBitboards(void) {
-    int square, i;
-    uint64_t subset, index;
-
-    // Initialize rook attack tables
-    for (square = 0; square < 64; square++) {
-        RAttacks[square] = new uint64_t[RAttackSize[square]];
-        uint64_t mask = RMasks[square];
-        int bits = countOnes(mask);
-        int n = 1 << bits;
-
-        for (i = 0; i < n; i++) {
-            subset = indexToUint64(i, bits, mask);
-            index = (subset * RMagic[square]) >> RShifts[square];
-            RAttacks[square][index] = ratt(square, subset);
+// Fill the attack tables, only the first call does any work and it is safe to race
+inline void initMagicBitboards(void) {
+    static const bool initialized = [] {
+        int square, i;
+        uint64_t subset, index;
+
+        // Initialize rook attack tables
+        for (square = 0; square < 64; square++) {
+            RAttacks[square] = new uint64_t[RAttackSize[square]];
+            uint64_t mask = RMasks[square];
+            int bits = countOnes(mask);
+            int n = 1 << bits;
+
+            for (i = 0; i < n; i++) {
+                subset = indexToUint64(i, bits, mask);
+                index = (subset * RMagic[square]) >> RShifts[square];
+                RAttacks[square][index] = ratt(square, subset);
+            }
         }
-    }
 
-    // Initialize bishop attack tables
-    for (square = 0; square < 64; square++) {
-        BAttacks[square] = new uint64_t[BAttackSize[square]];
-        uint64_t mask = BMasks[square];
-        int bits = countOnes(mask);
-        int n = 1 << bits;
-
-        for (i = 0; i < n; i++) {
-            subset = indexToUint64(i, bits, mask);
-            index = (subset * BMagic[square]) >> BShifts[square];
-            BAttacks[square][index] = batt(square, subset);
+        // Initialize bishop attack tables
+        for (square = 0; square < 64; square++) {
+            BAttacks[square] = new uint64_t[BAttackSize[square]];
+            uint64_t mask = BMasks[square];
+            int bits = countOnes(mask);
+            int n = 1 << bits;
+
+            for (i = 0; i < n; i++) {
+                subset = indexToUint64(i, bits, mask);
+                index = (subset * BMagic[square]) >> BShifts[square];
+                BAttacks[square][index] = batt(square, subset);
+            }
         }
-    }
+        return true;
+    }();
+    (void)initialized;
 }
 
-// Cleanup magic bitboard tables
-void cleanupMagicBitboards(void) {
+// Cleanup magic bitboard tables, nothing may look attacks up afterwards
+inline void cleanupMagicBitboards(void) {
     int square;
     for (square = 0; square < 64; square++) {
         delete[] RAttacks[square];
         delete[] BAttacks[square];
+        RAttacks[square] = nullptr;
+        BAttacks[square] = nullptr;
     }
 }
 
@@ -0,0 +1,92 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+    _data = nullptr;
+    _size = 0;
+#if defined(_WIN32)
+    _file = nullptr;
+    _mapHandle = nullptr;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string &path)
+{
+    close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void *mapping = mapHandle ? MapViewOfFile(mapHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!mapping) {
+        if (mapHandle) {
+            CloseHandle(mapHandle);
+        }
+        CloseHandle(file);
+        return false;
+    }
+    _file = file;
+    _mapHandle = mapHandle;
+    _data = mapping;
+    _size = (size_t)fileSize.QuadPart;
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0) {
+        ::close(file);
+        return false;
+    }
+    void *mapping = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, file, 0);
+    // the mapping keeps the file alive
+    ::close(file);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    _data = mapping;
+    _size = (size_t)info.st_size;
+#endif
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (_data) {
+#if defined(_WIN32)
+        UnmapViewOfFile(_data);
+        CloseHandle(_mapHandle);
+        CloseHandle(_file);
+        _mapHandle = nullptr;
+        _file = nullptr;
+#else
+        munmap(_data, _size);
+#endif
+    }
+    _data = nullptr;
+    _size = 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+//
+// a whole file mapped read-only into memory. the pages are shared between every process that
+// maps the same file, which is what the solved tables rely on to stay cheap
+//
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // false if the file is missing, empty or can't be mapped
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const { return _data != nullptr; }
+
+    const char *data() const { return static_cast<const char *>(_data); }
+    size_t size() const { return _size; }
+
+private:
+    void *_data;
+    size_t _size;
+#if defined(_WIN32)
+    void *_file;
+    void *_mapHandle;
+#endif
+};
@@ -0,0 +1,627 @@
+#include "Match.h"
+#include "ChessAI.h"
+#include "CheckersAI.h"
+#include "Connect4Solver.h"
+#include "OthelloAI.h"
+#include "Search.h"
+#include "ThreadPool.h"
+#include "TicTacToeBoard.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+bool EngineConfig::parse(const std::string &text, EngineConfig &config, std::string &error)
+{
+    config = EngineConfig();
+    std::string settings = text;
+    std::size_t colon = text.find(':');
+    if (colon != std::string::npos) {
+        config.name = text.substr(0, colon);
+        settings = text.substr(colon + 1);
+    } else if (text.find('=') == std::string::npos) {
+        config.name = text;
+        settings.clear();
+    }
+
+    std::istringstream stream(settings);
+    std::string setting;
+    while (std::getline(stream, setting, ',')) {
+        std::size_t equals = setting.find('=');
+        if (equals == std::string::npos) {
+            error = "expected name=value, not \"" + setting + "\"";
+            return false;
+        }
+        std::string name = setting.substr(0, equals);
+        long long value = std::atoll(setting.c_str() + equals + 1);
+        if (name == "depth") {
+            config.maxDepth = (int)value;
+        } else if (name == "time") {
+            config.timeLimitMs = (int)value;
+        } else if (name == "nodes") {
+            config.nodeLimit = (uint64_t)value;
+        } else {
+            config.options.emplace_back(name, (int)value);
+        }
+    }
+    return true;
+}
+
+namespace {
+    // no bound at all gets the default time
+    int timeFor(const EngineConfig &config)
+    {
+        return (config.maxDepth == 0 && config.timeLimitMs == 0 && config.nodeLimit == 0) ? EngineConfig::kDefaultTimeMs : config.timeLimitMs;
+    }
+
+    // the games other than chess take no options and don't count nodes
+    bool checkPlain(const std::string &game, const EngineConfig &config, std::string &error)
+    {
+        if (!config.options.empty()) {
+            error = game + " has no option " + config.options[0].first;
+            return false;
+        }
+        if (config.nodeLimit != 0) {
+            error = game + " can't limit nodes";
+            return false;
+        }
+        return true;
+    }
+
+    template <typename List>
+    int randomIndex(std::mt19937_64 &random, const List &list)
+    {
+        return (int)(random() % (uint64_t)list.count);
+    }
+
+    //
+    // chess: checkmate, stalemate, the fifty move rule, insufficient material and threefold
+    // repetition, as the Chess game scores them
+    //
+    class ChessMatchGame : public MatchGame
+    {
+    public:
+        ChessMatchGame(const EngineConfig &first, const EngineConfig &second) : _board(ChessBoard::startPosition())
+        {
+            _configs[0] = first;
+            _configs[1] = second;
+            _positions.push_back(_board.hash());
+        }
+
+        bool configure(std::string &error)
+        {
+            for (int side = 0; side < 2; side++) {
+                ChessSearchParams params;
+                for (const auto &[name, value] : _configs[side].options) {
+                    if (!params.set(name, value)) {
+                        error = "chess has no option " + name;
+                        return false;
+                    }
+                }
+                _ai[side] = std::make_unique<ChessAI>();
+                _ai[side]->setParams(params);
+            }
+            return true;
+        }
+
+        int sideToMove() const override { return _board.sideToMove(); }
+
+        bool isOver() const override
+        {
+            ChessMoveList list;
+            _board.generateMoves(list);
+            return list.count == 0 || _board.halfmoveClock() >= 100 || _board.insufficientMaterial() || std::count(_positions.begin(), _positions.end(), _board.hash()) >= 3;
+        }
+
+        int result() const override
+        {
+            ChessMoveList list;
+            _board.generateMoves(list);
+            if (list.count == 0 && _board.inCheck()) {
+                return _board.sideToMove() == ChessBoard::kWhite ? -1 : 1;
+            }
+            return 0;
+        }
+
+        std::string playEngineMove() override
+        {
+            const EngineConfig &config = _configs[_board.sideToMove()];
+            ChessAI::Limits limits;
+            if (config.maxDepth > 0) {
+                limits.maxDepth = config.maxDepth;
+            }
+            limits.timeLimitMs = timeFor(config);
+            limits.nodeLimit = config.nodeLimit;
+            // everything but the position itself
+            limits.history.assign(_positions.begin(), _positions.end() - 1);
+            return play(_ai[_board.sideToMove()]->search(_board, limits).bestMove);
+        }
+
+        std::string playRandomMove(std::mt19937_64 &random) override
+        {
+            ChessMoveList list;
+            _board.generateMoves(list);
+            return play(list.moves[randomIndex(random, list)]);
+        }
+
+        std::string position() const override { return _board.fen(); }
+
+    private:
+        std::string play(const ChessMove &move)
+        {
+            std::string text = _board.toSAN(move);
+            ChessBoard::Undo undo;
+            _board.make(move, undo);
+            // nothing before a capture or pawn move can come round again
+            if (_board.halfmoveClock() == 0) {
+                _positions.clear();
+            }
+            _positions.push_back(_board.hash());
+            return text;
+        }
+
+        ChessBoard _board;
+        EngineConfig _configs[2];
+        std::unique_ptr<ChessAI> _ai[2];
+        std::vector<uint64_t> _positions;
+    };
+
+    //
+    // othello: a side with no moves passes, the game ends when neither can move
+    //
+    class OthelloMatchGame : public MatchGame
+    {
+    public:
+        OthelloMatchGame(const EngineConfig &first, const EngineConfig &second) : _board(OthelloBoard::initialPosition()), _side(0)
+        {
+            _configs[0] = first;
+            _configs[1] = second;
+        }
+
+        int sideToMove() const override { return _side; }
+        bool isOver() const override { return _board.isGameOver(); }
+
+        int result() const override
+        {
+            int score = _board.finalScore();
+            int sign = score > 0 ? 1 : (score < 0 ? -1 : 0);
+            return _side == 0 ? sign : -sign;
+        }
+
+        std::string playEngineMove() override
+        {
+            const EngineConfig &config = _configs[_side];
+            return play(_ai[_side].findMove(_board, config.maxDepth, timeFor(config)));
+        }
+
+        std::string playRandomMove(std::mt19937_64 &random) override
+        {
+            uint64_t moves = _board.legalMoves();
+            if (!moves) {
+                return play(-1);
+            }
+            for (int skip = (int)(random() % (uint64_t)std::popcount(moves)); skip > 0; skip--) {
+                moves &= moves - 1;
+            }
+            return play(std::countr_zero(moves));
+        }
+
+        // a character per square from the top left, '1' for black and '2' for white
+        std::string position() const override
+        {
+            uint64_t black = _side == 0 ? _board.player() : _board.opponent();
+            uint64_t white = _side == 0 ? _board.opponent() : _board.player();
+            std::string text;
+            for (int square = 0; square < 64; square++) {
+                text += (black >> square & 1) ? '1' : ((white >> square & 1) ? '2' : '0');
+            }
+            return text;
+        }
+
+    private:
+        std::string play(int square)
+        {
+            _side ^= 1;
+            if (square < 0) {
+                _board.pass();
+                return "pass";
+            }
+            _board.play(square);
+            return std::string(1, (char)('a' + square % 8)) + (char)('1' + square / 8);
+        }
+
+        OthelloBoard _board;
+        int _side;
+        EngineConfig _configs[2];
+        OthelloAI _ai[2];
+    };
+
+    //
+    // connect 4: the solver tries for an exact answer within the time limit, then falls back to
+    // a heuristic search of maxDepth plies, 12 by default as in the Connect4 game
+    //
+    class Connect4MatchGame : public MatchGame
+    {
+    public:
+        Connect4MatchGame(const EngineConfig &first, const EngineConfig &second) : _winner(-1)
+        {
+            _configs[0] = first;
+            _configs[1] = second;
+        }
+
+        int sideToMove() const override { return _board.moveCount() & 1; }
+        bool isOver() const override { return _winner >= 0 || _board.isFull(); }
+        int result() const override { return _winner < 0 ? 0 : (_winner == 0 ? 1 : -1); }
+
+        std::string playEngineMove() override
+        {
+            const EngineConfig &config = _configs[sideToMove()];
+            int time = config.timeLimitMs > 0 ? config.timeLimitMs : EngineConfig::kDefaultTimeMs;
+            int maxDepth = config.maxDepth > 0 ? config.maxDepth : 12;
+            return play(_solver[sideToMove()].findMove(_board, maxDepth, time));
+        }
+
+        std::string playRandomMove(std::mt19937_64 &random) override
+        {
+            int columns[Connect4Board::kWidth];
+            int count = 0;
+            for (int column = 0; column < Connect4Board::kWidth; column++) {
+                if (_board.canPlay(column)) {
+                    columns[count++] = column;
+                }
+            }
+            return play(columns[random() % (uint64_t)count]);
+        }
+
+        // the columns played so far, 1 to 7
+        std::string position() const override { return _history.empty() ? "-" : _history; }
+
+    private:
+        std::string play(int column)
+        {
+            if (_board.isWinningMove(column)) {
+                _winner = sideToMove();
+            }
+            _board.play(column);
+            std::string text(1, (char)('1' + column));
+            _history += text;
+            return text;
+        }
+
+        Connect4Board _board;
+        int _winner;
+        std::string _history;
+        EngineConfig _configs[2];
+        Connect4Solver _solver[2];
+    };
+
+    //
+    // checkers: a side with no moves has lost, and kDrawQuietMoves moves without a capture or a
+    // man moving is a draw, as in the Checkers game
+    //
+    class CheckersMatchGame : public MatchGame
+    {
+    public:
+        CheckersMatchGame(const EngineConfig &first, const EngineConfig &second) : _board(CheckersBoard::initialPosition()), _quietMoves(0), _ai{ nullptr, nullptr }
+        {
+            _configs[0] = first;
+            _configs[1] = second;
+        }
+
+        int sideToMove() const override { return _board.sideToMove(); }
+
+        bool isOver() const override
+        {
+            CheckersMoveList list;
+            _board.generateMoves(list);
+            return list.count == 0 || _quietMoves >= CheckersBoard::kDrawQuietMoves;
+        }
+
+        int result() const override
+        {
+            CheckersMoveList list;
+            _board.generateMoves(list);
+            if (list.count > 0) {
+                return 0;
+            }
+            return _board.sideToMove() == CheckersBoard::kRed ? -1 : 1;
+        }
+
+        std::string playEngineMove() override
+        {
+            // a worker plays its games one at a time, so it keeps one pair of engines for all of
+            // them rather than allocating two tables for every game, and only once it searches
+            if (!_ai[0]) {
+                thread_local CheckersAI engines[2];
+                for (int side = 0; side < 2; side++) {
+                    _ai[side] = &engines[side];
+                    _ai[side]->clear();
+                }
+            }
+            const EngineConfig &config = _configs[_board.sideToMove()];
+            CheckersMove move;
+            _ai[_board.sideToMove()]->findMove(_board, config.maxDepth, timeFor(config), move);
+            return play(move);
+        }
+
+        std::string playRandomMove(std::mt19937_64 &random) override
+        {
+            CheckersMoveList list;
+            _board.generateMoves(list);
+            return play(list.moves[randomIndex(random, list)]);
+        }
+
+        std::string position() const override { return _board.stateString(); }
+
+    private:
+        // squares numbered 1 to 32 as checkers notation does
+        std::string play(const CheckersMove &move)
+        {
+            std::string text;
+            for (int i = 0; i < move.length; i++) {
+                if (i) {
+                    text += move.isCapture() ? 'x' : '-';
+                }
+                text += std::to_string(move.path[i] + 1);
+            }
+            _quietMoves = _board.isQuiet(move) ? _quietMoves + 1 : 0;
+            _board.make(move);
+            return text;
+        }
+
+        CheckersBoard _board;
+        int _quietMoves;
+        EngineConfig _configs[2];
+        CheckersAI *_ai[2];
+    };
+
+    //
+    // tic tac toe, through the generic Search
+    //
+    class TicTacToeMatchGame : public MatchGame
+    {
+    public:
+        TicTacToeMatchGame(const EngineConfig &first, const EngineConfig &second)
+        {
+            _configs[0] = first;
+            _configs[1] = second;
+        }
+
+        int sideToMove() const override { return _board.sideToMove(); }
+
+        bool isOver() const override
+        {
+            TicTacToeBoard::MoveList list;
+            _board.generateMoves(list);
+            return list.count == 0;
+        }
+
+        int result() const override { return _board.hasLine(0) ? 1 : (_board.hasLine(1) ? -1 : 0); }
+
+        std::string playEngineMove() override
+        {
+            const EngineConfig &config = _configs[_board.sideToMove()];
+            Search<TicTacToeBoard>::Limits limits;
+            if (config.maxDepth > 0) {
+                limits.maxDepth = config.maxDepth;
+            }
+            limits.timeLimitMs = timeFor(config);
+            return play(_search[_board.sideToMove()].run(_board, limits).bestMove);
+        }
+
+        std::string playRandomMove(std::mt19937_64 &random) override
+        {
+            TicTacToeBoard::MoveList list;
+            _board.generateMoves(list);
+            return play(list.moves[randomIndex(random, list)]);
+        }
+
+        // the TicTacToe game's state string
+        std::string position() const override
+        {
+            std::string text;
+            for (int cell = 0; cell < 9; cell++) {
+                text += (_board.cells(0) >> cell & 1) ? '1' : ((_board.cells(1) >> cell & 1) ? '2' : '0');
+            }
+            return text;
+        }
+
+    private:
+        std::string play(int cell)
+        {
+            _board.make(cell);
+            return std::string(1, (char)('a' + cell % 3)) + (char)('1' + cell / 3);
+        }
+
+        TicTacToeBoard _board;
+        EngineConfig _configs[2];
+        Search<TicTacToeBoard> _search[2] = { Search<TicTacToeBoard>(1 << 12), Search<TicTacToeBoard>(1 << 12) };
+    };
+}
+
+const std::vector<std::string> &MatchGame::games()
+{
+    static const std::vector<std::string> names = { "chess", "othello", "connect4", "checkers", "tictactoe" };
+    return names;
+}
+
+std::unique_ptr<MatchGame> MatchGame::create(const std::string &game, const EngineConfig &first, const EngineConfig &second, std::string &error)
+{
+    if (game == "chess") {
+        auto chess = std::make_unique<ChessMatchGame>(first, second);
+        return chess->configure(error) ? std::move(chess) : nullptr;
+    }
+    if (std::find(games().begin(), games().end(), game) == games().end()) {
+        error = "unknown game " + game;
+        return nullptr;
+    }
+    if (!checkPlain(game, first, error) || !checkPlain(game, second, error)) {
+        return nullptr;
+    }
+    if (game == "othello") {
+        return std::make_unique<OthelloMatchGame>(first, second);
+    }
+    if (game == "connect4") {
+        return std::make_unique<Connect4MatchGame>(first, second);
+    }
+    if (game == "checkers") {
+        return std::make_unique<CheckersMatchGame>(first, second);
+    }
+    return std::make_unique<TicTacToeMatchGame>(first, second);
+}
+
+void MatchScore::add(int score)
+{
+    if (score > 0) {
+        wins++;
+    } else if (score < 0) {
+        losses++;
+    } else {
+        draws++;
+    }
+}
+
+double MatchScore::score() const
+{
+    return games() ? (wins + 0.5 * draws) / games() : 0.5;
+}
+
+double MatchScore::eloFromScore(double score)
+{
+    // a clean sweep is infinitely strong, keep it finite
+    score = std::clamp(score, 1e-6, 1 - 1e-6);
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+double MatchScore::elo() const
+{
+    return eloFromScore(score());
+}
+
+//
+// the per game variance of the score gives its standard error, and the interval is mapped
+// through the logistic curve to elo
+//
+double MatchScore::eloError() const
+{
+    if (games() == 0) {
+        return 0;
+    }
+    double mean = score();
+    double variance = (wins * (1 - mean) * (1 - mean) + draws * (0.5 - mean) * (0.5 - mean) + losses * mean * mean) / games();
+    double margin = 1.959964 * std::sqrt(variance / games());
+    return (eloFromScore(mean + margin) - eloFromScore(mean - margin)) / 2;
+}
+
+bool MatchSettings::parseArgument(const std::string &name, const std::string &value, std::string &error)
+{
+    error.clear();
+    if (name == "--game") {
+        game = value;
+    } else if (name == "--a" || name == "--b") {
+        if (!EngineConfig::parse(value, engines[name == "--a" ? 0 : 1], error)) {
+            error = name + ": " + error;
+            return false;
+        }
+    } else if (name == "--games") {
+        games = std::atoi(value.c_str());
+    } else if (name == "--random-plies") {
+        randomPlies = std::atoi(value.c_str());
+    } else if (name == "--seed") {
+        seed = std::strtoull(value.c_str(), nullptr, 10);
+    } else if (name == "--max-plies") {
+        maxPlies = std::atoi(value.c_str());
+    } else if (name == "--threads") {
+        threads = std::strtoull(value.c_str(), nullptr, 10);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void MatchSettings::nameEngines()
+{
+    for (int i = 0; i < 2; i++) {
+        if (engines[i].name.empty()) {
+            engines[i].name.assign(1, (char)('A' + i));
+        }
+    }
+}
+
+Match::Match(const MatchSettings &settings) : _settings(settings)
+{
+    _settings.nameEngines();
+}
+
+bool Match::validate(std::string &error) const
+{
+    return MatchGame::create(_settings.game, _settings.engines[0], _settings.engines[1], error) != nullptr;
+}
+
+void Match::run(const std::function<bool(const GameRecord &)> &onGame)
+{
+    ThreadPool pool(_settings.threads);
+    auto stopped = std::make_shared<std::atomic<bool>>(false);
+    std::vector<std::future<GameRecord>> records;
+    for (int index = 0; index < _settings.games; index++) {
+        records.push_back(pool.submit([this, index, stopped]() {
+            return stopped->load() ? GameRecord() : playGame(index);
+        }));
+    }
+    for (auto &record : records) {
+        GameRecord game = record.get();
+        if (!stopped->load() && !onGame(game)) {
+            stopped->store(true);
+        }
+    }
+}
+
+//
+// the pair's random generator makes the same opening for both its games, then the engines
+// take over until the game ends or runs past maxPlies
+//
+GameRecord Match::playGame(int index) const
+{
+    GameRecord record;
+    record.index = index;
+    record.pair = index / 2;
+    record.firstEngineFirst = index % 2 == 0;
+    const EngineConfig &first = _settings.engines[record.firstEngineFirst ? 0 : 1];
+    const EngineConfig &second = _settings.engines[record.firstEngineFirst ? 1 : 0];
+    std::string error;
+    std::unique_ptr<MatchGame> game = MatchGame::create(_settings.game, first, second, error);
+
+    std::mt19937_64 random(_settings.seed * 0x9e3779b97f4a7c15ull + (uint64_t)record.pair);
+    std::string moves;
+    int plies = 0;
+    for (; !game->isOver() && plies < _settings.maxPlies; plies++) {
+        std::string text = plies < _settings.randomPlies ? game->playRandomMove(random) : game->playEngineMove();
+        if (plies % 2 == 0) {
+            moves += std::to_string(plies / 2 + 1) + ". ";
+        }
+        moves += text + " ";
+        if (plies + 1 == _settings.randomPlies) {
+            moves += "{end of opening} ";
+        }
+    }
+    // past maxPlies it's a draw
+    int result = game->isOver() ? game->result() : 0;
+    record.plies = plies;
+    record.score = record.firstEngineFirst ? result : -result;
+
+    const char *resultText = result > 0 ? "1-0" : (result < 0 ? "0-1" : "1/2-1/2");
+    std::ostringstream log;
+    log << "[Event \"" << _settings.game << " match\"]\n";
+    log << "[Round \"" << index + 1 << "\"]\n";
+    log << "[White \"" << first.name << "\"]\n";
+    log << "[Black \"" << second.name << "\"]\n";
+    log << "[Result \"" << resultText << "\"]\n";
+    log << "[Final \"" << game->position() << "\"]\n";
+    if (!game->isOver()) {
+        log << "[Termination \"adjudicated a draw after " << plies << " plies\"]\n";
+    }
+    log << "\n" << moves << resultText << "\n\n";
+    record.log = log.str();
+    return record;
+}
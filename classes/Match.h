@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+//
+// one side of a match: a game's AI and how long it gets per move
+//
+struct EngineConfig
+{
+    std::string name;
+    // 0 leaves the bound to the game: a move that has none gets kDefaultTimeMs
+    int maxDepth = 0;
+    int timeLimitMs = 0;
+    // only chess counts nodes
+    uint64_t nodeLimit = 0;
+    // search options by name, as ChessSearchParams::set takes them
+    std::vector<std::pair<std::string, int>> options;
+
+    static const int kDefaultTimeMs = 100;
+
+    // "name:depth=6,time=100,nodes=50000,lmrBase=80", every part optional
+    static bool parse(const std::string &text, EngineConfig &config, std::string &error);
+};
+
+//
+// a game from the engine library played between two configurations, no UI involved. side 0
+// moves first (white, black discs, red, X), and each side is played by its own engine
+//
+class MatchGame
+{
+public:
+    // the names create() takes
+    static const std::vector<std::string> &games();
+    // nullptr, with error set, for an unknown game or an engine setting its AI doesn't have
+    static std::unique_ptr<MatchGame> create(const std::string &game, const EngineConfig &first, const EngineConfig &second, std::string &error);
+
+    virtual ~MatchGame() = default;
+
+    virtual int sideToMove() const = 0;
+    // won, lost or drawn by the game's own rules
+    virtual bool isOver() const = 0;
+    // 1 when side 0 won, -1 when side 1 won, 0 for a draw
+    virtual int result() const = 0;
+    // the side to move's engine picks a move and plays it, returned as text for the log
+    virtual std::string playEngineMove() = 0;
+    virtual std::string playRandomMove(std::mt19937_64 &random) = 0;
+    // a FEN for chess, the game's state string for the others
+    virtual std::string position() const = 0;
+};
+
+struct MatchSettings
+{
+    std::string game = "chess";
+    EngineConfig engines[2];
+    // played in pairs, each opening once with either engine moving first
+    int games = 100;
+    // random moves played from the start position to make each pair's opening
+    int randomPlies = 4;
+    uint64_t seed = 1;
+    // a game still going after this many plies is scored a draw
+    int maxPlies = 400;
+    // 0 for one per hardware thread
+    size_t threads = 0;
+
+    // one command line setting: --game, --a, --b, --games, --random-plies, --seed, --max-plies
+    // or --threads. false with error set for a bad value, or with error empty for a name that
+    // isn't one of these
+    bool parseArgument(const std::string &name, const std::string &value, std::string &error);
+    // engines without a name are called A and B
+    void nameEngines();
+};
+
+struct GameRecord
+{
+    int index = 0;
+    // games 2n and 2n + 1 share an opening
+    int pair = 0;
+    // engines[0] moved first
+    bool firstEngineFirst = true;
+    // from engines[0]'s point of view: 1 win, 0 draw, -1 loss
+    int score = 0;
+    int plies = 0;
+    // PGN style: tags, then the moves with the random opening marked
+    std::string log;
+};
+
+//
+// a match's results from engines[0]'s point of view
+//
+struct MatchScore
+{
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+
+    void add(int score);
+    int games() const { return wins + draws + losses; }
+    // points per game, 0 to 1
+    double score() const;
+    // the elo difference the score implies, and the half width of its 95% confidence interval
+    double elo() const;
+    double eloError() const;
+
+    static double eloFromScore(double score);
+};
+
+//
+// plays a match across a thread pool, one job per game with fresh engines
+//
+class Match
+{
+public:
+    Match(const MatchSettings &settings);
+
+    // false, with error set, if the game or an engine can't be set up
+    bool validate(std::string &error) const;
+
+    // plays the games, handing each one to onGame as it finishes, in game order. returning
+    // false from onGame stops the match, games already underway are finished and dropped
+    void run(const std::function<bool(const GameRecord &)> &onGame);
+
+private:
+    GameRecord playGame(int index) const;
+
+    MatchSettings _settings;
+};
@@ -1,16 +1,19 @@
 #include "Othello.h"
+#include "BitPool.h"
 #include <iostream>
+#include <bit>
 
-// Define the 8 directions: N, NE, E, SE, S, SW, W, NW
-const int Othello::DIRECTIONS[8][2] = {
-    {0, -1}, {1, -1}, {1, 0}, {1, 1},
-    {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}
-};
+// how long the AI may think about a move
+static const int kAIThinkTimeMs = 1000;
 
 Othello::Othello() : Game() {
     _grid = new Grid(8, 8);
     _consecutivePasses = 0;
     _showingHints = false;
+    _discs[BLACK_PLAYER] = 0;
+    _discs[WHITE_PLAYER] = 0;
+    // search depth for the midgame, the endgame is solved exactly once it's in reach
+    _gameOptions.AIMAXDepth = 10;
 }
 
 Othello::~Othello() {
@@ -24,21 +27,11 @@ void Othello::setUpBoard() {
 
     _grid->initializeSquares(80, "boardsquare.png");
 
-    // Set up initial four pieces in the center
-    Player* blackPlayer = getPlayerAt(BLACK_PLAYER);
-    Player* whitePlayer = getPlayerAt(WHITE_PLAYER);
-
-    // Standard Othello starting position
-    auto placePiece = [&](int x, int y, Player* player) {
-        Bit* piece = createPiece(player);
-        piece->setPosition(_grid->getSquare(x, y)->getPosition());
-        _grid->getSquare(x, y)->setBit(piece);
-    };
-
-    placePiece(3, 3, whitePlayer);  // White at (3,3)
-    placePiece(4, 4, whitePlayer);  // White at (4,4)
-    placePiece(4, 3, blackPlayer);  // Black at (4,3)
-    placePiece(3, 4, blackPlayer);  // Black at (3,4)
+    // Standard Othello starting position, white at (3,3) and (4,4), black at (4,3) and (3,4)
+    OthelloBoard start = OthelloBoard::initialPosition();
+    _discs[BLACK_PLAYER] = start.player();
+    _discs[WHITE_PLAYER] = start.opponent();
+    syncGrid();
 
     if (gameHasAI()) {
         setAIPlayer(AI_PLAYER);
@@ -48,10 +41,11 @@ void Othello::setUpBoard() {
 }
 
 Bit* Othello::createPiece(Player* player) {
-    Bit* bit = new Bit();
-    bit->LoadTextureFromFile(player == getPlayerAt(BLACK_PLAYER) ? "o.png" : "x.png");
-    bit->setOwner(player);
-    return bit;
+    return BitPool::sharedPool().acquire(player, spriteForPlayer(player));
+}
+
+const char* Othello::spriteForPlayer(Player* player) const {
+    return player == getPlayerAt(BLACK_PLAYER) ? "o.png" : "x.png";
 }
 
 bool Othello::actionForEmptyHolder(BitHolder &holder) {
@@ -98,82 +92,46 @@ bool Othello::canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
 }
 
 bool Othello::isValidMove(int x, int y, Player* player) const {
-    if (!_grid->isValid(x, y) || _grid->getSquare(x, y)->bit()) return false;
-
-    // Check if placing a piece here would flip at least one opponent piece
-    for (int i = 0; i < 8; i++) {
-        if (checkDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player) > 0) {
-            return true;
-        }
-    }
-    return false;
+    if (!_grid->isValid(x, y)) return false;
+    return (legalMoves(player) >> (y * 8 + x)) & 1;
 }
 
-int Othello::checkDirection(int x, int y, int dx, int dy, Player* player) const {
-    int count = 0;
-    int nx = x + dx;
-    int ny = y + dy;
-
-    if (!_grid->isValid(nx, ny)) return 0;
-
-    Bit* firstPiece = _grid->getSquare(nx, ny)->bit();
-    if (!firstPiece || firstPiece->getOwner() == player) return 0;
-
-    // Count opponent pieces in this direction
-    while (_grid->isValid(nx, ny)) {
-        Bit* piece = _grid->getSquare(nx, ny)->bit();
-        if (!piece) return 0;
-        if (piece->getOwner() == player) return count;
-        count++;
-        nx += dx;
-        ny += dy;
-    }
-    return 0;
+uint64_t Othello::legalMoves(Player* player) const {
+    int me = player->playerNumber();
+    return OthelloBoard::legalMoves(_discs[me], _discs[1 - me]);
 }
 
+//
+// update the bitboards for a move at (x, y) and mirror the flipped discs on the grid
+//
 void Othello::flipPieces(int x, int y, Player* player) {
-    for (int i = 0; i < 8; i++) {
-        int count = checkDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player);
-        if (count > 0) {
-            flipInDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player, count);
-        }
-    }
-}
-
-void Othello::flipInDirection(int x, int y, int dx, int dy, Player* player, int count) {
-    int nx = x + dx;
-    int ny = y + dy;
-
-    for (int i = 0; i < count; i++) {
-        ChessSquare* square = _grid->getSquare(nx, ny);
-        if (square && square->bit()) {
-            square->destroyBit();
-            Bit* newPiece = createPiece(player);
-            newPiece->setPosition(square->getPosition());
-            square->setBit(newPiece);
-        }
-        nx += dx;
-        ny += dy;
+    int me = player->playerNumber();
+    int square = y * 8 + x;
+    uint64_t flipped = OthelloBoard::flips(_discs[me], _discs[1 - me], square);
+    _discs[me] |= flipped | (1ULL << square);
+    _discs[1 - me] &= ~flipped;
+
+    const char* sprite = spriteForPlayer(player);
+    while (flipped) {
+        ChessSquare* flippedSquare = _grid->getSquareByIndex(std::countr_zero(flipped));
+        // flip the disc in place rather than replacing it
+        BitPool::sharedPool().skin(flippedSquare->bit(), player, sprite);
+        flipped &= flipped - 1;
     }
 }
 
 bool Othello::hasValidMove(Player* player) const {
-    bool hasMove = false;
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        if (!hasMove && isValidMove(x, y, player)) {
-            hasMove = true;
-        }
-    });
-    return hasMove;
+    return legalMoves(player) != 0;
 }
 
 std::vector<std::pair<int, int>> Othello::getValidMoves(Player* player) const {
     std::vector<std::pair<int, int>> moves;
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        if (isValidMove(x, y, player)) {
-            moves.push_back({x, y});
-        }
-    });
+    uint64_t legal = legalMoves(player);
+    while (legal) {
+        int square = std::countr_zero(legal);
+        moves.push_back({square % 8, square / 8});
+        legal &= legal - 1;
+    }
     return moves;
 }
 
@@ -190,10 +148,7 @@ Player* Othello::checkForWinner() {
     }
 
     // Check if board is full
-    bool boardFull = true;
-    _grid->forEachSquare([&boardFull](ChessSquare* square, int x, int y) {
-        if (!square->bit()) boardFull = false;
-    });
+    bool boardFull = isBoardFull();
 
     if (boardFull) {
         int blackCount, whiteCount;
@@ -213,10 +168,7 @@ bool Othello::checkForDraw() {
         return blackCount == whiteCount;
     }
 
-    bool boardFull = true;
-    _grid->forEachSquare([&boardFull](ChessSquare* square, int x, int y) {
-        if (!square->bit()) boardFull = false;
-    });
+    bool boardFull = isBoardFull();
 
     if (boardFull) {
         int blackCount, whiteCount;
@@ -227,28 +179,48 @@ bool Othello::checkForDraw() {
 }
 
 void Othello::countPieces(int &blackCount, int &whiteCount) const {
-    blackCount = 0;
-    whiteCount = 0;
-
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        Bit* piece = square->bit();
-        if (piece) {
-            if (piece->getOwner() == getPlayerAt(BLACK_PLAYER)) {
-                blackCount++;
-            } else {
-                whiteCount++;
-            }
-        }
-    });
+    blackCount = std::popcount(_discs[BLACK_PLAYER]);
+    whiteCount = std::popcount(_discs[WHITE_PLAYER]);
+}
+
+bool Othello::isBoardFull() const {
+    return (_discs[BLACK_PLAYER] | _discs[WHITE_PLAYER]) == ~0ULL;
 }
 
 void Othello::stopGame() {
     _grid->forEachSquare([](ChessSquare* square, int x, int y) {
         square->destroyBit();
     });
+    _discs[BLACK_PLAYER] = 0;
+    _discs[WHITE_PLAYER] = 0;
     _consecutivePasses = 0;
 }
 
+//
+// make the grid match the bitboards, reusing the discs already on the board
+//
+void Othello::syncGrid() {
+    for (ChessSquare& square : _grid->squares()) {
+        uint64_t mask = 1ULL << square.getSquareIndex();
+        Player* owner = nullptr;
+        if (_discs[BLACK_PLAYER] & mask) {
+            owner = getPlayerAt(BLACK_PLAYER);
+        } else if (_discs[WHITE_PLAYER] & mask) {
+            owner = getPlayerAt(WHITE_PLAYER);
+        }
+        Bit* bit = square.bit();
+        if (!owner) {
+            square.destroyBit();
+        } else if (!bit) {
+            Bit* piece = createPiece(owner);
+            piece->setPosition(square.getPosition());
+            square.setBit(piece);
+        } else if (bit->getOwner() != owner) {
+            BitPool::sharedPool().skin(bit, owner, spriteForPlayer(owner));
+        }
+    }
+}
+
 std::string Othello::initialStateString() {
     std::string state(64, '0');
     state[3 * 8 + 3] = '2';  // White at (3,3)
@@ -259,72 +231,78 @@ std::string Othello::initialStateString() {
 }
 
 std::string Othello::stateString() {
-    std::string state;
-    _grid->forEachSquare([&state, this](ChessSquare* square, int x, int y) {
-        Bit* bit = square->bit();
-        if (!bit) {
-            state += '0';
-        } else if (bit->getOwner() == getPlayerAt(BLACK_PLAYER)) {
-            state += '1';
-        } else {
-            state += '2';
-        }
-    });
-    return state;
+    return stateFromDiscs(_discs[BLACK_PLAYER], _discs[WHITE_PLAYER]);
 }
 
 void Othello::setStateString(const std::string &s) {
     if (s.length() != 64) return;
 
-    int index = 0;
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        if (index < s.length()) {
-            char pieceType = s[index++];
-            square->destroyBit();
-
-            if (pieceType == '1') {
-                Bit* piece = createPiece(getPlayerAt(BLACK_PLAYER));
-                piece->setPosition(square->getPosition());
-                square->setBit(piece);
-            } else if (pieceType == '2') {
-                Bit* piece = createPiece(getPlayerAt(WHITE_PLAYER));
-                piece->setPosition(square->getPosition());
-                square->setBit(piece);
-            }
+    discsFromState(s, _discs[BLACK_PLAYER], _discs[WHITE_PLAYER]);
+    syncGrid();
+}
+
+std::string Othello::stateFromDiscs(uint64_t black, uint64_t white) {
+    std::string state(64, '0');
+    for (int square = 0; square < 64; square++) {
+        if ((black >> square) & 1) {
+            state[square] = '1';
+        } else if ((white >> square) & 1) {
+            state[square] = '2';
         }
-    });
+    }
+    return state;
+}
+
+void Othello::discsFromState(const std::string &state, uint64_t &black, uint64_t &white) {
+    black = 0;
+    white = 0;
+    for (size_t square = 0; square < 64 && square < state.length(); square++) {
+        if (state[square] == '1') {
+            black |= 1ULL << square;
+        } else if (state[square] == '2') {
+            white |= 1ULL << square;
+        }
+    }
 }
 
 void Othello::updateAI() {
     if (!gameHasAI()) return;
 
-    Player* aiPlayer = getCurrentPlayer();
-    std::vector<std::pair<int, int>> validMoves = getValidMoves(aiPlayer);
+    applyAIMove(searchAIMove(stateString(), getCurrentPlayer()->playerNumber(), aiOptions()));
+}
 
-    if (validMoves.empty()) {
-        _consecutivePasses++;
-        endTurn();
-        return;
+//
+// runs on a worker thread from a state snapshot, returns the square index or "pass"
+//
+std::string Othello::searchAIMove(const std::string &state, int playerNumber, const AIOptions &options) {
+    uint64_t discs[2];
+    discsFromState(state, discs[BLACK_PLAYER], discs[WHITE_PLAYER]);
+    OthelloBoard board(discs[playerNumber], discs[1 - playerNumber]);
+
+    int bestMove;
+    if (options.useMCTS) {
+        MCTS<OthelloMCTSState>::Result result = _mcts.search(OthelloMCTSState(board, playerNumber), { kAIThinkTimeMs, 0 });
+        bestMove = result.hasMove ? result.bestMove : -1;
+    } else {
+        bestMove = _ai.findMove(board, options.maxDepth, kAIThinkTimeMs);
     }
-
-    // Find move that flips the most pieces
-    int bestX = -1, bestY = -1, maxFlips = 0;
-
-    for (const auto& move : validMoves) {
-        int x = move.first, y = move.second, totalFlips = 0;
-        for (int i = 0; i < 8; i++) {
-            totalFlips += checkDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], aiPlayer);
-        }
-        if (totalFlips > maxFlips) {
-            maxFlips = totalFlips;
-            bestX = x;
-            bestY = y;
-        }
+    if (bestMove < 0) {
+        return "pass";
     }
+    return std::to_string(bestMove);
+}
 
-    if (bestX >= 0 && bestY >= 0) {
-        actionForEmptyHolder(*_grid->getSquare(bestX, bestY));
+bool Othello::applyAIMove(const std::string &move) {
+    if (move.empty()) {
+        return false;
+    }
+    if (move == "pass") {
+        _consecutivePasses++;
+        endTurn();
+        return true;
     }
+    ChessSquare* square = _grid->getSquareByIndex(std::stoi(move));
+    return square && actionForEmptyHolder(*square);
 }
 
 void Othello::getBoardPosition(BitHolder& holder, int &x, int &y) const {
@@ -1,5 +1,8 @@
 #pragma once
 #include "Game.h"
+#include "OthelloBoard.h"
+#include "OthelloAI.h"
+#include "OthelloMCTS.h"
 #include <vector>
 
 // NOTE: This implementation assumes black.png and white.png exist in resources.
@@ -26,6 +29,10 @@ public:
     // AI methods
     void        updateAI() override;
     bool        gameHasAI() override { return true; } // Set to true when AI is implemented
+    bool        gameHasBackgroundAI() override { return true; }
+    bool        gameHasMCTS() override { return true; }
+    std::string searchAIMove(const std::string &state, int playerNumber, const AIOptions &options) override;
+    bool        applyAIMove(const std::string &move) override;
     Grid* getGrid() override { return _grid; }
 
 private:
@@ -33,28 +40,36 @@ private:
     static const int BLACK_PLAYER = 0;
     static const int WHITE_PLAYER = 1;
 
-    // Direction vectors for checking all 8 directions
-    static const int DIRECTIONS[8][2];
-
     // Helper methods
     Bit*        createPiece(Player* player);
+    const char* spriteForPlayer(Player* player) const;
     bool        isValidMove(int x, int y, Player* player) const;
-    int         checkDirection(int x, int y, int dx, int dy, Player* player) const;
+    uint64_t    legalMoves(Player* player) const;
     void        flipPieces(int x, int y, Player* player);
-    void        flipInDirection(int x, int y, int dx, int dy, Player* player, int count);
     bool        hasValidMove(Player* player) const;
     void        countPieces(int &blackCount, int &whiteCount) const;
+    bool        isBoardFull() const;
     std::vector<std::pair<int, int>> getValidMoves(Player* player) const;
     void        showValidMoves(Player* player);
     void        clearValidMoveIndicators();
+    void        syncGrid();
+
+    // state strings <-> bitboards, '1' black and '2' white
+    static std::string stateFromDiscs(uint64_t black, uint64_t white);
+    static void discsFromState(const std::string &state, uint64_t &black, uint64_t &white);
 
     // Board position helper
     void        getBoardPosition(BitHolder& holder, int &x, int &y) const;
 
-    // Board representation
+    // Board representation, the bitboards are the rules and the grid mirrors them
     Grid*       _grid;
+    uint64_t    _discs[2];
 
     // Game state
     int         _consecutivePasses;
     bool        _showingHints;
+
+    // only ever used by this game's one pending AI job
+    OthelloAI   _ai;
+    MCTS<OthelloMCTSState> _mcts;
 };
\ No newline at end of file
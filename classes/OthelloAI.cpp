@@ -0,0 +1,287 @@
+#include "OthelloAI.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+    const uint64_t kNotFileA = 0xfefefefefefefefeULL;
+    const uint64_t kNotFileH = 0x7f7f7f7f7f7f7f7fULL;
+    const uint64_t kCorners = 0x8100000000000081ULL;
+
+    // corner, its x square and its two c squares
+    const int kCornerSquares[4][4] = { { 0, 9, 1, 8 }, { 7, 14, 6, 15 }, { 56, 49, 57, 48 }, { 63, 54, 62, 55 } };
+    // the two edges leaving each corner
+    const int kEdgeSteps[4][2] = { { 1, 8 }, { -1, 8 }, { 1, -8 }, { -1, -8 } };
+
+    // static ordering weights, corners first and the squares next to them last
+    const int kSquareWeights[64] = {
+        100, -20, 10,  5,  5, 10, -20, 100,
+        -20, -50, -2, -2, -2, -2, -50, -20,
+         10,  -2, -1, -1, -1, -1,  -2,  10,
+          5,  -2, -1, -1, -1, -1,  -2,   5,
+          5,  -2, -1, -1, -1, -1,  -2,   5,
+         10,  -2, -1, -1, -1, -1,  -2,  10,
+        -20, -50, -2, -2, -2, -2, -50, -20,
+        100, -20, 10,  5,  5, 10, -20, 100
+    };
+
+    uint64_t neighbours(uint64_t bits)
+    {
+        uint64_t sideways = ((bits << 1) & kNotFileA) | ((bits >> 1) & kNotFileH);
+        uint64_t row = bits | sideways;
+        return sideways | (row << 8) | (row >> 8);
+    }
+
+    // discs anchored on an owned corner and running unbroken along its edges
+    int edgeStable(uint64_t discs)
+    {
+        uint64_t stable = 0;
+        for (int corner = 0; corner < 4; corner++) {
+            int square = kCornerSquares[corner][0];
+            if (!((discs >> square) & 1)) {
+                continue;
+            }
+            for (int edge = 0; edge < 2; edge++) {
+                int step = kEdgeSteps[corner][edge];
+                for (int i = 0, at = square; i < 8 && ((discs >> at) & 1); i++, at += step) {
+                    stable |= 1ULL << at;
+                }
+            }
+        }
+        return std::popcount(stable);
+    }
+
+    int terminalScore(const OthelloBoard &board)
+    {
+        int score = board.finalScore();
+        if (score > 0) return OthelloAI::kWinScore + score;
+        if (score < 0) return -OthelloAI::kWinScore + score;
+        return 0;
+    }
+}
+
+OthelloAI::OthelloAI(size_t tableEntries)
+{
+    // round down to a power of two so the hash can be masked
+    size_t size = 1;
+    while (size * 2 <= tableEntries) {
+        size *= 2;
+    }
+    _table.assign(size, TableEntry{ 0, 0, 0, 0, kNone, -1 });
+    _nodes = 0;
+    _aborted = false;
+    _timeLimitMs = 0;
+    _lastScore = 0;
+    _lastDepth = 0;
+    _lastExact = false;
+}
+
+int OthelloAI::evaluate(const OthelloBoard &board)
+{
+    uint64_t player = board.player();
+    uint64_t opponent = board.opponent();
+    uint64_t empty = board.empties();
+
+    int score = 0;
+
+    // mobility, and potential mobility through the discs that touch empty squares
+    score += 12 * (std::popcount(OthelloBoard::legalMoves(player, opponent)) - std::popcount(OthelloBoard::legalMoves(opponent, player)));
+    uint64_t frontier = neighbours(empty);
+    score += 4 * (std::popcount(frontier & opponent) - std::popcount(frontier & player));
+
+    // corners, and the squares that give them away while they're still empty
+    score += 100 * (std::popcount(player & kCorners) - std::popcount(opponent & kCorners));
+    for (int corner = 0; corner < 4; corner++) {
+        if (!((empty >> kCornerSquares[corner][0]) & 1)) {
+            continue;
+        }
+        uint64_t xSquare = 1ULL << kCornerSquares[corner][1];
+        uint64_t cSquares = (1ULL << kCornerSquares[corner][2]) | (1ULL << kCornerSquares[corner][3]);
+        score -= 40 * (std::popcount(player & xSquare) - std::popcount(opponent & xSquare));
+        score -= 15 * (std::popcount(player & cSquares) - std::popcount(opponent & cSquares));
+    }
+
+    score += 25 * (edgeStable(player) - edgeStable(opponent));
+    return score;
+}
+
+bool OthelloAI::timeUp()
+{
+    if (_timeLimitMs <= 0) {
+        return false;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start);
+    return elapsed.count() >= _timeLimitMs;
+}
+
+OthelloAI::TableEntry *OthelloAI::probe(const OthelloBoard &board)
+{
+    uint64_t hash = board.player() * 0x9e3779b97f4a7c15ULL ^ board.opponent() * 0xc2b2ae3d27d4eb4fULL;
+    TableEntry *entry = &_table[(hash ^ (hash >> 29)) & (_table.size() - 1)];
+    return (entry->bound != kNone && entry->player == board.player() && entry->opponent == board.opponent()) ? entry : nullptr;
+}
+
+void OthelloAI::store(const OthelloBoard &board, int depth, int score, Bound bound, int bestMove)
+{
+    uint64_t hash = board.player() * 0x9e3779b97f4a7c15ULL ^ board.opponent() * 0xc2b2ae3d27d4eb4fULL;
+    TableEntry &entry = _table[(hash ^ (hash >> 29)) & (_table.size() - 1)];
+    entry = TableEntry{ board.player(), board.opponent(), score, (int8_t)depth, bound, (int8_t)bestMove };
+}
+
+//
+// fills ordered with the moves best first: table move, then square weights and fewest replies
+//
+int OthelloAI::orderMoves(const OthelloBoard &board, uint64_t moves, int ttMove, int *ordered)
+{
+    int scores[64];
+    int count = 0;
+    while (moves) {
+        int square = std::countr_zero(moves);
+        moves &= moves - 1;
+        OthelloBoard child = board;
+        child.play(square);
+        int replies = std::popcount(child.legalMoves());
+        int score = kSquareWeights[square] - 8 * replies;
+        if (square == ttMove) {
+            score = kInfinite;
+        }
+        // insertion sort, there are rarely more than a dozen moves
+        int at = count++;
+        while (at > 0 && scores[at - 1] < score) {
+            scores[at] = scores[at - 1];
+            ordered[at] = ordered[at - 1];
+            at--;
+        }
+        scores[at] = score;
+        ordered[at] = square;
+    }
+    return count;
+}
+
+int OthelloAI::negascout(const OthelloBoard &board, int depth, int alpha, int beta)
+{
+    _nodes++;
+    if ((_nodes & 4095) == 0 && timeUp()) {
+        _aborted = true;
+    }
+    if (_aborted) {
+        return 0;
+    }
+
+    uint64_t moves = board.legalMoves();
+    if (!moves) {
+        OthelloBoard passed = board;
+        passed.pass();
+        if (!passed.legalMoves()) {
+            return terminalScore(board);
+        }
+        // a pass doesn't use up depth
+        return -negascout(passed, depth, -beta, -alpha);
+    }
+    if (depth <= 0) {
+        return evaluate(board);
+    }
+
+    int ttMove = -1;
+    if (TableEntry *entry = probe(board)) {
+        ttMove = entry->bestMove;
+        if (entry->depth >= depth) {
+            if (entry->bound == kExact) return entry->score;
+            if (entry->bound == kLower && entry->score >= beta) return entry->score;
+            if (entry->bound == kUpper && entry->score <= alpha) return entry->score;
+        }
+    }
+
+    int ordered[64];
+    int count = orderMoves(board, moves, ttMove, ordered);
+    int originalAlpha = alpha;
+    int bestScore = -kInfinite;
+    int bestMove = ordered[0];
+    for (int i = 0; i < count; i++) {
+        OthelloBoard child = board;
+        child.play(ordered[i]);
+        int score;
+        if (i == 0) {
+            score = -negascout(child, depth - 1, -beta, -alpha);
+        } else {
+            // prove the remaining moves are worse with a null window, re-search if one isn't
+            score = -negascout(child, depth - 1, -alpha - 1, -alpha);
+            if (score > alpha && score < beta) {
+                score = -negascout(child, depth - 1, -beta, -score);
+            }
+        }
+        if (_aborted) {
+            return 0;
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = ordered[i];
+        }
+        if (score > alpha) {
+            alpha = score;
+        }
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    Bound bound = bestScore <= originalAlpha ? kUpper : (bestScore >= beta ? kLower : kExact);
+    store(board, depth, bestScore, bound, bestMove);
+    return bestScore;
+}
+
+int OthelloAI::solve(const OthelloBoard &board, int timeLimitMs, int *bestMove)
+{
+    int score = _endgame.solve(board, timeLimitMs, bestMove);
+    _nodes += _endgame.nodes();
+    return score == OthelloEndgame::kAborted ? kInfinite : score;
+}
+
+int OthelloAI::findMove(const OthelloBoard &board, int maxDepth, int timeLimitMs)
+{
+    _nodes = 0;
+    _lastExact = false;
+    uint64_t moves = board.legalMoves();
+    if (!moves) {
+        return -1;
+    }
+
+    int empties = board.emptyCount();
+    bool tryExact = empties <= kExactEmpties;
+    int depthLimit = (maxDepth > 0) ? std::min(maxDepth, empties) : empties;
+
+    // leave most of the budget to the exact solver when it's in reach
+    _aborted = false;
+    _timeLimitMs = (tryExact && timeLimitMs > 0) ? std::max(1, timeLimitMs / 4) : timeLimitMs;
+    _start = std::chrono::steady_clock::now();
+
+    int bestMove = std::countr_zero(moves);
+    for (int depth = 1; depth <= depthLimit; depth++) {
+        int score = negascout(board, depth, -kInfinite, kInfinite);
+        if (_aborted) {
+            break;
+        }
+        TableEntry *entry = probe(board);
+        if (entry && entry->bestMove >= 0) {
+            bestMove = entry->bestMove;
+        }
+        _lastScore = score;
+        _lastDepth = depth;
+    }
+
+    if (tryExact) {
+        int remaining = 0;
+        if (timeLimitMs > 0) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start);
+            remaining = std::max(1, timeLimitMs - (int)elapsed.count());
+        }
+        int exactMove = -1;
+        int score = solve(board, remaining, &exactMove);
+        if (score != kInfinite && exactMove >= 0) {
+            bestMove = exactMove;
+            _lastScore = score;
+            _lastDepth = empties;
+            _lastExact = true;
+        }
+    }
+    return bestMove;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "OthelloBoard.h"
+#include "OthelloEndgame.h"
+#include <vector>
+#include <chrono>
+
+//
+// othello searcher: iterative deepening negascout with a transposition table for the
+// midgame, and an exact solver once few enough squares are empty
+// scores are from the side to move's point of view
+//
+class OthelloAI
+{
+public:
+    // exact scores are disc differences, won games found in the midgame search are pushed past any evaluation
+    static const int kWinScore = 100000;
+    static const int kInfinite = 1000000;
+    // the exact solver takes over at or below this many empty squares
+    static const int kExactEmpties = 20;
+
+    OthelloAI(size_t tableEntries = 1 << 18);
+
+    // best square for the side to move or -1 to pass, searching up to maxDepth plies
+    // (0 for no limit) and stopping after timeLimitMs (0 for no limit)
+    int findMove(const OthelloBoard &board, int maxDepth, int timeLimitMs);
+
+    // exact final disc difference with perfect play, or kInfinite if it ran out of time
+    int solve(const OthelloBoard &board, int timeLimitMs, int *bestMove = nullptr);
+
+    // static evaluation: mobility, frontier, corners and edge stability
+    static int evaluate(const OthelloBoard &board);
+
+    uint64_t nodes() const { return _nodes; }
+    int lastScore() const { return _lastScore; }
+    int lastDepth() const { return _lastDepth; }
+    bool lastWasExact() const { return _lastExact; }
+
+private:
+    enum Bound : uint8_t { kNone, kExact, kLower, kUpper };
+    struct TableEntry
+    {
+        uint64_t player;
+        uint64_t opponent;
+        int32_t score;
+        int8_t depth;
+        Bound bound;
+        int8_t bestMove;
+    };
+
+    int negascout(const OthelloBoard &board, int depth, int alpha, int beta);
+    int orderMoves(const OthelloBoard &board, uint64_t moves, int ttMove, int *ordered);
+    bool timeUp();
+
+    TableEntry *probe(const OthelloBoard &board);
+    void store(const OthelloBoard &board, int depth, int score, Bound bound, int bestMove);
+
+    std::vector<TableEntry> _table;
+    OthelloEndgame _endgame;
+    uint64_t _nodes;
+    bool _aborted;
+    int _timeLimitMs;
+    std::chrono::steady_clock::time_point _start;
+    int _lastScore;
+    int _lastDepth;
+    bool _lastExact;
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <bit>
+
+//
+// bitboard othello position: one 64 bit mask per side, square index = y * 8 + x
+// (row 0 is the top row of the Othello grid)
+//
+// move generation and flips use Kogge-Stone fills, every direction is a handful of
+// shift-and-mask steps over the whole board instead of a walk square by square
+//
+class OthelloBoard
+{
+public:
+    OthelloBoard() : _player(0), _opponent(0) {}
+    OthelloBoard(uint64_t player, uint64_t opponent) : _player(player), _opponent(opponent) {}
+
+    // the standard start, black (the side to move) on d5/e4 and white on d4/e5
+    static OthelloBoard initialPosition() { return OthelloBoard(kInitialBlack, kInitialWhite); }
+
+    // discs of the side to move and of the other side
+    uint64_t player() const { return _player; }
+    uint64_t opponent() const { return _opponent; }
+    uint64_t empties() const { return ~(_player | _opponent); }
+    int emptyCount() const { return std::popcount(empties()); }
+
+    uint64_t legalMoves() const { return legalMoves(_player, _opponent); }
+    uint64_t flipsFor(int square) const { return flips(_player, _opponent, square); }
+
+    // play a legal move for the side to move, which then passes the turn
+    void play(int square)
+    {
+        uint64_t flipped = flips(_player, _opponent, square);
+        uint64_t player = _player | flipped | (1ULL << square);
+        _player = _opponent & ~flipped;
+        _opponent = player;
+    }
+    void pass()
+    {
+        uint64_t player = _player;
+        _player = _opponent;
+        _opponent = player;
+    }
+    bool isGameOver() const { return legalMoves(_player, _opponent) == 0 && legalMoves(_opponent, _player) == 0; }
+    // final score from the side to move's point of view, empties go to the winner
+    int finalScore() const
+    {
+        int player = std::popcount(_player);
+        int opponent = std::popcount(_opponent);
+        int empties = 64 - player - opponent;
+        if (player > opponent) return player - opponent + empties;
+        if (opponent > player) return player - opponent - empties;
+        return 0;
+    }
+    bool operator==(const OthelloBoard &other) const { return _player == other._player && _opponent == other._opponent; }
+
+    // every empty square that flanks at least one opposing disc
+    static uint64_t legalMoves(uint64_t player, uint64_t opponent)
+    {
+        uint64_t empty = ~(player | opponent);
+        uint64_t moves = 0;
+        for (int dir = 0; dir < 8; dir++) {
+            // own discs extended through the contiguous opposing runs next to them
+            uint64_t run = fill(player, opponent, dir) & opponent;
+            moves |= shift(run, dir) & empty;
+        }
+        return moves;
+    }
+
+    // the opposing discs flipped by playing at square
+    static uint64_t flips(uint64_t player, uint64_t opponent, int square)
+    {
+        uint64_t move = 1ULL << square;
+        uint64_t flipped = 0;
+        for (int dir = 0; dir < 8; dir++) {
+            // the opposing run starting next to the move, kept only if one of our discs closes it
+            uint64_t run = fill(move, opponent, dir);
+            if (shift(run, dir) & player) {
+                flipped |= run & opponent;
+            }
+        }
+        return flipped;
+    }
+
+private:
+    static constexpr uint64_t kNotFileA = 0xfefefefefefefefeULL;
+    static constexpr uint64_t kNotFileH = 0x7f7f7f7f7f7f7f7fULL;
+    static constexpr uint64_t kInitialBlack = (1ULL << (3 * 8 + 4)) | (1ULL << (4 * 8 + 3));
+    static constexpr uint64_t kInitialWhite = (1ULL << (3 * 8 + 3)) | (1ULL << (4 * 8 + 4));
+
+    // E, SE, S, SW, W, NW, N, NE as bit shifts (positive shifts left), and the mask
+    // that removes squares that wrapped around a board edge after the shift
+    static constexpr int kShifts[8] = { 1, 9, 8, 7, -1, -9, -8, -7 };
+    static constexpr uint64_t kMasks[8] = { kNotFileA, kNotFileA, ~0ULL, kNotFileH, kNotFileH, kNotFileH, ~0ULL, kNotFileA };
+
+    static uint64_t shift(uint64_t bits, int dir)
+    {
+        int amount = kShifts[dir];
+        return (amount > 0 ? bits << amount : bits >> -amount) & kMasks[dir];
+    }
+
+    // Kogge-Stone occluded fill: gen spread through the propagator in one direction, log2 steps
+    static uint64_t fill(uint64_t gen, uint64_t propagator, int dir)
+    {
+        int amount = kShifts[dir];
+        uint64_t pro = propagator & kMasks[dir];
+        if (amount > 0) {
+            gen |= pro & (gen << amount);
+            pro &= pro << amount;
+            gen |= pro & (gen << (2 * amount));
+            pro &= pro << (2 * amount);
+            gen |= pro & (gen << (4 * amount));
+        } else {
+            amount = -amount;
+            gen |= pro & (gen >> amount);
+            pro &= pro >> amount;
+            gen |= pro & (gen >> (2 * amount));
+            pro &= pro >> (2 * amount);
+            gen |= pro & (gen >> (4 * amount));
+        }
+        return gen;
+    }
+
+    uint64_t _player;
+    uint64_t _opponent;
+};
@@ -0,0 +1,410 @@
+#include "OthelloEndgame.h"
+#include <algorithm>
+#include <bit>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+    const uint64_t kNotFileA = 0xfefefefefefefefeULL;
+    const uint64_t kNotFileH = 0x7f7f7f7f7f7f7f7fULL;
+
+    // positions with at least this many empties go through the transposition table
+    const int kTableEmpties = 9;
+    // and at least this many are ordered by the opponent's replies
+    const int kFastestFirstEmpties = 7;
+    // lower than any score
+    const int kNoScore = -65;
+
+    // the order empties are tried in within a parity class: corners, edges, centre, then
+    // the squares that hand out corners
+    const int kSquareOrder[64] = {
+        0, 7, 56, 63,
+        2, 5, 16, 23, 40, 47, 58, 61,
+        3, 4, 24, 31, 32, 39, 59, 60,
+        18, 21, 42, 45,
+        19, 20, 26, 29, 34, 37, 43, 44,
+        27, 28, 35, 36,
+        11, 12, 25, 30, 33, 38, 51, 52,
+        10, 13, 17, 22, 41, 46, 50, 53,
+        1, 6, 8, 15, 48, 55, 57, 62,
+        9, 14, 49, 54
+    };
+
+    inline unsigned int quadrantBit(int square)
+    {
+        return 1u << ((((square >> 5) & 1) << 1) | ((square >> 2) & 1));
+    }
+
+    inline int finalScore(uint64_t player, uint64_t opponent)
+    {
+        return OthelloBoard(player, opponent).finalScore();
+    }
+}
+
+OthelloEndgame::OthelloEndgame(size_t tableEntries)
+{
+    size_t size = 1;
+    while (size * 2 <= tableEntries) {
+        size *= 2;
+    }
+    _table.assign(size, TableEntry{ 0, 0, 0, kNone, -1 });
+    _next[kListHead] = _prev[kListHead] = kListHead;
+    _parity = 0;
+    _nodes = 0;
+    _aborted = false;
+    _timeLimitMs = 0;
+}
+
+#if defined(__AVX2__)
+//
+// the eight directions as two passes over four lanes (E, S, SE, SW towards higher squares, then
+// the same shifts towards lower ones), each lane a Kogge-Stone fill like OthelloBoard::fill
+//
+uint64_t OthelloEndgame::flips(uint64_t player, uint64_t opponent, int square)
+{
+    const __m256i shift1 = _mm256_set_epi64x(7, 9, 8, 1);
+    const __m256i shift2 = _mm256_set_epi64x(14, 18, 16, 2);
+    const __m256i shift4 = _mm256_set_epi64x(28, 36, 32, 4);
+    const __m256i upMasks = _mm256_set_epi64x(kNotFileH, kNotFileA, ~0LL, kNotFileA);
+    const __m256i downMasks = _mm256_set_epi64x(kNotFileA, kNotFileH, ~0LL, kNotFileH);
+
+    __m256i mine = _mm256_set1_epi64x(player);
+    __m256i theirs = _mm256_set1_epi64x(opponent);
+    __m256i move = _mm256_set1_epi64x(1ULL << square);
+    __m256i zero = _mm256_setzero_si256();
+
+    __m256i pro = _mm256_and_si256(theirs, upMasks);
+    __m256i gen = _mm256_or_si256(move, _mm256_and_si256(pro, _mm256_sllv_epi64(move, shift1)));
+    pro = _mm256_and_si256(pro, _mm256_sllv_epi64(pro, shift1));
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_sllv_epi64(gen, shift2)));
+    pro = _mm256_and_si256(pro, _mm256_sllv_epi64(pro, shift2));
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_sllv_epi64(gen, shift4)));
+    __m256i closed = _mm256_and_si256(_mm256_and_si256(_mm256_sllv_epi64(gen, shift1), upMasks), mine);
+    __m256i flipped = _mm256_andnot_si256(_mm256_cmpeq_epi64(closed, zero), _mm256_and_si256(gen, theirs));
+
+    pro = _mm256_and_si256(theirs, downMasks);
+    gen = _mm256_or_si256(move, _mm256_and_si256(pro, _mm256_srlv_epi64(move, shift1)));
+    pro = _mm256_and_si256(pro, _mm256_srlv_epi64(pro, shift1));
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_srlv_epi64(gen, shift2)));
+    pro = _mm256_and_si256(pro, _mm256_srlv_epi64(pro, shift2));
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_srlv_epi64(gen, shift4)));
+    closed = _mm256_and_si256(_mm256_and_si256(_mm256_srlv_epi64(gen, shift1), downMasks), mine);
+    flipped = _mm256_or_si256(flipped, _mm256_andnot_si256(_mm256_cmpeq_epi64(closed, zero), _mm256_and_si256(gen, theirs)));
+
+    __m128i half = _mm_or_si128(_mm256_castsi256_si128(flipped), _mm256_extracti128_si256(flipped, 1));
+    return (uint64_t)_mm_cvtsi128_si64(half) | (uint64_t)_mm_extract_epi64(half, 1);
+}
+#else
+uint64_t OthelloEndgame::flips(uint64_t player, uint64_t opponent, int square)
+{
+    return OthelloBoard::flips(player, opponent, square);
+}
+#endif
+
+void OthelloEndgame::removeEmpty(int square)
+{
+    _next[_prev[square]] = _next[square];
+    _prev[_next[square]] = _prev[square];
+    _parity ^= quadrantBit(square);
+}
+
+// squares come back in the reverse order they were removed, so the links are still valid
+void OthelloEndgame::restoreEmpty(int square)
+{
+    _next[_prev[square]] = square;
+    _prev[_next[square]] = square;
+    _parity ^= quadrantBit(square);
+}
+
+void OthelloEndgame::countNode()
+{
+    _nodes++;
+    if ((_nodes & 4095) == 0 && _timeLimitMs > 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start);
+        if (elapsed.count() >= _timeLimitMs) {
+            _aborted = true;
+        }
+    }
+}
+
+OthelloEndgame::TableEntry *OthelloEndgame::probe(uint64_t player, uint64_t opponent)
+{
+    uint64_t hash = player * 0x9e3779b97f4a7c15ULL ^ opponent * 0xc2b2ae3d27d4eb4fULL;
+    TableEntry *entry = &_table[(hash ^ (hash >> 29)) & (_table.size() - 1)];
+    return (entry->bound != kNone && entry->player == player && entry->opponent == opponent) ? entry : nullptr;
+}
+
+void OthelloEndgame::store(uint64_t player, uint64_t opponent, int score, Bound bound, int bestMove)
+{
+    uint64_t hash = player * 0x9e3779b97f4a7c15ULL ^ opponent * 0xc2b2ae3d27d4eb4fULL;
+    _table[(hash ^ (hash >> 29)) & (_table.size() - 1)] = TableEntry{ player, opponent, (int8_t)score, bound, (int8_t)bestMove };
+}
+
+//
+// one empty left: whoever can flip plays it, the opponent's discs are everything else
+//
+int OthelloEndgame::solve1(uint64_t player, int x1)
+{
+    _nodes++;
+    uint64_t opponent = ~player & ~(1ULL << x1);
+    int discs = 2 * std::popcount(player);
+    int flipped = std::popcount(flips(player, opponent, x1));
+    if (flipped) {
+        return discs + 2 * flipped - 62;
+    }
+    flipped = std::popcount(flips(opponent, player, x1));
+    if (flipped) {
+        return discs - 2 * flipped - 64;
+    }
+    int score = discs - 63;
+    return score > 0 ? score + 1 : score - 1;
+}
+
+int OthelloEndgame::solve2(uint64_t player, uint64_t opponent, int alpha, int beta, int x1, int x2, bool passed)
+{
+    _nodes++;
+    int best = kNoScore;
+    uint64_t flipped;
+    if ((flipped = flips(player, opponent, x1))) {
+        best = -solve1(opponent & ~flipped, x2);
+        if (best >= beta) {
+            return best;
+        }
+    }
+    if ((flipped = flips(player, opponent, x2))) {
+        int score = -solve1(opponent & ~flipped, x1);
+        if (score > best) {
+            best = score;
+        }
+    }
+    if (best == kNoScore) {
+        return passed ? finalScore(player, opponent) : -solve2(opponent, player, -beta, -alpha, x1, x2, true);
+    }
+    return best;
+}
+
+int OthelloEndgame::solve3(uint64_t player, uint64_t opponent, int alpha, int beta, int x1, int x2, int x3, bool passed)
+{
+    _nodes++;
+    int best = kNoScore;
+    uint64_t flipped;
+    if ((flipped = flips(player, opponent, x1))) {
+        best = -solve2(opponent & ~flipped, player | flipped | (1ULL << x1), -beta, -alpha, x2, x3, false);
+        if (best >= beta) {
+            return best;
+        }
+    }
+    if ((flipped = flips(player, opponent, x2))) {
+        int score = -solve2(opponent & ~flipped, player | flipped | (1ULL << x2), -beta, -std::max(alpha, best), x1, x3, false);
+        if (score >= beta) {
+            return score;
+        }
+        best = std::max(best, score);
+    }
+    if ((flipped = flips(player, opponent, x3))) {
+        int score = -solve2(opponent & ~flipped, player | flipped | (1ULL << x3), -beta, -std::max(alpha, best), x1, x2, false);
+        best = std::max(best, score);
+    }
+    if (best == kNoScore) {
+        return passed ? finalScore(player, opponent) : -solve3(opponent, player, -beta, -alpha, x1, x2, x3, true);
+    }
+    return best;
+}
+
+int OthelloEndgame::solve4(uint64_t player, uint64_t opponent, int alpha, int beta, int x1, int x2, int x3, int x4, bool passed)
+{
+    _nodes++;
+    int best = kNoScore;
+    uint64_t flipped;
+    if ((flipped = flips(player, opponent, x1))) {
+        best = -solve3(opponent & ~flipped, player | flipped | (1ULL << x1), -beta, -alpha, x2, x3, x4, false);
+        if (best >= beta) {
+            return best;
+        }
+    }
+    if ((flipped = flips(player, opponent, x2))) {
+        int score = -solve3(opponent & ~flipped, player | flipped | (1ULL << x2), -beta, -std::max(alpha, best), x1, x3, x4, false);
+        if (score >= beta) {
+            return score;
+        }
+        best = std::max(best, score);
+    }
+    if ((flipped = flips(player, opponent, x3))) {
+        int score = -solve3(opponent & ~flipped, player | flipped | (1ULL << x3), -beta, -std::max(alpha, best), x1, x2, x4, false);
+        if (score >= beta) {
+            return score;
+        }
+        best = std::max(best, score);
+    }
+    if ((flipped = flips(player, opponent, x4))) {
+        int score = -solve3(opponent & ~flipped, player | flipped | (1ULL << x4), -beta, -std::max(alpha, best), x1, x2, x3, false);
+        best = std::max(best, score);
+    }
+    if (best == kNoScore) {
+        return passed ? finalScore(player, opponent) : -solve4(opponent, player, -beta, -alpha, x1, x2, x3, x4, true);
+    }
+    return best;
+}
+
+int OthelloEndgame::search(uint64_t player, uint64_t opponent, int alpha, int beta, int empties, bool passed, int *bestMove)
+{
+    if (empties <= 4 && !bestMove) {
+        // hand the last few squares to the unrolled solvers, odd quadrants first
+        int squares[4];
+        int count = 0;
+        for (int square = _next[kListHead]; square != kListHead; square = _next[square]) {
+            if (_parity & quadrantBit(square)) {
+                squares[count++] = square;
+            }
+        }
+        for (int square = _next[kListHead]; square != kListHead; square = _next[square]) {
+            if (!(_parity & quadrantBit(square))) {
+                squares[count++] = square;
+            }
+        }
+        switch (empties) {
+            case 4: return solve4(player, opponent, alpha, beta, squares[0], squares[1], squares[2], squares[3], passed);
+            case 3: return solve3(player, opponent, alpha, beta, squares[0], squares[1], squares[2], passed);
+            case 2: return solve2(player, opponent, alpha, beta, squares[0], squares[1], passed);
+            case 1: return solve1(player, squares[0]);
+            default: return finalScore(player, opponent);
+        }
+    }
+
+    countNode();
+    if (_aborted) {
+        return 0;
+    }
+
+    uint64_t moves = OthelloBoard::legalMoves(player, opponent);
+    if (!moves) {
+        if (bestMove) {
+            *bestMove = -1;
+        }
+        if (passed || !OthelloBoard::legalMoves(opponent, player)) {
+            return finalScore(player, opponent);
+        }
+        return -search(opponent, player, -beta, -alpha, empties, true, nullptr);
+    }
+
+    bool useTable = empties >= kTableEmpties;
+    int tableMove = -1;
+    if (useTable) {
+        if (TableEntry *entry = probe(player, opponent)) {
+            tableMove = entry->bestMove;
+            if (!bestMove) {
+                if (entry->bound == kExact) return entry->score;
+                if (entry->bound == kLower && entry->score >= beta) return entry->score;
+                if (entry->bound == kUpper && entry->score <= alpha) return entry->score;
+            }
+        }
+    }
+
+    // walk the empty list so squares keep their static order, odd quadrants ahead of even ones
+    int ordered[32];
+    uint64_t orderedFlips[32];
+    int scores[32];
+    int count = 0;
+    for (int square = _next[kListHead]; square != kListHead; square = _next[square]) {
+        if (!((moves >> square) & 1)) {
+            continue;
+        }
+        uint64_t flipped = flips(player, opponent, square);
+        int score = (_parity & quadrantBit(square)) ? 1 : 0;
+        if (empties >= kFastestFirstEmpties) {
+            // fastest first: the fewer replies a move leaves, the sooner it's cut off
+            uint64_t replies = OthelloBoard::legalMoves(opponent & ~flipped, player | flipped | (1ULL << square));
+            score -= 4 * std::popcount(replies);
+        }
+        if (square == tableMove) {
+            score = kAborted;
+        }
+        int at = count++;
+        while (at > 0 && scores[at - 1] < score) {
+            scores[at] = scores[at - 1];
+            ordered[at] = ordered[at - 1];
+            orderedFlips[at] = orderedFlips[at - 1];
+            at--;
+        }
+        scores[at] = score;
+        ordered[at] = square;
+        orderedFlips[at] = flipped;
+    }
+
+    int originalAlpha = alpha;
+    int best = kNoScore;
+    int bestSquare = -1;
+    for (int i = 0; i < count; i++) {
+        int square = ordered[i];
+        uint64_t nextPlayer = opponent & ~orderedFlips[i];
+        uint64_t nextOpponent = player | orderedFlips[i] | (1ULL << square);
+        removeEmpty(square);
+        int score;
+        if (i == 0) {
+            score = -search(nextPlayer, nextOpponent, -beta, -alpha, empties - 1, false, nullptr);
+        } else {
+            score = -search(nextPlayer, nextOpponent, -alpha - 1, -alpha, empties - 1, false, nullptr);
+            if (score > alpha && score < beta) {
+                score = -search(nextPlayer, nextOpponent, -beta, -score, empties - 1, false, nullptr);
+            }
+        }
+        restoreEmpty(square);
+        if (_aborted) {
+            return 0;
+        }
+        if (score > best) {
+            best = score;
+            bestSquare = square;
+        }
+        if (score > alpha) {
+            alpha = score;
+        }
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    if (useTable) {
+        Bound bound = best <= originalAlpha ? kUpper : (best >= beta ? kLower : kExact);
+        store(player, opponent, best, bound, bestSquare);
+    }
+    if (bestMove) {
+        *bestMove = bestSquare;
+    }
+    return best;
+}
+
+int OthelloEndgame::solve(const OthelloBoard &board, int timeLimitMs, int *bestMove, int alpha, int beta)
+{
+    _nodes = 0;
+    _aborted = false;
+    _timeLimitMs = timeLimitMs;
+    _start = std::chrono::steady_clock::now();
+
+    // rebuild the empty list in static order
+    uint64_t empty = board.empties();
+    int last = kListHead;
+    _parity = 0;
+    for (int square : kSquareOrder) {
+        if ((empty >> square) & 1) {
+            _next[last] = square;
+            _prev[square] = last;
+            last = square;
+            _parity ^= quadrantBit(square);
+        }
+    }
+    _next[last] = kListHead;
+    _prev[kListHead] = last;
+
+    int move = -1;
+    int score = search(board.player(), board.opponent(), alpha, beta, board.emptyCount(), false, &move);
+    if (_aborted) {
+        return kAborted;
+    }
+    if (bestMove) {
+        *bestMove = move;
+    }
+    return score;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "OthelloBoard.h"
+#include <vector>
+#include <chrono>
+
+//
+// exact othello endgame solver
+// the empty squares are kept in a linked list (so nothing scans the full board for moves) along
+// with the parity of each quadrant, and moves into odd quadrants are tried first. the last four
+// empties are solved by unrolled routines that only test the squares left, and flips use AVX2
+// when the build enables it
+//
+class OthelloEndgame
+{
+public:
+    // returned by solve when it runs out of time
+    static const int kAborted = 1000000;
+
+    OthelloEndgame(size_t tableEntries = 1 << 16);
+
+    // final disc difference for the side to move with perfect play (empties go to the winner),
+    // searched inside alpha..beta, or kAborted if timeLimitMs (0 for no limit) ran out
+    int solve(const OthelloBoard &board, int timeLimitMs, int *bestMove = nullptr, int alpha = -64, int beta = 64);
+
+    uint64_t nodes() const { return _nodes; }
+
+    // the discs flipped by a move, same result as OthelloBoard::flips
+    static uint64_t flips(uint64_t player, uint64_t opponent, int square);
+
+private:
+    enum Bound : uint8_t { kNone, kExact, kLower, kUpper };
+    struct TableEntry
+    {
+        uint64_t player;
+        uint64_t opponent;
+        int8_t score;
+        Bound bound;
+        int8_t bestMove;
+    };
+
+    int search(uint64_t player, uint64_t opponent, int alpha, int beta, int empties, bool passed, int *bestMove);
+    int solve4(uint64_t player, uint64_t opponent, int alpha, int beta, int x1, int x2, int x3, int x4, bool passed);
+    int solve3(uint64_t player, uint64_t opponent, int alpha, int beta, int x1, int x2, int x3, bool passed);
+    int solve2(uint64_t player, uint64_t opponent, int alpha, int beta, int x1, int x2, bool passed);
+    int solve1(uint64_t player, int x1);
+
+    void removeEmpty(int square);
+    void restoreEmpty(int square);
+    void countNode();
+
+    TableEntry *probe(uint64_t player, uint64_t opponent);
+    void store(uint64_t player, uint64_t opponent, int score, Bound bound, int bestMove);
+
+    // doubly linked list of the empty squares, kListHead is both ends
+    static const int kListHead = 64;
+    uint8_t _next[65];
+    uint8_t _prev[65];
+    // one bit per quadrant, set when it holds an odd number of empties
+    unsigned int _parity;
+
+    std::vector<TableEntry> _table;
+    uint64_t _nodes;
+    bool _aborted;
+    int _timeLimitMs;
+    std::chrono::steady_clock::time_point _start;
+};
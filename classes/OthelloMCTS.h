@@ -0,0 +1,69 @@
+#pragma once
+
+#include "OthelloBoard.h"
+#include "MCTS.h"
+
+//
+// OthelloBoard as an MCTSState. the board is from the side to move's point of view, so the side
+// is counted separately, and a side with no moves passes (move -1) until neither can move
+//
+class OthelloMCTSState
+{
+public:
+    using Move = int;
+    struct MoveList
+    {
+        int moves[64];
+        int count = 0;
+
+        int *begin() { return moves; }
+        int *end() { return moves + count; }
+        const int *begin() const { return moves; }
+        const int *end() const { return moves + count; }
+    };
+
+    OthelloMCTSState() : _side(0) {}
+    OthelloMCTSState(const OthelloBoard &board, int side) : _board(board), _side(side) {}
+
+    void generateMoves(MoveList &list) const
+    {
+        list.count = 0;
+        uint64_t moves = _board.legalMoves();
+        if (!moves) {
+            if (OthelloBoard::legalMoves(_board.opponent(), _board.player())) {
+                list.moves[list.count++] = -1;
+            }
+            return;
+        }
+        for (; moves; moves &= moves - 1) {
+            list.moves[list.count++] = std::countr_zero(moves);
+        }
+    }
+
+    void make(int square)
+    {
+        if (square < 0) {
+            _board.pass();
+        } else {
+            _board.play(square);
+        }
+        _side ^= 1;
+    }
+
+    int sideToMove() const { return _side; }
+
+    double result(int side) const
+    {
+        int score = _board.finalScore();
+        if (score == 0) {
+            return 0.5;
+        }
+        return (score > 0) == (side == _side) ? 1.0 : 0.0;
+    }
+
+    bool operator==(const OthelloMCTSState &other) const { return _board == other._board && _side == other._side; }
+
+private:
+    OthelloBoard _board;
+    int _side;
+};
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <ranges>
+#include <vector>
+
+//
+// generic game tree search: negamax with alpha-beta, iterative deepening, a transposition
+// table, move ordering, node counting and time limits, for any game state that can make and
+// unmake its own moves
+//
+// a state plugs in with
+//   Move, MoveList                a move and a random access range of them
+//   generateMoves(list) const     the legal moves, none once the game is over
+//   make(move), unmake(move)      play a move and take it back
+//   evaluate() const              score for the side to move: +-kSearchWinScore for a decided
+//                                 game, anything smaller is a guess
+//   hash() const                  a 64 bit key for the transposition table
+//
+// and may add any of these hooks
+//   scoreMove(move) const         ordering, higher scores are searched first
+//   isForcing() const             true where the horizon mustn't cut the search off
+//                                 (pending captures and the like)
+//   exactScore(score) const       false, or true with a score that ends the search there
+//                                 (endgame databases, books)
+//
+
+// what evaluate() returns for a game the side to move has won
+constexpr int kSearchWinScore = 1000000;
+
+//
+// whether a search has run out, asked on every node by Search and ChessAI alike: the node
+// limit is a plain compare so a search stops on the exact count, and the clock is only read
+// every 4096 nodes. 0 for either limit is no limit
+//
+inline bool searchLimitReached(uint64_t nodes, uint64_t nodeLimit, int timeLimitMs, std::chrono::steady_clock::time_point start)
+{
+    if (nodeLimit > 0 && nodes >= nodeLimit) {
+        return true;
+    }
+    if (timeLimitMs <= 0 || (nodes & 4095) != 0) {
+        return false;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    return elapsed.count() >= timeLimitMs;
+}
+
+template <typename State>
+concept SearchState = requires(State &state, const State &view, const typename State::Move &move, typename State::MoveList &list) {
+    requires std::ranges::random_access_range<typename State::MoveList>;
+    requires std::equality_comparable<typename State::Move>;
+    view.generateMoves(list);
+    state.make(move);
+    state.unmake(move);
+    { view.evaluate() } -> std::convertible_to<int>;
+    { view.hash() } -> std::convertible_to<uint64_t>;
+};
+
+template <SearchState State>
+class Search
+{
+public:
+    using Move = typename State::Move;
+    using MoveList = typename State::MoveList;
+
+    static constexpr int kWinScore = kSearchWinScore;
+    static constexpr int kInfinite = 2 * kSearchWinScore;
+    // deepest the search goes, forcing lines included
+    static constexpr int kMaxPly = 128;
+
+    struct Limits
+    {
+        int maxDepth = kMaxPly;
+        // 0 for no limit
+        int timeLimitMs = 0;
+        uint64_t nodeLimit = 0;
+    };
+
+    struct Result
+    {
+        // false when the root has no moves
+        bool hasMove = false;
+        Move bestMove{};
+        int score = 0;
+        // deepest iteration that finished
+        int depth = 0;
+        uint64_t nodes = 0;
+    };
+
+    enum Bound : uint8_t { kNone, kExact, kLower, kUpper };
+    struct TableEntry
+    {
+        uint64_t hash;
+        int32_t score;
+        int16_t depth;
+        Bound bound;
+        bool hasMove;
+        Move bestMove;
+    };
+
+    // a table of entries, a power of two in size, that searches can share
+    class Table
+    {
+    public:
+        Table(size_t entries = 1 << 20)
+        {
+            size_t size = 1;
+            while (size * 2 <= entries) {
+                size *= 2;
+            }
+            _entries.resize(size);
+            clear();
+        }
+
+        void clear() { std::fill(_entries.begin(), _entries.end(), TableEntry{ 0, 0, 0, kNone, false, Move{} }); }
+
+        const TableEntry *probe(uint64_t hash) const
+        {
+            const TableEntry &entry = _entries[hash & (_entries.size() - 1)];
+            return (entry.bound != kNone && entry.hash == hash) ? &entry : nullptr;
+        }
+
+        void store(const TableEntry &entry)
+        {
+            TableEntry &slot = _entries[entry.hash & (_entries.size() - 1)];
+            // keep deeper results for the same position
+            if (slot.bound != kNone && slot.hash == entry.hash && slot.depth > entry.depth) {
+                return;
+            }
+            slot = entry;
+        }
+
+    private:
+        std::vector<TableEntry> _entries;
+    };
+
+    Search(size_t tableEntries = 1 << 20) : _ownTable(tableEntries), _table(&_ownTable) {}
+
+    // search someone else's table instead of our own, nullptr to go back to ours
+    void setTable(Table *table) { _table = table ? table : &_ownTable; }
+    Table &table() { return *_table; }
+
+    // iterative deepening from state, which is handed back as it came
+    Result run(State &state, const Limits &limits)
+    {
+        Result result;
+        _nodes = 0;
+        _aborted = false;
+        _limits = limits;
+        _start = std::chrono::steady_clock::now();
+
+        MoveList list;
+        state.generateMoves(list);
+        if (std::ranges::empty(list)) {
+            result.score = adjustScore(state.evaluate(), 0);
+            return result;
+        }
+        result.hasMove = true;
+        result.bestMove = *std::ranges::begin(list);
+
+        int depthLimit = std::clamp(limits.maxDepth, 1, kMaxPly);
+        for (int depth = 1; depth <= depthLimit; depth++) {
+            int score = alphaBeta(state, depth, 0, -kInfinite, kInfinite);
+            if (_aborted) {
+                break;
+            }
+            result.bestMove = _rootBest;
+            result.score = score;
+            result.depth = depth;
+            // a forced win or loss won't change with more depth
+            if (std::abs(score) > kWinScore - kMaxPly) {
+                break;
+            }
+        }
+        result.nodes = _nodes;
+        return result;
+    }
+
+    // plain full width negamax to a fixed depth, no table and no pruning
+    int negamax(State &state, int depth, int ply = 0)
+    {
+        _nodes++;
+        MoveList list;
+        state.generateMoves(list);
+        if (depth <= 0 || std::ranges::empty(list)) {
+            return adjustScore(state.evaluate(), ply);
+        }
+        int best = -kInfinite;
+        for (const Move &move : list) {
+            state.make(move);
+            best = std::max(best, -negamax(state, depth - 1, ply + 1));
+            state.unmake(move);
+        }
+        return best;
+    }
+
+    // alpha-beta from state to depth plies, ply being how far state is from the root
+    int alphaBeta(State &state, int depth, int ply, int alpha, int beta)
+    {
+        // checked before the node is counted, so a search never goes past its node limit
+        if (limitReached()) {
+            _aborted = true;
+        }
+        if (_aborted) {
+            return 0;
+        }
+        _nodes++;
+
+        if constexpr (requires(int score) { { state.exactScore(score) } -> std::convertible_to<bool>; }) {
+            int score;
+            if (ply > 0 && state.exactScore(score)) {
+                return adjustScore(score, ply);
+            }
+        }
+        bool forcing = false;
+        if constexpr (requires { { state.isForcing() } -> std::convertible_to<bool>; }) {
+            forcing = depth <= 0 && state.isForcing();
+        }
+        if ((depth <= 0 && !forcing) || ply >= kMaxPly) {
+            return adjustScore(state.evaluate(), ply);
+        }
+
+        const Move *tableMove = nullptr;
+        uint64_t hash = state.hash();
+        if (const TableEntry *entry = _table->probe(hash)) {
+            tableMove = entry->hasMove ? &entry->bestMove : nullptr;
+            if (entry->depth >= depth && ply > 0) {
+                int score = fromTable(entry->score, ply);
+                if (entry->bound == kExact) return score;
+                if (entry->bound == kLower && score >= beta) return score;
+                if (entry->bound == kUpper && score <= alpha) return score;
+            }
+        }
+
+        MoveList list;
+        state.generateMoves(list);
+        if (std::ranges::empty(list)) {
+            return adjustScore(state.evaluate(), ply);
+        }
+        // copied, the table slot can be overwritten further down
+        Move ttMove = tableMove ? *tableMove : Move{};
+        std::vector<int> &order = orderMoves(state, list, tableMove != nullptr, ttMove, ply);
+        auto moves = std::ranges::begin(list);
+
+        int originalAlpha = alpha;
+        int bestScore = -kInfinite;
+        int bestIndex = order[0];
+        for (int index : order) {
+            const Move &move = moves[index];
+            state.make(move);
+            int score = -alphaBeta(state, depth - 1, ply + 1, -beta, -alpha);
+            state.unmake(move);
+            if (_aborted) {
+                return 0;
+            }
+            if (score > bestScore) {
+                bestScore = score;
+                bestIndex = index;
+            }
+            alpha = std::max(alpha, score);
+            if (alpha >= beta) {
+                break;
+            }
+        }
+
+        if (ply == 0) {
+            _rootBest = moves[bestIndex];
+        }
+        Bound bound = bestScore <= originalAlpha ? kUpper : (bestScore >= beta ? kLower : kExact);
+        _table->store(TableEntry{ hash, toTable(bestScore, ply), (int16_t)std::max(depth, 0), bound, true, moves[bestIndex] });
+        return bestScore;
+    }
+
+    uint64_t nodes() const { return _nodes; }
+
+private:
+    // decided games score by distance, sooner wins and later losses are better
+    static int adjustScore(int score, int ply)
+    {
+        if (score >= kWinScore) return kWinScore - ply;
+        if (score <= -kWinScore) return -kWinScore + ply;
+        return score;
+    }
+
+    // wins are stored relative to the position rather than the root, so they stay right when
+    // the position is reached at a different ply
+    static int toTable(int score, int ply)
+    {
+        if (score > kWinScore - kMaxPly) return score + ply;
+        if (score < -kWinScore + kMaxPly) return score - ply;
+        return score;
+    }
+
+    static int fromTable(int score, int ply)
+    {
+        if (score > kWinScore - kMaxPly) return score - ply;
+        if (score < -kWinScore + kMaxPly) return score + ply;
+        return score;
+    }
+
+    bool limitReached() const { return searchLimitReached(_nodes, _limits.nodeLimit, _limits.timeLimitMs, _start); }
+
+    //
+    // move indices best first: the table move, then by the state's scoreMove hook if it has one
+    // the buffers are kept per ply so nothing is allocated once the search is warm
+    //
+    std::vector<int> &orderMoves(const State &state, const MoveList &list, bool hasTableMove, const Move &tableMove, int ply)
+    {
+        std::vector<int> &order = _order[ply];
+        std::vector<int> &scores = _orderScores[ply];
+        int count = (int)std::ranges::size(list);
+        auto moves = std::ranges::begin(list);
+        order.resize(count);
+        scores.resize(count);
+        for (int i = 0; i < count; i++) {
+            int score = 0;
+            if (hasTableMove && moves[i] == tableMove) {
+                score = kInfinite;
+            } else if constexpr (requires { { state.scoreMove(moves[i]) } -> std::convertible_to<int>; }) {
+                score = state.scoreMove(moves[i]);
+            }
+            int at = i;
+            while (at > 0 && scores[at - 1] < score) {
+                scores[at] = scores[at - 1];
+                order[at] = order[at - 1];
+                at--;
+            }
+            scores[at] = score;
+            order[at] = i;
+        }
+        return order;
+    }
+
+    Table _ownTable;
+    Table *_table;
+    std::vector<int> _order[kMaxPly + 1];
+    std::vector<int> _orderScores[kMaxPly + 1];
+    Move _rootBest{};
+    Limits _limits;
+    uint64_t _nodes = 0;
+    bool _aborted = false;
+    std::chrono::steady_clock::time_point _start;
+};
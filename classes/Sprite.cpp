@@ -25,9 +25,22 @@ bool Sprite::LoadTextureFromFile(const char* filename)
         return false;
     }
     _size = ImVec2((float)image_width, (float)image_height);
+    invalidateRender();
     return true;
 }
 
+void Sprite::invalidateRender()
+{
+    // pieces hang off their holders, so walk up to the first sprite that belongs to a grid
+    for (Entity *entity = this; entity && entity->getEntityType() >= EntitySprite; entity = entity->getParent()) {
+        Sprite *sprite = static_cast<Sprite *>(entity);
+        if (sprite->_renderRevision) {
+            (*sprite->_renderRevision)++;
+            return;
+        }
+    }
+}
+
 void Sprite::setHighlighted(bool highlighted)
 {
 	if (highlighted != _highlighted) {
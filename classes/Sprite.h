@@ -16,7 +16,9 @@ public:
         _scale(1),
         _color(1, 1, 1, 1),
         _localZOrder(0),
-        _highlighted(false)
+        _texture(0),
+        _highlighted(false),
+        _renderRevision(nullptr)
         { 
             _entityType = EntitySprite;
         };
@@ -41,6 +43,7 @@ public:
     {
         _size = ImVec2(x, y);
     }
+    const ImVec2 &getSize() { return _size; }
     // set the rotation of the sprite
     void setRotation(float rotation) { _rotation = rotation; }
     // set the scale of the sprite
@@ -76,6 +79,21 @@ public:
     }
 
     bool LoadTextureFromFile(const char* filename);
+    // share an already loaded texture instead of loading it again
+    void setTexture(ImTextureID texture, const ImVec2 &size)
+    {
+        _texture = texture;
+        _size = size;
+        invalidateRender();
+    }
+    ImTextureID getTexture() { return _texture; }
+    const ImVec4 &getColor() { return _color; }
+
+    // the revision a retained renderer watches, bumped whenever what it draws changes shape:
+    // pieces added, removed, picked up, set moving or re-skinned. positions and colors are read
+    // live every frame. a grid hands its counter to its squares, and a piece uses its holder's
+    void setRenderRevision(unsigned int *revision) { _renderRevision = revision; }
+    void invalidateRender();
 	
     // set the highlighted state
 	virtual void	setHighlighted(bool yes);
@@ -106,4 +124,8 @@ protected:
    	bool	_highlighted;
     // private platform specific texture loading
     ImTextureID _loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height);
+
+private:
+    // owned by the grid this sprite is drawn in, if any
+    unsigned int *_renderRevision;
 };
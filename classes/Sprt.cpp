@@ -0,0 +1,99 @@
+#include "Sprt.h"
+#include "Match.h"
+#include <cmath>
+
+namespace {
+    // expected score of a player elo stronger
+    double scoreFromElo(double elo)
+    {
+        return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+    }
+}
+
+Sprt::Sprt(double elo0, double elo1, double alpha, double beta) : _elo0(elo0), _elo1(elo1), _pentanomial{ 0, 0, 0, 0, 0 }
+{
+    _lowerBound = std::log(beta / (1 - alpha));
+    _upperBound = std::log((1 - beta) / alpha);
+}
+
+void Sprt::addPair(int firstScore, int secondScore)
+{
+    // -2..2 game points become 0..4 half points
+    _pentanomial[firstScore + secondScore + 2]++;
+}
+
+int Sprt::pairs() const
+{
+    int64_t pairs = 0;
+    for (int64_t count : _pentanomial) {
+        pairs += count;
+    }
+    return (int)pairs;
+}
+
+//
+// one made up pair spread over the five outcomes, so a handful of identical pairs can't make
+// the variance zero and end the test on their own. it washes out as real pairs come in
+//
+void Sprt::moments(double &mean, double &variance) const
+{
+    const double kPrior = 0.2;
+    double total = 0;
+    mean = 0;
+    for (int i = 0; i < 5; i++) {
+        double count = _pentanomial[i] + kPrior;
+        total += count;
+        mean += count * i / 4.0;
+    }
+    mean /= total;
+    variance = 0;
+    for (int i = 0; i < 5; i++) {
+        double deviation = i / 4.0 - mean;
+        variance += (_pentanomial[i] + kPrior) * deviation * deviation;
+    }
+    variance /= total;
+}
+
+double Sprt::llr() const
+{
+    int pairs = this->pairs();
+    if (pairs == 0) {
+        return 0;
+    }
+    double mean, variance;
+    moments(mean, variance);
+    double score0 = scoreFromElo(_elo0);
+    double score1 = scoreFromElo(_elo1);
+    return pairs * (score1 - score0) * (2 * mean - score0 - score1) / (2 * variance);
+}
+
+Sprt::Status Sprt::status() const
+{
+    double ratio = llr();
+    if (ratio >= _upperBound) {
+        return kAcceptH1;
+    }
+    if (ratio <= _lowerBound) {
+        return kAcceptH0;
+    }
+    return kContinue;
+}
+
+double Sprt::elo() const
+{
+    double mean, variance;
+    moments(mean, variance);
+    return MatchScore::eloFromScore(mean);
+}
+
+double Sprt::eloError() const
+{
+    int pairs = this->pairs();
+    if (pairs == 0) {
+        return 0;
+    }
+    double mean, variance;
+    moments(mean, variance);
+    double margin = 1.959964 * std::sqrt(variance / pairs);
+    return (MatchScore::eloFromScore(mean + margin) - MatchScore::eloFromScore(mean - margin)) / 2;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+//
+// sequential probability ratio test between two engines: is the first engine elo0 or elo1
+// stronger than the second. results come in pairs of games on the same opening, with either
+// engine moving first, and a pair counts as one pentanomial outcome (0, 0.5, 1, 1.5 or 2
+// points), which cancels most of what the opening itself decides
+//
+// the log likelihood ratio is the generalized SPRT's normal approximation over the pair
+// scores, in logistic elo
+//
+class Sprt
+{
+public:
+    enum Status { kContinue, kAcceptH0, kAcceptH1 };
+
+    Sprt(double elo0, double elo1, double alpha, double beta);
+
+    // the first engine's scores in a pair's two games, each 1 win, 0 draw, -1 loss
+    void addPair(int firstScore, int secondScore);
+
+    double llr() const;
+    // H0 is accepted at or below the lower bound, H1 at or above the upper
+    double lowerBound() const { return _lowerBound; }
+    double upperBound() const { return _upperBound; }
+    Status status() const;
+
+    int pairs() const;
+    // pairs scoring 0, 0.5, 1, 1.5 and 2 points for the first engine
+    const int64_t *pentanomial() const { return _pentanomial; }
+    // the elo difference the pairs imply, and the half width of its 95% interval
+    double elo() const;
+    double eloError() const;
+
+private:
+    // mean and variance of a pair's score, scaled to 0..1
+    void moments(double &mean, double &variance) const;
+
+    double _elo0;
+    double _elo1;
+    double _lowerBound;
+    double _upperBound;
+    int64_t _pentanomial[5];
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+
+//
+// a fixed set of worker threads pulling jobs off a shared queue
+// used to run game AI off the UI thread and by the headless tools to spread work across cores
+//
+class ThreadPool
+{
+public:
+    // 0 threads means one per hardware thread
+    ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // the pool shared by every game, sized to leave a core for the UI thread
+    static ThreadPool &sharedPool();
+
+    // queue a job, the future holds its result (or the exception it threw)
+    template <typename Func>
+    auto submit(Func func) -> std::future<std::invoke_result_t<Func>>
+    {
+        using Result = std::invoke_result_t<Func>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::move(func));
+        std::future<Result> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _jobs.emplace_back([task]() { (*task)(); });
+        }
+        _wake.notify_one();
+        return result;
+    }
+
+    size_t size() const { return _workers.size(); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _jobs;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    bool _stopping;
+};
@@ -1,4 +1,6 @@
 #include "TicTacToe.h"
+#include "BitPool.h"
+#include "TicTacToeTable.h"
 
 
 TicTacToe::TicTacToe()
@@ -16,12 +18,8 @@ TicTacToe::~TicTacToe()
 //
 Bit* TicTacToe::PieceForPlayer(const int playerNumber)
 {
-    // depending on playerNumber load the "x.png" or the "o.png" graphic
-    Bit *bit = new Bit();
-    // should possibly be cached from player class?
-    bit->LoadTextureFromFile(playerNumber == AI_PLAYER ? "o.png" : "x.png");
-    bit->setOwner(getPlayerAt(playerNumber == AI_PLAYER ? 1 : 0));
-    return bit;
+    // depending on playerNumber skin a pooled piece with the "x.png" or the "o.png" graphic
+    return BitPool::sharedPool().acquire(getPlayerAt(playerNumber == AI_PLAYER ? 1 : 0), playerNumber == AI_PLAYER ? "o.png" : "x.png");
 }
 
 void TicTacToe::setUpBoard()
@@ -106,14 +104,13 @@ Player* TicTacToe::checkForWinner()
 
 bool TicTacToe::checkForDraw()
 {
-    bool isDraw = true;
     // check to see if the board is full
-    _grid->forEachSquare([&isDraw](ChessSquare* square, int x, int y) {
-        if (!square->bit()) {
-            isDraw = false;
+    for (ChessSquare& square : _grid->squares()) {
+        if (!square.bit()) {
+            return false;
         }
-    });
-    return isDraw;
+    }
+    return true;
 }
 
 //
@@ -131,12 +128,12 @@ std::string TicTacToe::initialStateString()
 std::string TicTacToe::stateString()
 {
     std::string s = "000000000";
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        Bit *bit = square->bit();
+    for (ChessSquare& square : _grid->squares()) {
+        Bit *bit = square.bit();
         if (bit) {
-            s[y * 3 + x] = std::to_string(bit->getOwner()->playerNumber()+1)[0];
+            s[square.getRow() * 3 + square.getColumn()] = '1' + bit->getOwner()->playerNumber();
         }
-    });
+    }
     return s;
 }
 
@@ -163,85 +160,32 @@ void TicTacToe::setStateString(const std::string &s)
 //
 void TicTacToe::updateAI() 
 {
-    int bestVal = -1000;
-    BitHolder* bestMove = nullptr;
-    std::string state = stateString();
-
-    // Traverse all cells, evaluate minimax function for all empty cells
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        int index = y * 3 + x;
-        // Check if cell is empty
-        if (state[index] == '0') {
-            // Make the move
-            state[index] = '2';
-            int moveVal = -negamax(state, 0, HUMAN_PLAYER);
-            // Undo the move
-            state[index] = '0';
-            // If the value of the current move is more than the best value, update best
-            if (moveVal > bestVal) {
-                bestMove = square;
-                bestVal = moveVal;
-            }
-        }
-    });
-
-
-    // Make the best move
-    if(bestMove) {
-        if (actionForEmptyHolder(*bestMove)) {
-        }
-    }
-}
-
-bool isAIBoardFull(const std::string& state) {
-    return state.find('0') == std::string::npos;
-}
-
-int evaluateAIBoard(const std::string& state) {
-    static const int kWinningTriples[8][3] =  { {0,1,2}, {3,4,5}, {6,7,8},  // rows
-                                                {0,3,6}, {1,4,7}, {2,5,8},  // cols
-                                                {0,4,8}, {2,4,6} };         // diagonals
-    for( int i=0; i<8; i++ ) {
-        const int *triple = kWinningTriples[i];
-        char first = state[triple[0]];
-        if( first != '0' && first == state[triple[1]] && first == state[triple[2]] ) {
-            return 10;   // someone won, negamax will handle who
-        }
-    }
-    return 0; // No winner
+    applyAIMove(searchAIMove(stateString(), getCurrentPlayer()->playerNumber(), aiOptions()));
 }
 
 //
-// player is the current player's number (AI or human)
+// pick the best square for playerNumber using only the state string, so this can run on a worker thread
+// the move is returned as the square index
 //
-int TicTacToe::negamax(std::string& state, int depth, int playerColor) 
+std::string TicTacToe::searchAIMove(const std::string &snapshot, int playerNumber, const AIOptions &options)
 {
-    int score = evaluateAIBoard(state);
-
-    // Check if AI wins, human wins, or draw
-    if(score) { 
-        // A winning state is a loss for the player whose turn it is.
-        // The previous player made the winning move.
-        return -score; 
-    }
-
-    if(isAIBoardFull(state)) {
-        return 0; // Draw
+    TicTacToeBoard board = TicTacToeBoard::fromState(snapshot, playerNumber);
+    // every position was solved when this was compiled
+    int bestMove = solvedTicTacToe(board).bestMove;
+    if (bestMove < 0) {
+        // a position no game reaches (say O moved first) isn't in the table, any move will do
+        TicTacToeBoard::MoveList list;
+        board.generateMoves(list);
+        bestMove = list.count ? list.moves[0] : -1;
     }
+    return bestMove >= 0 ? std::to_string(bestMove) : "";
+}
 
-    int bestVal = -1000; // Min value
-    for (int y = 0; y < 3; y++) {
-        for (int x = 0; x < 3; x++) {
-            // Check if cell is empty
-            if (state[y * 3 + x] == '0') {
-                // Make the move
-                state[y * 3 + x] = playerColor == HUMAN_PLAYER ? '1' : '2'; // Set the cell to the current player's color
-                bestVal = std::max(bestVal, -negamax(state, depth + 1, -playerColor));
-                // Undo the move for backtracking
-                state[y * 3 + x] = '0';
-            }
-        }
+bool TicTacToe::applyAIMove(const std::string &move)
+{
+    if (move.empty()) {
+        return false;
     }
-
-    return bestVal;
-}
\ No newline at end of file
+    ChessSquare* square = _grid->getSquareByIndex(std::stoi(move));
+    return square && actionForEmptyHolder(*square);
+}
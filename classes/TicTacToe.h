@@ -29,11 +29,13 @@ public:
 
 	void        updateAI() override;
     bool        gameHasAI() override { return true; }
+    bool        gameHasBackgroundAI() override { return true; }
+    std::string searchAIMove(const std::string &state, int playerNumber, const AIOptions &options) override;
+    bool        applyAIMove(const std::string &move) override;
     Grid* getGrid() override { return _grid; }
 private:
     Bit *       PieceForPlayer(const int playerNumber);
     Player*     ownerAt(int index ) const;
-    int         negamax(std::string& state, int depth, int playerColor);
 
     Grid*       _grid;
 };
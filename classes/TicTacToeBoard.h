@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Search.h"
+#include <cstdint>
+#include <bit>
+#include <string>
+
+//
+// tic tac toe position as two 9-bit masks, cell y * 3 + x, side 0 plays X and side 1 plays O
+// it's a SearchState, so Search can play it
+//
+class TicTacToeBoard
+{
+public:
+    using Move = int;
+    struct MoveList
+    {
+        int moves[9] = {};
+        int count = 0;
+
+        constexpr int *begin() { return moves; }
+        constexpr int *end() { return moves + count; }
+        constexpr const int *begin() const { return moves; }
+        constexpr const int *end() const { return moves + count; }
+    };
+
+    constexpr TicTacToeBoard() : _cells{ 0, 0 }, _side(0) {}
+    constexpr TicTacToeBoard(uint16_t xCells, uint16_t oCells, int side) : _cells{ xCells, oCells }, _side(side) {}
+
+    // the TicTacToe game's 9 character state ('0' empty, '1' X, '2' O)
+    static TicTacToeBoard fromState(const std::string &state, int side)
+    {
+        uint16_t cells[2] = { 0, 0 };
+        for (int cell = 0; cell < 9 && cell < (int)state.length(); cell++) {
+            if (state[cell] == '1' || state[cell] == '2') {
+                cells[state[cell] - '1'] |= (uint16_t)(1 << cell);
+            }
+        }
+        return TicTacToeBoard(cells[0], cells[1], side);
+    }
+
+    constexpr uint16_t cells(int side) const { return _cells[side]; }
+    constexpr uint16_t empty() const { return (uint16_t)(kFull & ~(_cells[0] | _cells[1])); }
+    constexpr int sideToMove() const { return _side; }
+
+    constexpr bool hasLine(int side) const
+    {
+        for (uint16_t line : kLines) {
+            if ((_cells[side] & line) == line) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // no moves once someone has a line or the board is full
+    constexpr void generateMoves(MoveList &list) const
+    {
+        list.count = 0;
+        if (hasLine(0) || hasLine(1)) {
+            return;
+        }
+        for (uint16_t bits = empty(); bits; bits &= bits - 1) {
+            list.moves[list.count++] = std::countr_zero(bits);
+        }
+    }
+
+    constexpr void make(int cell)
+    {
+        _cells[_side] |= (uint16_t)(1 << cell);
+        _side ^= 1;
+    }
+
+    constexpr void unmake(int cell)
+    {
+        _side ^= 1;
+        _cells[_side] &= (uint16_t)~(1 << cell);
+    }
+
+    // only a finished game scores, a line can only belong to the side that just moved
+    constexpr int evaluate() const { return hasLine(_side ^ 1) ? -kSearchWinScore : 0; }
+
+    // base 3 number with a digit per cell (0 empty, 1 X, 2 O), cell 0 the lowest digit
+    constexpr int index() const
+    {
+        int index = 0;
+        for (int cell = 8; cell >= 0; cell--) {
+            index = index * 3 + ((_cells[0] >> cell) & 1) + 2 * ((_cells[1] >> cell) & 1);
+        }
+        return index;
+    }
+    static constexpr TicTacToeBoard fromIndex(int index, int side)
+    {
+        uint16_t cells[2] = { 0, 0 };
+        for (int cell = 0; cell < 9; cell++, index /= 3) {
+            if (index % 3) {
+                cells[index % 3 - 1] |= (uint16_t)(1 << cell);
+            }
+        }
+        return TicTacToeBoard(cells[0], cells[1], side);
+    }
+    static constexpr int kPositions = 19683;
+
+    // the whole position fits, so this is exact
+    constexpr uint64_t hash() const { return _cells[0] | (uint64_t)_cells[1] << 9 | (uint64_t)_side << 18; }
+
+    // the centre, then corners, then edges
+    constexpr int scoreMove(int cell) const { return cell == 4 ? 2 : (cell % 2 == 0 ? 1 : 0); }
+
+    static constexpr uint16_t kFull = 0x1ff;
+    static constexpr uint16_t kLines[8] = { 0007, 0070, 0700,   // rows
+                                            0111, 0222, 0444,   // cols
+                                            0421, 0124 };       // diagonals
+
+private:
+    uint16_t _cells[2];
+    int _side;
+};
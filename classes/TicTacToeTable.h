@@ -0,0 +1,105 @@
+#pragma once
+
+#include "TicTacToeBoard.h"
+#include <array>
+#include <cstdint>
+
+//
+// tic tac toe solved at compile time: the value and best move of every position, 3^9 entries
+// indexed by TicTacToeBoard::index(). X always moves first, so the side to move follows from
+// the counts. positions no game can reach, including any played on past a win, are left as
+// { 0, -1 }
+//
+struct TicTacToeEntry
+{
+    // for the side to move: 10 - plies to a win, -(10 - plies) to a loss, 0 for a draw
+    int8_t score;
+    // -1 once the game is over
+    int8_t bestMove;
+};
+
+using TicTacToeTable = std::array<TicTacToeEntry, TicTacToeBoard::kPositions>;
+
+// what the table build carries down its walk
+struct TicTacToeSolver
+{
+    TicTacToeEntry *table;
+    bool *solved;
+    // whether a mask of cells holds a line
+    const bool *hasLine;
+};
+
+// solve the position at index and everything below it not yet solved, a depth first walk that
+// only visits positions play can reach
+constexpr void solveTicTacToe(const TicTacToeSolver &solver, uint16_t xCells, uint16_t oCells, int side, int index)
+{
+    TicTacToeEntry &entry = solver.table[index];
+    solver.solved[index] = true;
+    uint16_t empty = (uint16_t)(0x1ff & ~(xCells | oCells));
+    if (solver.hasLine[xCells] || solver.hasLine[oCells] || empty == 0) {
+        // only the side that just moved can have a line
+        entry.score = (int8_t)(solver.hasLine[side ? xCells : oCells] ? -10 : 0);
+        return;
+    }
+    entry.score = -127;
+    for (int cell = 0, power = 1; cell < 9; cell++, power *= 3) {
+        uint16_t bit = (uint16_t)(1 << cell);
+        if (empty & bit) {
+            // the child's index without building it
+            int child = index + (side + 1) * power;
+            if (!solver.solved[child]) {
+                solveTicTacToe(solver, side ? xCells : xCells | bit, side ? oCells | bit : oCells, side ^ 1, child);
+            }
+            int childScore = solver.table[child].score;
+            // one ply further away than the child's result
+            int score = childScore < 0 ? -childScore - 1 : (childScore > 0 ? -childScore + 1 : 0);
+            if (score > entry.score) {
+                entry.score = (int8_t)score;
+                entry.bestMove = (int8_t)cell;
+            }
+        }
+    }
+}
+
+//
+// compilers cap the work a constant expression may do, clang at a million steps by default and
+// MSVC at far fewer, so the table is built by walking down from the empty board through only
+// the positions play can reach, with lines looked up by mask. CMakeLists raises both caps
+//
+constexpr TicTacToeTable buildTicTacToeTable()
+{
+    // every mask holding a line: each line's supersets, found as its subsets of the other cells
+    bool hasLine[512] = {};
+    const uint16_t lines[8] = { 0007, 0070, 0700, 0111, 0222, 0444, 0421, 0124 };
+    for (uint16_t line : lines) {
+        uint16_t rest = 0x1ff & ~line;
+        for (uint16_t extra = rest;; extra = (extra - 1) & rest) {
+            hasLine[line | extra] = true;
+            if (extra == 0) {
+                break;
+            }
+        }
+    }
+
+    TicTacToeTable table{};
+    TicTacToeEntry *entries = table.data();
+    for (int index = 0; index < TicTacToeBoard::kPositions; index++) {
+        entries[index].bestMove = -1;
+    }
+    bool solved[TicTacToeBoard::kPositions] = {};
+    solveTicTacToe(TicTacToeSolver{ entries, solved, hasLine }, 0, 0, 0, 0);
+    return table;
+}
+
+inline constexpr TicTacToeTable kTicTacToeTable = buildTicTacToeTable();
+
+constexpr const TicTacToeEntry &solvedTicTacToe(const TicTacToeBoard &board)
+{
+    return kTicTacToeTable[board.index()];
+}
+
+// perfect play from the empty board is a draw, and after X opens in the corner too
+static_assert(solvedTicTacToe(TicTacToeBoard()).score == 0);
+static_assert(solvedTicTacToe(TicTacToeBoard(0001, 0, 1)).score == 0);
+// X to move with two in a row wins straight away
+static_assert(solvedTicTacToe(TicTacToeBoard(0003, 0030, 0)).bestMove == 2);
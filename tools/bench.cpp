@@ -0,0 +1,195 @@
+//
+// bench: runs every game's AI over a fixed set of positions at fixed depth on one thread and
+// prints the nodes searched and the speed. the connect 4 solver solves its positions outright
+// and MCTS runs a fixed number of seeded iterations
+//
+//   bench [expected total nodes]
+//
+// the node total is a signature of the searches: a change that only makes them faster leaves
+// it alone, anything that changes what they search changes it. given the expected total, the
+// exit status says whether it matched
+//
+#include "classes/ChessAI.h"
+#include "classes/CheckersAI.h"
+#include "classes/Connect4MCTS.h"
+#include "classes/Connect4Solver.h"
+#include "classes/OthelloAI.h"
+#include "classes/Search.h"
+#include "classes/TicTacToeBoard.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static const int kTicTacToeDepth = 9;
+static const int kOthelloDepth = 9;
+static const int kCheckersDepth = 11;
+static const int kChessDepth = 10;
+static const uint64_t kMCTSIterations = 20000;
+static const uint64_t kMCTSSeed = 1;
+
+// X and O cells, side to move
+static const TicTacToeBoard kTicTacToePositions[] = {
+    TicTacToeBoard(),
+    TicTacToeBoard(0020, 0, 1),
+    TicTacToeBoard(0001, 0020, 0),
+    TicTacToeBoard(0041, 0022, 0),
+};
+
+// side to move's discs, then the other side's; all have more empties than the exact solver takes
+static const OthelloBoard kOthelloPositions[] = {
+    OthelloBoard::initialPosition(),
+    OthelloBoard(0x0000040c1c000000ull, 0x0000005020183800ull),
+    OthelloBoard(0x0000001020142004ull, 0x0008782818081f20ull),
+    OthelloBoard(0x048004044f081020ull, 0x0224e87830324200ull),
+};
+
+// the Checkers game's state strings, red to move
+static const char *kCheckersPositions[] = {
+    "11111111111100000000333333333333",
+    "11111111100101000330330030333333",
+    "11111010000100100003300030333303",
+    "01111010000110000003103033013303",
+};
+
+// columns played from the empty board, 1 to 7. the solver plays them out exactly, so each has
+// at least 12 stones down to keep it within 30 plies
+static const char *kConnect4Positions[] = {
+    "53244515333112",
+    "4573552665545127",
+    "677235441267",
+    "73341254134345",
+};
+
+// where the Connect4 game's MCTS player is tried, with too many empties to solve
+static const char *kMCTSPositions[] = {
+    "",
+    "4453",
+    "44335261",
+};
+
+static Connect4Board connect4Position(const char *columns)
+{
+    Connect4Board board;
+    for (const char *column = columns; *column; column++) {
+        board.play(*column - '1');
+    }
+    return board;
+}
+
+static const char *kChessPositions[] = {
+    ChessBoard::kStartFEN,
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+    "r2q1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP2BPPP/R2Q1RK1 w - - 0 9",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "6k1/5ppp/8/8/8/2N5/5PPP/3R2K1 w - - 0 1",
+};
+
+struct GameBench
+{
+    const char *name;
+    uint64_t nodes = 0;
+    double seconds = 0;
+};
+
+template <typename Func>
+static GameBench runBench(const char *name, Func searchAll)
+{
+    GameBench bench;
+    bench.name = name;
+    auto start = std::chrono::steady_clock::now();
+    bench.nodes = searchAll();
+    bench.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return bench;
+}
+
+int main(int argc, char **argv)
+{
+    // every position gets a fresh AI, so nothing learned on one can change the next
+    GameBench benches[] = {
+        runBench("tictactoe", []() {
+            uint64_t nodes = 0;
+            for (TicTacToeBoard board : kTicTacToePositions) {
+                // the full width negamax, then the alpha-beta search the other games are built on
+                Search<TicTacToeBoard> search(1 << 12);
+                search.negamax(board, kTicTacToeDepth);
+                nodes += search.nodes();
+                Search<TicTacToeBoard>::Limits limits;
+                limits.maxDepth = kTicTacToeDepth;
+                nodes += search.run(board, limits).nodes;
+            }
+            return nodes;
+        }),
+        runBench("connect4", []() {
+            uint64_t nodes = 0;
+            for (const char *columns : kConnect4Positions) {
+                Connect4Solver solver;
+                solver.solve(connect4Position(columns));
+                nodes += solver.nodes();
+            }
+            return nodes;
+        }),
+        runBench("mcts", []() {
+            // one thread, a seed and an iteration count rather than a time limit, so the tree
+            // grows the same way every run. its size is the node count
+            uint64_t nodes = 0;
+            for (const char *columns : kMCTSPositions) {
+                MCTS<Connect4MCTSState, Connect4Playout> mcts(1 << 16, 1);
+                mcts.setSeed(kMCTSSeed);
+                MCTS<Connect4MCTSState, Connect4Playout>::Limits limits;
+                limits.timeLimitMs = 0;
+                limits.maxIterations = kMCTSIterations;
+                nodes += mcts.search(Connect4MCTSState(connect4Position(columns)), limits).nodes;
+            }
+            return nodes;
+        }),
+        runBench("othello", []() {
+            uint64_t nodes = 0;
+            for (const OthelloBoard &board : kOthelloPositions) {
+                OthelloAI ai;
+                ai.findMove(board, kOthelloDepth, 0);
+                nodes += ai.nodes();
+            }
+            return nodes;
+        }),
+        runBench("checkers", []() {
+            uint64_t nodes = 0;
+            for (const char *state : kCheckersPositions) {
+                CheckersAI ai;
+                CheckersMove move;
+                ai.findMove(CheckersBoard::fromState(state, CheckersBoard::kRed), kCheckersDepth, 0, move);
+                nodes += ai.nodes();
+            }
+            return nodes;
+        }),
+        runBench("chess", []() {
+            uint64_t nodes = 0;
+            for (const char *fen : kChessPositions) {
+                ChessAI ai;
+                ChessBoard board;
+                board.setFEN(fen);
+                ChessAI::Limits limits;
+                limits.maxDepth = kChessDepth;
+                nodes += ai.search(board, limits).nodes;
+            }
+            return nodes;
+        }),
+    };
+
+    uint64_t nodes = 0;
+    double seconds = 0;
+    for (const GameBench &bench : benches) {
+        std::printf("%-10s %12llu nodes %8.3fs %10.0f nps\n", bench.name, (unsigned long long)bench.nodes, bench.seconds, bench.nodes / std::max(bench.seconds, 1e-9));
+        nodes += bench.nodes;
+        seconds += bench.seconds;
+    }
+    std::printf("total      %12llu nodes %8.3fs %10.0f nps\n", (unsigned long long)nodes, seconds, nodes / std::max(seconds, 1e-9));
+
+    if (argc > 1 && std::strtoull(argv[1], nullptr, 10) != nodes) {
+        std::fprintf(stderr, "node signature %llu doesn't match the expected %s\n", (unsigned long long)nodes, argv[1]);
+        return 1;
+    }
+    return 0;
+}
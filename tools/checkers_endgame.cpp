@@ -0,0 +1,243 @@
+//
+// checkers_endgame: solves every checkers position with up to some number of pieces by
+// retrograde analysis and writes the win/loss/draw database CheckersEndgame reads
+//
+//   checkers_endgame <output file> [max pieces, default 4]
+//
+// slices are solved smallest first: captures lead to fewer pieces and crowning to fewer men,
+// so by the time a slice is solved everything it can leave to is known. a slice and its
+// colour swapped twin (what the position looks like after a move) are solved together:
+//
+//   - every position is looked at once, moves leaving the group decide it straight away
+//     (won if one reaches a lost position) and the moves staying in it are counted
+//   - each decided position then works backwards through the simple moves that could have led
+//     to it: a loss wins every predecessor, a win counts one of the predecessor's moves off and
+//     loses it once none are left
+//   - whatever is never decided can't be forced either way, so it's drawn
+//
+#include "classes/CheckersEndgame.h"
+#include "classes/ThreadPool.h"
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+namespace {
+    const int kSide = CheckersEndgame::kMaxPieces + 1;
+
+    struct Database
+    {
+        std::vector<CheckersEndgame::Slice> slices;
+        std::vector<std::vector<uint8_t>> values;
+        // slice index by piece counts, -1 until it's added
+        std::vector<int> ids = std::vector<int>(kSide * kSide * kSide * kSide, -1);
+
+        static int key(const CheckersEndgame::Slice &slice)
+        {
+            return ((slice.redMen * kSide + slice.redKings) * kSide + slice.yellowMen) * kSide + slice.yellowKings;
+        }
+
+        int add(const CheckersEndgame::Slice &slice)
+        {
+            if (ids[key(slice)] >= 0) {
+                return ids[key(slice)];
+            }
+            ids[key(slice)] = (int)slices.size();
+            slices.push_back(slice);
+            values.emplace_back(CheckersEndgame::sliceSize(slice), CheckersEndgame::kUnknown);
+            return (int)slices.size() - 1;
+        }
+
+        // value of the position after a move, from the point of view of the side now to move
+        uint8_t valueAfter(const CheckersBoard &child) const
+        {
+            CheckersBoard position = child.flipped();
+            if (position.pieces(CheckersBoard::kRed) == 0) {
+                return CheckersEndgame::kLoss;
+            }
+            return values[ids[key(CheckersEndgame::sliceOf(position))]][CheckersEndgame::indexOf(position)];
+        }
+    };
+
+    struct Position
+    {
+        int slice;
+        uint64_t index;
+    };
+
+    // a group's positions that still have undecided moves, with how many
+    using MoveCounts = std::vector<std::vector<uint8_t>>;
+
+    // the first look at positions first..last of a slice, the ones it decides are returned
+    std::vector<Position> examine(Database &database, MoveCounts &counts, int id, uint64_t first, uint64_t last)
+    {
+        std::vector<Position> decided;
+        std::vector<uint8_t> &values = database.values[id];
+        for (uint64_t index = first; index < last; index++) {
+            CheckersBoard board;
+            if (!CheckersEndgame::positionAt(database.slices[id], index, board)) {
+                continue;
+            }
+            CheckersMoveList list;
+            board.generateMoves(list);
+            uint8_t value = CheckersEndgame::kUnknown;
+            // moves that might still keep the position from being lost
+            int undecided = 0;
+            for (const CheckersMove &move : list) {
+                bool crowns = (board.men(CheckersBoard::kRed) & move.from) && (move.to & CheckersBoard::kPromotionRow[CheckersBoard::kRed]);
+                if (!move.isCapture() && !crowns) {
+                    undecided++;
+                    continue;
+                }
+                CheckersBoard child = board;
+                child.make(move);
+                uint8_t childValue = database.valueAfter(child);
+                if (childValue == CheckersEndgame::kLoss) {
+                    value = CheckersEndgame::kWin;
+                    break;
+                }
+                // a drawn child is never decided, so it keeps the count above zero for good
+                if (childValue == CheckersEndgame::kDraw) {
+                    undecided++;
+                }
+            }
+            if (value == CheckersEndgame::kUnknown && undecided == 0) {
+                value = CheckersEndgame::kLoss;
+            }
+            if (value != CheckersEndgame::kUnknown) {
+                values[index] = value;
+                decided.push_back(Position{ id, index });
+            } else {
+                counts[id][index] = (uint8_t)undecided;
+            }
+        }
+        return decided;
+    }
+
+    // positions with red to move whose simple move (no capture, no crowning) leads to board,
+    // which has red to move too. each is found as yellow undoing its last move
+    template <typename Visit>
+    void forEachPredecessor(const CheckersBoard &board, Visit visit)
+    {
+        uint32_t men = board.men(CheckersBoard::kYellow);
+        uint32_t kings = board.kings(CheckersBoard::kYellow);
+        uint32_t open = board.empty();
+        for (uint32_t bits = men | kings; bits; bits &= bits - 1) {
+            uint32_t at = bits & (0u - bits);
+            bool king = (kings & at) != 0;
+            for (int direction = 0; direction < 4; direction++) {
+                // yellow men only move up, so they can only have come from below
+                if (!king && direction >= 2) {
+                    continue;
+                }
+                uint32_t from = CheckersBoard::step(at, direction) & open;
+                if (!from) {
+                    continue;
+                }
+                CheckersBoard before(board.men(CheckersBoard::kRed), board.kings(CheckersBoard::kRed),
+                                     king ? men : (men ^ at ^ from), king ? (kings ^ at ^ from) : kings, CheckersBoard::kYellow);
+                // with a capture on the board the simple move wasn't allowed
+                if (!before.hasCapture()) {
+                    visit(before.flipped());
+                }
+            }
+        }
+    }
+
+    void solveGroup(Database &database, const std::vector<int> &group, ThreadPool &pool)
+    {
+        MoveCounts counts(database.slices.size());
+        std::vector<std::future<std::vector<Position>>> chunks;
+        const uint64_t chunkSize = 1 << 16;
+        for (int id : group) {
+            counts[id].assign(database.values[id].size(), 0);
+            for (uint64_t first = 0; first < database.values[id].size(); first += chunkSize) {
+                uint64_t last = std::min<uint64_t>(database.values[id].size(), first + chunkSize);
+                // chunks only write their own range, and only read slices solved earlier
+                chunks.push_back(pool.submit([&database, &counts, id, first, last]() {
+                    return examine(database, counts, id, first, last);
+                }));
+            }
+        }
+        std::vector<Position> decided;
+        for (auto &chunk : chunks) {
+            std::vector<Position> positions = chunk.get();
+            decided.insert(decided.end(), positions.begin(), positions.end());
+        }
+
+        while (!decided.empty()) {
+            Position position = decided.back();
+            decided.pop_back();
+            CheckersBoard board;
+            CheckersEndgame::positionAt(database.slices[position.slice], position.index, board);
+            uint8_t value = database.values[position.slice][position.index];
+            forEachPredecessor(board, [&](const CheckersBoard &predecessor) {
+                int id = database.ids[Database::key(CheckersEndgame::sliceOf(predecessor))];
+                uint64_t index = CheckersEndgame::indexOf(predecessor);
+                uint8_t &predecessorValue = database.values[id][index];
+                if (predecessorValue != CheckersEndgame::kUnknown) {
+                    return;
+                }
+                if (value == CheckersEndgame::kLoss) {
+                    predecessorValue = CheckersEndgame::kWin;
+                } else if (--counts[id][index] == 0) {
+                    predecessorValue = CheckersEndgame::kLoss;
+                } else {
+                    return;
+                }
+                decided.push_back(Position{ id, index });
+            });
+        }
+
+        for (int id : group) {
+            for (uint64_t index = 0; index < counts[id].size(); index++) {
+                if (counts[id][index] > 0 && database.values[id][index] == CheckersEndgame::kUnknown) {
+                    database.values[id][index] = CheckersEndgame::kDraw;
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <output file> [max pieces, default 4]\n", argv[0]);
+        return 1;
+    }
+    std::string output = argv[1];
+    int maxPieces = argc > 2 ? std::atoi(argv[2]) : 4;
+    if (maxPieces < 2 || maxPieces > CheckersEndgame::kMaxPieces) {
+        std::fprintf(stderr, "max pieces must be between 2 and %d\n", CheckersEndgame::kMaxPieces);
+        return 1;
+    }
+
+    Database database;
+    ThreadPool pool;
+    for (int pieces = 2; pieces <= maxPieces; pieces++) {
+        // fewer men first, crowning a man moves a position to the slice with one man less
+        for (int men = 0; men <= pieces; men++) {
+            for (int redMen = 0; redMen <= men; redMen++) {
+                for (int redKings = 0; redKings <= pieces - men; redKings++) {
+                    CheckersEndgame::Slice slice{ (uint8_t)redMen, (uint8_t)redKings, (uint8_t)(men - redMen), (uint8_t)(pieces - men - redKings) };
+                    if (slice.redMen + slice.redKings == 0 || slice.yellowMen + slice.yellowKings == 0 ||
+                        database.ids[Database::key(slice)] >= 0) {
+                        continue;
+                    }
+                    std::vector<int> group = { database.add(slice) };
+                    if (Database::key(slice.flipped()) != Database::key(slice)) {
+                        group.push_back(database.add(slice.flipped()));
+                    }
+                    solveGroup(database, group, pool);
+                    std::fprintf(stderr, "solved %d%d%d%d\n", slice.redMen, slice.redKings, slice.yellowMen, slice.yellowKings);
+                }
+            }
+        }
+    }
+
+    if (!CheckersEndgame::write(output, maxPieces, database.slices, database.values)) {
+        std::fprintf(stderr, "could not write %s\n", output.c_str());
+        return 1;
+    }
+    std::fprintf(stderr, "wrote %zu slices to %s\n", database.slices.size(), output.c_str());
+    return 0;
+}
@@ -0,0 +1,90 @@
+//
+// connect4_book: solves every connect 4 position up to a ply and writes them as an opening
+// book for Connect4Book
+//
+//   connect4_book <output file> [max ply, default 8]
+//
+// positions are collected once per mirror pair, then solved across all cores with one
+// solver (and transposition table) per worker thread
+//
+#include "classes/Connect4Book.h"
+#include "classes/Connect4Solver.h"
+#include "classes/ThreadPool.h"
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <unordered_set>
+
+static void collectPositions(const Connect4Board &board, int maxPly, std::unordered_set<uint64_t> &seen, std::vector<Connect4Board> &positions)
+{
+    if (!seen.insert(board.canonicalKey()).second) {
+        return;
+    }
+    positions.push_back(board);
+    if (board.moveCount() >= maxPly) {
+        return;
+    }
+    for (int column = 0; column < Connect4Board::kWidth; column++) {
+        // a winning move ends the game, so its position never needs a book answer
+        if (board.canPlay(column) && !board.isWinningMove(column)) {
+            Connect4Board child = board;
+            child.play(column);
+            collectPositions(child, maxPly, seen, positions);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <output file> [max ply, default 8]\n", argv[0]);
+        return 1;
+    }
+    std::string output = argv[1];
+    int maxPly = argc > 2 ? std::atoi(argv[2]) : 8;
+    if (maxPly < 0 || maxPly > Connect4Board::kCells) {
+        std::fprintf(stderr, "max ply must be between 0 and %d\n", Connect4Board::kCells);
+        return 1;
+    }
+
+    std::unordered_set<uint64_t> seen;
+    std::vector<Connect4Board> positions;
+    collectPositions(Connect4Board(), maxPly, seen, positions);
+    std::fprintf(stderr, "solving %zu positions up to ply %d\n", positions.size(), maxPly);
+
+    // deepest first, they're the quickest and warm each worker's table for the shallower ones
+    std::stable_sort(positions.begin(), positions.end(), [](const Connect4Board &a, const Connect4Board &b) {
+        return a.moveCount() > b.moveCount();
+    });
+
+    ThreadPool pool;
+    const size_t chunkSize = 64;
+    std::vector<std::future<std::vector<uint64_t>>> chunks;
+    for (size_t first = 0; first < positions.size(); first += chunkSize) {
+        size_t last = std::min(positions.size(), first + chunkSize);
+        chunks.push_back(pool.submit([&positions, first, last]() {
+            thread_local Connect4Solver solver(1 << 22);
+            std::vector<uint64_t> entries;
+            for (size_t i = first; i < last; i++) {
+                entries.push_back(Connect4Book::packEntry(positions[i].canonicalKey(), solver.solve(positions[i])));
+            }
+            return entries;
+        }));
+    }
+
+    std::vector<uint64_t> entries;
+    entries.reserve(positions.size());
+    for (size_t i = 0; i < chunks.size(); i++) {
+        std::vector<uint64_t> chunk = chunks[i].get();
+        entries.insert(entries.end(), chunk.begin(), chunk.end());
+        std::fprintf(stderr, "\r%zu / %zu", entries.size(), positions.size());
+    }
+    std::fprintf(stderr, "\n");
+
+    if (!Connect4Book::write(output, entries, maxPly)) {
+        std::fprintf(stderr, "could not write %s\n", output.c_str());
+        return 1;
+    }
+    std::fprintf(stderr, "wrote %zu entries to %s\n", entries.size(), output.c_str());
+    return 0;
+}
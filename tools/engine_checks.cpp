@@ -0,0 +1,324 @@
+//
+// engine_checks: regression checks on the engine library that the bench's node signature
+// wouldn't pin down, one named check per run so each is its own test
+//
+//   engine_checks <check> [file]
+//
+// prints what failed and exits non-zero, or prints nothing and exits zero. checks that need a
+// file, such as a database another tool built, take it after their name
+//
+#include "classes/ChessAI.h"
+#include "classes/CheckersAI.h"
+#include "classes/CheckersBoard.h"
+#include "classes/CheckersEndgame.h"
+#include "classes/ChessTrainingData.h"
+#include "classes/Search.h"
+#include "classes/TicTacToeBoard.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+static int failures = 0;
+// the file after the check's name, nullptr if there isn't one
+static const char *fileArgument = nullptr;
+
+static void expect(bool condition, const char *what)
+{
+    if (!condition) {
+        std::fprintf(stderr, "FAIL %s\n", what);
+        failures++;
+    }
+}
+
+//
+// a king whose jumps end where it started: it has to stay on the board and the hash has to
+// match the position's
+//
+static void checkersKingCycle()
+{
+    // red king at x 0 y 3, yellow men on the four squares around x 2 y 3
+    uint32_t king = 1u << CheckersBoard::squareAt(0, 3);
+    uint32_t men = 0;
+    const int around[4][2] = { { 1, 4 }, { 3, 4 }, { 3, 2 }, { 1, 2 } };
+    for (const auto &square : around) {
+        men |= 1u << CheckersBoard::squareAt(square[0], square[1]);
+    }
+    CheckersBoard board(0, king, men, 0, CheckersBoard::kRed);
+
+    CheckersMoveList list;
+    board.generateMoves(list);
+    const CheckersMove *cycle = nullptr;
+    for (const CheckersMove &move : list) {
+        if (move.from == move.to && move.captured == men) {
+            cycle = &move;
+        }
+    }
+    expect(cycle != nullptr, "the king's jump round all four men is generated");
+    if (!cycle) {
+        return;
+    }
+    board.make(*cycle);
+    CheckersBoard expected(0, king, 0, 0, CheckersBoard::kYellow);
+    expect(board == expected, "the king is back on its square with the men gone");
+    expect(board.hash() == expected.hash(), "the hash matches a board built from scratch");
+}
+
+//
+// Search::run at a fixed depth has to score a position just as the full width negamax does,
+// alpha-beta and the table only save work. a search with its own table and two searches
+// taking turns on one shared table are both checked at every depth up to maxDepth
+//
+template <typename State>
+static void compareWithNegamax(const char *name, const State &position, int maxDepth)
+{
+    typename Search<State>::Table shared(1 << 16);
+    Search<State> first(1), second(1);
+    first.setTable(&shared);
+    second.setTable(&shared);
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        State state = position;
+        int expected = Search<State>(1).negamax(state, depth);
+        typename Search<State>::Limits limits;
+        limits.maxDepth = depth;
+        int own = Search<State>(1 << 16).run(state, limits).score;
+        int sharing = (depth % 2 ? first : second).run(state, limits).score;
+
+        std::string what = std::string(name) + " at depth " + std::to_string(depth) + ": negamax " + std::to_string(expected);
+        expect(own == expected, (what + ", search " + std::to_string(own)).c_str());
+        expect(sharing == expected, (what + ", search on a shared table " + std::to_string(sharing)).c_str());
+    }
+}
+
+// the checkers search state without its forcing hook, so captures at the horizon aren't
+// searched past and negamax sees the same tree
+class FixedDepthCheckersState
+{
+public:
+    using Move = CheckersMove;
+    using MoveList = CheckersMoveList;
+
+    FixedDepthCheckersState(const CheckersBoard &board) : _state(board) {}
+
+    void generateMoves(CheckersMoveList &list) const { _state.generateMoves(list); }
+    void make(const CheckersMove &move) { _state.make(move); }
+    void unmake(const CheckersMove &move) { _state.unmake(move); }
+    int evaluate() const { return _state.evaluate(); }
+    uint64_t hash() const { return _state.hash(); }
+    int scoreMove(const CheckersMove &move) const { return _state.scoreMove(move); }
+
+private:
+    CheckersSearchState _state;
+};
+
+static void searchMatchesNegamax()
+{
+    compareWithNegamax("tic tac toe from the empty board", TicTacToeBoard(), 9);
+    compareWithNegamax("tic tac toe after a corner and the centre", TicTacToeBoard(0001, 0020, 0), 7);
+
+    // the Checkers game's state strings, red to move
+    const char *checkers[] = {
+        "11111111111100000000333333333333",
+        "11111111100101000330330030333333",
+        "01111010000110000003103033013303",
+    };
+    for (const char *state : checkers) {
+        std::string name = std::string("checkers ") + state;
+        compareWithNegamax(name.c_str(), FixedDepthCheckersState(CheckersBoard::fromState(state, CheckersBoard::kRed)), 6);
+    }
+}
+
+//
+// a node limit stops a search on the count it was given, not the next multiple of however
+// often the clock is read
+//
+static void nodeLimits()
+{
+    for (uint64_t limit : { 1000, 5000, 9000 }) {
+        ChessAI ai;
+        ChessAI::Limits limits;
+        limits.timeLimitMs = 0;
+        limits.nodeLimit = limit;
+        uint64_t nodes = ai.search(ChessBoard::startPosition(), limits).nodes;
+        expect(nodes == limit, ("chess searched " + std::to_string(nodes) + " nodes with a limit of " + std::to_string(limit)).c_str());
+
+        CheckersSearchState state(CheckersBoard::initialPosition());
+        Search<CheckersSearchState>::Limits searchLimits;
+        searchLimits.nodeLimit = limit;
+        nodes = Search<CheckersSearchState>(1 << 16).run(state, searchLimits).nodes;
+        expect(nodes == limit, ("Search searched " + std::to_string(nodes) + " checkers nodes with a limit of " + std::to_string(limit)).c_str());
+    }
+}
+
+//
+// the endgame index round trips over every slice of up to 3 pieces, and a database built by
+// checkers_endgame, passed in as the file, agrees with one ply of lookahead everywhere: a
+// position is won when a move reaches a lost one, lost when every move reaches a won one (or
+// there are none) and drawn otherwise
+//
+static void checkersEndgame()
+{
+    const int kPieces = 3;
+    CheckersEndgame database;
+    if (!fileArgument || !database.open(fileArgument)) {
+        expect(false, "the database opens");
+        return;
+    }
+    if (database.maxPieces() < kPieces) {
+        expect(false, "the database holds 3 pieces");
+        return;
+    }
+
+    // from the point of view of the side to move in board
+    auto valueOf = [&database](const CheckersBoard &board) {
+        return board.pieces(board.sideToMove()) == 0 ? CheckersEndgame::kLoss : database.probe(board);
+    };
+    uint64_t positions = 0, badIndices = 0, badValues = 0;
+    for (int pieces = 2; pieces <= kPieces; pieces++) {
+        for (int redMen = 0; redMen <= pieces; redMen++) {
+            for (int redKings = 0; redMen + redKings <= pieces; redKings++) {
+                for (int yellowMen = 0; redMen + redKings + yellowMen <= pieces; yellowMen++) {
+                    CheckersEndgame::Slice slice{ (uint8_t)redMen, (uint8_t)redKings, (uint8_t)yellowMen, (uint8_t)(pieces - redMen - redKings - yellowMen) };
+                    if (redMen + redKings == 0 || slice.yellowMen + slice.yellowKings == 0) {
+                        continue;
+                    }
+                    for (uint64_t index = 0; index < CheckersEndgame::sliceSize(slice); index++) {
+                        CheckersBoard board;
+                        if (!CheckersEndgame::positionAt(slice, index, board)) {
+                            continue;
+                        }
+                        positions++;
+                        if (CheckersEndgame::indexOf(board) != index) {
+                            if (badIndices++ == 0) {
+                                std::fprintf(stderr, "position %s at index %llu indexes back to %llu\n", board.stateString().c_str(), (unsigned long long)index, (unsigned long long)CheckersEndgame::indexOf(board));
+                            }
+                            continue;
+                        }
+
+                        CheckersMoveList list;
+                        board.generateMoves(list);
+                        CheckersEndgame::Value expected = CheckersEndgame::kLoss;
+                        for (const CheckersMove &move : list) {
+                            CheckersBoard child = board;
+                            child.make(move);
+                            CheckersEndgame::Value value = valueOf(child);
+                            if (value == CheckersEndgame::kLoss) {
+                                expected = CheckersEndgame::kWin;
+                                break;
+                            }
+                            if (value != CheckersEndgame::kWin) {
+                                expected = CheckersEndgame::kDraw;
+                            }
+                        }
+                        CheckersEndgame::Value value = database.probe(board);
+                        if (value != expected && badValues++ == 0) {
+                            std::fprintf(stderr, "position %s probes as %d, its moves make it %d\n", board.stateString().c_str(), (int)value, (int)expected);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    expect(positions > 0, "the slices have positions");
+    expect(badIndices == 0, (std::to_string(badIndices) + " of " + std::to_string(positions) + " positions don't index back to where they were").c_str());
+    expect(badValues == 0, (std::to_string(badValues) + " of " + std::to_string(positions) + " positions disagree with their moves").c_str());
+}
+
+//
+// games written as training data read back as the same scored positions. the moves are stored
+// as indices into generateMoves' list, so this fails if its order changes without a new magic
+//
+static void trainingDataRoundTrip()
+{
+    struct GameText
+    {
+        const char *fen;
+        int result;
+        // UCI moves, each with its score or kNoScore
+        std::vector<std::pair<const char *, int>> plies;
+    };
+    const int none = ChessTrainingGame::kNoScore;
+    const GameText games[] = {
+        // a random opening, then both sides castle
+        { ChessBoard::kStartFEN, 1, { { "e2e4", none }, { "e7e5", none }, { "g1f3", 35 }, { "b8c6", -30 }, { "f1c4", 40 }, { "g8f6", -25 },
+                                      { "e1g1", 45 }, { "f8c5", -20 }, { "d2d3", 30 }, { "e8g8", -30 } } },
+        // promotions to a queen and a knight, a check that isn't scored and a mate score past
+        // what 16 bits keep
+        { "8/P5kp/8/8/8/8/1p4K1/8 w - - 0 1", 2, { { "a7a8q", 900 }, { "b2b1n", -850 }, { "a8a1", none }, { "g7g6", -1000 }, { "a1b1", 40000 } } },
+    };
+
+    std::string prefix = (std::filesystem::temp_directory_path() / "engine_checks_training").string();
+    std::vector<ChessTrainingPosition> expected;
+    ChessTrainingWriter writer(prefix, 100);
+    for (const GameText &text : games) {
+        ChessTrainingGame game;
+        game.start.setFEN(text.fen);
+        game.result = text.result;
+        ChessBoard board = game.start;
+        for (const auto &[uci, score] : text.plies) {
+            ChessMoveList list;
+            board.generateMoves(list);
+            const ChessMove *move = std::find_if(list.begin(), list.end(), [uci](const ChessMove &move) { return move.toString() == uci; });
+            if (move == list.end()) {
+                expect(false, (std::string("the test game's move ") + uci + " is legal").c_str());
+                return;
+            }
+            game.plies.push_back({ *move, score });
+            if (score != none) {
+                expected.push_back({ board, std::clamp(score, -ChessTrainingGame::kMaxScore, ChessTrainingGame::kMaxScore), text.result });
+            }
+            ChessBoard::Undo undo;
+            board.make(*move, undo);
+        }
+        expect(writer.write(game), "the game writes");
+    }
+    expect(writer.close(), "the file closes");
+
+    std::string file = ChessTrainingWriter::fileName(prefix, 0);
+    ChessTrainingReader reader;
+    expect(reader.open(file), "the file reads back");
+    ChessTrainingPosition position;
+    size_t count = 0;
+    while (reader.next(position)) {
+        if (count < expected.size()) {
+            const ChessTrainingPosition &want = expected[count];
+            std::string what = "position " + std::to_string(count) + " reads back as " + position.board.fen() + " " + std::to_string(position.score) + " " + std::to_string(position.result) +
+                               ", not " + want.board.fen() + " " + std::to_string(want.score) + " " + std::to_string(want.result);
+            expect(position.board.fen() == want.board.fen() && position.score == want.score && position.result == want.result, what.c_str());
+        }
+        count++;
+    }
+    expect(!reader.failed(), "the file reads to its end");
+    expect(count == expected.size(), (std::to_string(count) + " scored positions read back, " + std::to_string(expected.size()) + " written").c_str());
+    std::filesystem::remove(file);
+}
+
+int main(int argc, char **argv)
+{
+    const struct { const char *name; std::function<void()> run; } checks[] = {
+        { "checkers-king-cycle", checkersKingCycle },
+        { "search-matches-negamax", searchMatchesNegamax },
+        { "node-limits", nodeLimits },
+        { "checkers-endgame", checkersEndgame },
+        { "training-data-round-trip", trainingDataRoundTrip },
+    };
+    if (argc != 2 && argc != 3) {
+        std::fprintf(stderr, "usage: %s <check> [file], the check one of:", argv[0]);
+        for (const auto &check : checks) {
+            std::fprintf(stderr, " %s", check.name);
+        }
+        std::fprintf(stderr, "\n");
+        return 1;
+    }
+    fileArgument = argc > 2 ? argv[2] : nullptr;
+    for (const auto &check : checks) {
+        if (std::strcmp(argv[1], check.name) == 0) {
+            check.run();
+            return failures == 0 ? 0 : 1;
+        }
+    }
+    std::fprintf(stderr, "no check called %s\n", argv[1]);
+    return 1;
+}
@@ -0,0 +1,246 @@
+//
+// epd_runner: runs ChessAI over a test suite of EPD positions (WAC, ECM, STS and the like)
+// and reports how many it solves, how quickly, and at what speed
+//
+//   epd_runner <epd file> [--time ms, default 1000] [--nodes N] [--depth N] [--threads N]
+//
+// a position is solved when the move the search settles on is one of its "bm" moves and none
+// of its "am" moves, both in standard algebraic notation. its time to solution is when the
+// iteration that settled on a right answer for good finished. each worker thread has its own
+// engine, cleared between positions; with --nodes and no --time the results don't depend on
+// the machine or the thread count
+//
+#include "classes/ChessAI.h"
+#include "classes/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct EpdPosition
+{
+    std::string id;
+    std::string fen;
+    std::vector<std::string> bestMoves;
+    std::vector<std::string> avoidMoves;
+};
+
+struct Outcome
+{
+    bool readable = false;
+    bool solved = false;
+    std::string played;
+    int depth = 0;
+    uint64_t nodes = 0;
+    int elapsedMs = 0;
+    // when the right answer was found for good, -1 if it wasn't
+    int solvedMs = -1;
+    int solvedDepth = 0;
+};
+
+// "r1b.. w KQkq - bm Qg6 Rf1; id \"WAC.001\";"
+static bool parseEpd(const std::string &text, EpdPosition &position)
+{
+    std::istringstream fields(text);
+    std::string placement, side, castling, enPassant;
+    if (!(fields >> placement >> side >> castling >> enPassant)) {
+        return false;
+    }
+    position.fen = placement + " " + side + " " + castling + " " + enPassant;
+
+    std::string operations;
+    std::getline(fields, operations);
+    std::istringstream stream(operations);
+    std::string operation;
+    while (std::getline(stream, operation, ';')) {
+        std::istringstream words(operation);
+        std::string opcode, operand;
+        words >> opcode;
+        std::vector<std::string> operands;
+        while (words >> operand) {
+            operands.push_back(operand);
+        }
+        if (opcode == "bm") {
+            position.bestMoves = operands;
+        } else if (opcode == "am") {
+            position.avoidMoves = operands;
+        } else if (opcode == "id" && !operands.empty()) {
+            std::string id = operation.substr(operation.find("id") + 2);
+            id.erase(std::remove(id.begin(), id.end(), '"'), id.end());
+            id.erase(0, id.find_first_not_of(' '));
+            position.id = id;
+        }
+    }
+    return !position.bestMoves.empty() || !position.avoidMoves.empty();
+}
+
+// any of the moves, as SAN or long algebraic
+static bool matchesAny(const ChessBoard &board, const ChessMove &move, const std::vector<std::string> &moves)
+{
+    for (const std::string &text : moves) {
+        ChessMove listed;
+        if ((board.parseSAN(text, listed) || board.parseMove(text, listed)) && listed == move) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool isRight(const ChessBoard &board, const EpdPosition &position, const ChessMove &move)
+{
+    if (!position.bestMoves.empty() && !matchesAny(board, move, position.bestMoves)) {
+        return false;
+    }
+    return !matchesAny(board, move, position.avoidMoves);
+}
+
+static Outcome runPosition(const EpdPosition &position, const ChessAI::Limits &limits)
+{
+    thread_local ChessAI ai;
+    Outcome outcome;
+    ChessBoard board;
+    if (!board.setFEN(position.fen)) {
+        return outcome;
+    }
+    outcome.readable = true;
+    ai.clear();
+    auto start = std::chrono::steady_clock::now();
+    ChessAI::Result result = ai.search(board, limits);
+    outcome.elapsedMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    outcome.nodes = result.nodes;
+    outcome.depth = result.depth;
+    if (!result.hasMove) {
+        return outcome;
+    }
+    outcome.played = board.toSAN(result.bestMove);
+    outcome.solved = isRight(board, position, result.bestMove);
+
+    // back from the last iteration to the first of the run of right answers that ends it
+    for (auto iteration = result.iterations.rbegin(); outcome.solved && iteration != result.iterations.rend(); ++iteration) {
+        if (!isRight(board, position, iteration->bestMove)) {
+            break;
+        }
+        outcome.solvedMs = iteration->elapsedMs;
+        outcome.solvedDepth = iteration->depth;
+    }
+    return outcome;
+}
+
+// the value a fraction of the way through sorted values
+template <typename T>
+static T percentile(const std::vector<T> &sorted, double fraction)
+{
+    return sorted.empty() ? T() : sorted[std::min(sorted.size() - 1, (size_t)(fraction * sorted.size()))];
+}
+
+int main(int argc, char **argv)
+{
+    const char *file = nullptr;
+    ChessAI::Limits limits;
+    limits.timeLimitMs = 1000;
+    bool timeGiven = false;
+    size_t threads = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--time") == 0 && i + 1 < argc) {
+            limits.timeLimitMs = std::atoi(argv[++i]);
+            timeGiven = true;
+        } else if (std::strcmp(argv[i], "--nodes") == 0 && i + 1 < argc) {
+            limits.nodeLimit = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--depth") == 0 && i + 1 < argc) {
+            limits.maxDepth = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            file = argv[i];
+        }
+    }
+    if (!file) {
+        std::fprintf(stderr, "usage: %s <epd file> [--time ms, default 1000] [--nodes N] [--depth N] [--threads N]\n", argv[0]);
+        return 1;
+    }
+    // a node or depth limit on its own replaces the default time limit
+    if (!timeGiven && (limits.nodeLimit > 0 || limits.maxDepth != ChessAI::Limits().maxDepth)) {
+        limits.timeLimitMs = 0;
+    }
+
+    std::ifstream input(file);
+    if (!input) {
+        std::fprintf(stderr, "could not read %s\n", file);
+        return 1;
+    }
+    std::vector<EpdPosition> positions;
+    std::string text;
+    while (std::getline(input, text)) {
+        EpdPosition position;
+        if (text.empty() || text[0] == '#') {
+            continue;
+        }
+        if (!parseEpd(text, position)) {
+            std::fprintf(stderr, "skipping a line without bm or am: %s\n", text.c_str());
+            continue;
+        }
+        if (position.id.empty()) {
+            position.id = "#" + std::to_string(positions.size() + 1);
+        }
+        positions.push_back(position);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ThreadPool pool(threads);
+    std::vector<std::future<Outcome>> outcomes;
+    for (const EpdPosition &position : positions) {
+        outcomes.push_back(pool.submit([&position, limits]() { return runPosition(position, limits); }));
+    }
+
+    int solved = 0;
+    uint64_t nodes = 0;
+    std::vector<int> solveTimes;
+    std::vector<double> speeds;
+    for (size_t i = 0; i < positions.size(); i++) {
+        Outcome outcome = outcomes[i].get();
+        const EpdPosition &position = positions[i];
+        if (!outcome.readable) {
+            std::printf("%-12s FAIL unreadable position %s\n", position.id.c_str(), position.fen.c_str());
+            continue;
+        }
+        nodes += outcome.nodes;
+        double nps = outcome.nodes * 1000.0 / std::max(outcome.elapsedMs, 1);
+        speeds.push_back(nps);
+
+        std::string expected;
+        for (const std::string &move : position.bestMoves) {
+            expected += " bm " + move;
+        }
+        for (const std::string &move : position.avoidMoves) {
+            expected += " am " + move;
+        }
+        if (outcome.solved) {
+            solved++;
+            solveTimes.push_back(outcome.solvedMs);
+            std::printf("%-12s ok   %-7s at depth %2d, %6d ms (searched to depth %d, %.0f nps)\n", position.id.c_str(), outcome.played.c_str(), outcome.solvedDepth, outcome.solvedMs, outcome.depth, nps);
+        } else {
+            std::printf("%-12s FAIL %-7s%s (searched to depth %d, %.0f nps)\n", position.id.c_str(), outcome.played.c_str(), expected.c_str(), outcome.depth, nps);
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::sort(solveTimes.begin(), solveTimes.end());
+    std::sort(speeds.begin(), speeds.end());
+    std::printf("\nsolved %d / %zu on %zu threads, %llu nodes in %.2fs\n", solved, positions.size(), pool.size(), (unsigned long long)nodes, seconds);
+    if (!solveTimes.empty()) {
+        double total = 0;
+        for (int ms : solveTimes) {
+            total += ms;
+        }
+        std::printf("time to solution: mean %.0f ms, median %d ms, 90%% %d ms, max %d ms\n", total / solveTimes.size(), percentile(solveTimes, 0.5), percentile(solveTimes, 0.9), solveTimes.back());
+    }
+    if (!speeds.empty()) {
+        std::printf("nps per position: min %.0f, 10%% %.0f, median %.0f, 90%% %.0f, max %.0f\n", speeds.front(), percentile(speeds, 0.1), percentile(speeds, 0.5), percentile(speeds, 0.9), speeds.back());
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+//
+// match: plays two engine configurations against each other, many games at once, and reports
+// the result as an elo difference
+//
+//   match [--game chess|othello|connect4|checkers|tictactoe] [--a ENGINE] [--b ENGINE]
+//         [--games N, default 100] [--random-plies N, default 4] [--seed N] [--max-plies N]
+//         [--threads N] [--log FILE]
+//
+// an engine is "name:setting=value,..." with settings depth, time (ms per move), nodes (chess
+// only) and, for chess, any ChessSearchParams option: --a new:depth=6,lmrBase=90. games come in
+// pairs that share a random opening, one with each engine moving first. --log writes every game
+// as PGN style text, in order
+//
+#include "classes/Match.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+int main(int argc, char **argv)
+{
+    MatchSettings settings;
+    std::string logFile;
+    std::string error;
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) {
+            std::fprintf(stderr, "%s needs a value\n", argv[i]);
+            return 1;
+        }
+        if (std::strcmp(argv[i], "--log") == 0) {
+            logFile = value;
+        } else if (!settings.parseArgument(argv[i], value, error)) {
+            std::fprintf(stderr, "%s\n", error.empty() ? ("unknown argument " + std::string(argv[i])).c_str() : error.c_str());
+            return 1;
+        }
+        i++;
+    }
+
+    settings.nameEngines();
+    Match match(settings);
+    if (!match.validate(error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    std::ofstream log;
+    if (!logFile.empty()) {
+        log.open(logFile);
+        if (!log) {
+            std::fprintf(stderr, "could not write %s\n", logFile.c_str());
+            return 1;
+        }
+    }
+
+    MatchScore score;
+    // the first engine's results with each colour
+    MatchScore asFirst, asSecond;
+    match.run([&](const GameRecord &game) {
+        score.add(game.score);
+        (game.firstEngineFirst ? asFirst : asSecond).add(game.score);
+        if (log.is_open()) {
+            log << game.log;
+        }
+        std::fprintf(stderr, "\rgame %d / %d: +%d =%d -%d, elo %+.1f +- %.1f   ", score.games(), settings.games, score.wins, score.draws, score.losses, score.elo(), score.eloError());
+        return true;
+    });
+    std::fprintf(stderr, "\n");
+
+    std::printf("%s, %d games\n", settings.game.c_str(), score.games());
+    std::printf("%s vs %s: wins %d, draws %d, losses %d (moving first +%d =%d -%d, second +%d =%d -%d)\n", settings.engines[0].name.c_str(), settings.engines[1].name.c_str(), score.wins, score.draws, score.losses, asFirst.wins, asFirst.draws, asFirst.losses, asSecond.wins, asSecond.draws, asSecond.losses);
+    std::printf("score %.1f%%, elo %+.1f +- %.1f (95%%)\n", 100 * score.score(), score.elo(), score.eloError());
+    return 0;
+}
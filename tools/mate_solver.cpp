@@ -0,0 +1,129 @@
+//
+// mate_solver: solves a batch of mate puzzles with ChessMateSolver and checks them against
+// the mate length each one claims
+//
+//   mate_solver [--hash MB, default 64] <epd file> [max moves, default 5]
+//               [node limit per puzzle, default 0 for none]
+//
+// one puzzle per line, a FEN or an EPD record. an EPD "dm N" operation is the expected mate
+// in N, the puzzle fails if a shorter one or none is found. puzzles are solved across all
+// cores with one solver (and node table of --hash megabytes) per worker thread, proofs
+// carrying over from one puzzle to the next. a puzzle that runs out of nodes is counted apart
+// from one shown to have no mate
+//
+#include "classes/ChessMateSolver.h"
+#include "classes/ThreadPool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Puzzle
+{
+    std::string fen;
+    // 0 when the record doesn't say
+    int expected = 0;
+};
+
+static bool parsePuzzle(const std::string &text, Puzzle &puzzle)
+{
+    std::istringstream stream(text);
+    std::string fields[4];
+    for (std::string &field : fields) {
+        if (!(stream >> field)) {
+            return false;
+        }
+    }
+    puzzle.fen = fields[0] + " " + fields[1] + " " + fields[2] + " " + fields[3];
+    std::size_t mate = text.find(" dm ");
+    puzzle.expected = mate == std::string::npos ? 0 : std::atoi(text.c_str() + mate + 4);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    size_t hashMegabytes = 64;
+    std::vector<const char *> arguments;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--hash") == 0 && i + 1 < argc) {
+            hashMegabytes = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            arguments.push_back(argv[i]);
+        }
+    }
+    if (arguments.empty()) {
+        std::fprintf(stderr, "usage: %s [--hash MB, default 64] <epd file> [max moves, default 5] [node limit per puzzle, default 0 for none]\n", argv[0]);
+        return 1;
+    }
+    std::ifstream input(arguments[0]);
+    if (!input) {
+        std::fprintf(stderr, "could not read %s\n", arguments[0]);
+        return 1;
+    }
+    int maxMoves = arguments.size() > 1 ? std::atoi(arguments[1]) : 5;
+    uint64_t nodeLimit = arguments.size() > 2 ? std::strtoull(arguments[2], nullptr, 10) : 0;
+    if (maxMoves < 1) {
+        std::fprintf(stderr, "max moves must be at least 1\n");
+        return 1;
+    }
+    size_t tableEntries = hashMegabytes * 1024 * 1024 / (2 * sizeof(uint64_t));
+
+    std::vector<Puzzle> puzzles;
+    std::string text;
+    while (std::getline(input, text)) {
+        Puzzle puzzle;
+        if (text.empty() || text[0] == '#') {
+            continue;
+        }
+        if (!parsePuzzle(text, puzzle)) {
+            std::fprintf(stderr, "skipping unreadable line: %s\n", text.c_str());
+            continue;
+        }
+        puzzles.push_back(puzzle);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ThreadPool pool;
+    std::vector<std::future<ChessMateSolver::Result>> results;
+    for (const Puzzle &puzzle : puzzles) {
+        results.push_back(pool.submit([&puzzle, maxMoves, nodeLimit, tableEntries]() {
+            thread_local ChessMateSolver solver(tableEntries);
+            ChessBoard board;
+            if (!board.setFEN(puzzle.fen)) {
+                return ChessMateSolver::Result();
+            }
+            return solver.solve(board, puzzle.expected > 0 ? puzzle.expected : maxMoves, nodeLimit);
+        }));
+    }
+
+    int solved = 0, abandoned = 0;
+    uint64_t nodes = 0;
+    for (size_t i = 0; i < puzzles.size(); i++) {
+        ChessMateSolver::Result result = results[i].get();
+        nodes += result.nodes;
+        bool correct = result.found && (puzzles[i].expected == 0 || result.moves == puzzles[i].expected);
+        solved += correct;
+
+        std::string line;
+        for (const ChessMove &move : result.line) {
+            line += ' ';
+            line += move.toString();
+        }
+        if (result.found) {
+            std::printf("%zu: %s mate in %d:%s (%llu nodes)\n", i + 1, correct ? "ok  " : "FAIL", result.moves, line.c_str(), (unsigned long long)result.nodes);
+        } else if (result.aborted) {
+            abandoned++;
+            std::printf("%zu: FAIL gave up at the node limit (%llu nodes) %s\n", i + 1, (unsigned long long)result.nodes, puzzles[i].fen.c_str());
+        } else {
+            std::printf("%zu: FAIL no mate found (%llu nodes) %s\n", i + 1, (unsigned long long)result.nodes, puzzles[i].fen.c_str());
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("solved %d / %zu, %d gave up at the node limit, %llu nodes in %.2fs\n", solved, puzzles.size(), abandoned, (unsigned long long)nodes, seconds);
+    return solved == (int)puzzles.size() ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+//
+// perft: counts the leaves of ChessBoard's legal move tree, across all cores
+//
+//   perft [--divide] [--hash MB] [--threads N] <depth> [FEN, default the start position]
+//   perft [--hash MB] [--threads N] --suite <depth>
+//
+// --divide prints the count under each root move, --hash shares a cache of that many
+// megabytes between the threads, and --suite checks the standard perft positions against
+// their published counts up to depth, failing on any difference
+//
+#include "classes/ChessPerft.h"
+#include "classes/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// deepest published count any suite position has
+static const int kMaxSuiteDepth = 9;
+
+struct SuitePosition
+{
+    const char *fen;
+    // counts from depth 1, 0 past what's known
+    uint64_t counts[kMaxSuiteDepth];
+};
+
+static const SuitePosition kSuite[] = {
+    { ChessBoard::kStartFEN, { 20, 400, 8902, 197281, 4865609, 119060324, 3195901860, 84998978956, 2439530234167 } },
+    { "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", { 48, 2039, 97862, 4085603, 193690690, 8031647685 } },
+    { "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", { 14, 191, 2812, 43238, 674624, 11030083, 178633661, 3009794393 } },
+    { "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", { 6, 264, 9467, 422333, 15833292, 706045033 } },
+    { "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", { 44, 1486, 62379, 2103487, 89941194 } },
+    { "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", { 46, 2079, 89890, 3894594, 164075551, 6923051137, 287188994746, 11923589843526, 490154852788714 } },
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static int runSuite(ChessPerft &perft, ThreadPool &pool, int maxDepth)
+{
+    int failures = 0;
+    for (const SuitePosition &position : kSuite) {
+        ChessBoard board;
+        board.setFEN(position.fen);
+        for (int depth = 1; depth <= maxDepth && depth <= kMaxSuiteDepth && position.counts[depth - 1] != 0; depth++) {
+            auto start = std::chrono::steady_clock::now();
+            uint64_t nodes = perft.count(board, depth, pool);
+            bool correct = nodes == position.counts[depth - 1];
+            failures += !correct;
+            std::printf("%s depth %d: %llu%s (%.2fs) %s\n", correct ? "ok  " : "FAIL", depth, (unsigned long long)nodes, correct ? "" : (" expected " + std::to_string(position.counts[depth - 1])).c_str(), secondsSince(start), position.fen);
+        }
+    }
+    std::printf("%d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
+
+static int usage(const char *program)
+{
+    std::fprintf(stderr, "usage: %s [--divide] [--hash MB] [--threads N] <depth> [FEN]\n", program);
+    std::fprintf(stderr, "       %s [--hash MB] [--threads N] --suite <depth>\n", program);
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    bool divide = false, suite = false;
+    size_t hashMegabytes = 0, threads = 0;
+    int depth = -1;
+    std::string fen = ChessBoard::kStartFEN;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--divide") == 0) {
+            divide = true;
+        } else if (std::strcmp(argv[i], "--suite") == 0) {
+            suite = true;
+        } else if (std::strcmp(argv[i], "--hash") == 0 && i + 1 < argc) {
+            hashMegabytes = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::strtoull(argv[++i], nullptr, 10);
+        } else if (depth < 0) {
+            // the depth is the whole argument or it's a mistake, so --help doesn't count depth 0
+            char *end = nullptr;
+            long value = std::strtol(argv[i], &end, 10);
+            if (end == argv[i] || *end != '\0' || value < 0 || value > 64) {
+                return usage(argv[0]);
+            }
+            depth = (int)value;
+        } else {
+            fen = argv[i];
+        }
+    }
+    if (depth < 0) {
+        return usage(argv[0]);
+    }
+
+    ChessPerft perft(hashMegabytes * 1024 * 1024 / (2 * sizeof(uint64_t)));
+    ThreadPool pool(threads);
+    if (suite) {
+        return runSuite(perft, pool, depth);
+    }
+
+    ChessBoard board;
+    if (!board.setFEN(fen)) {
+        std::fprintf(stderr, "could not read the FEN %s\n", fen.c_str());
+        return 1;
+    }
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = 0;
+    if (divide && depth > 0) {
+        for (const ChessPerft::Division &division : perft.divide(board, depth, pool)) {
+            std::printf("%s: %llu\n", division.move.toString().c_str(), (unsigned long long)division.nodes);
+            nodes += division.nodes;
+        }
+    } else {
+        nodes = perft.count(board, depth, pool);
+    }
+    double seconds = secondsSince(start);
+    std::printf("perft %d: %llu nodes in %.2fs, %.0f nps on %zu threads\n", depth, (unsigned long long)nodes, seconds, nodes / std::max(seconds, 1e-9), pool.size());
+    return 0;
+}
@@ -0,0 +1,169 @@
+//
+// selfplay: plays ChessAI against itself at a fixed node count a move, a game per job across
+// every core, and writes the games as training data, each position with the search's score and
+// the game's result
+//
+//   selfplay <output prefix> [--games N, default 1000] [--nodes N, default 5000]
+//            [--random-plies N, default 8] [--max-plies N, default 400]
+//            [--per-file N, default 10000] [--seed N] [--threads N]
+//   selfplay --dump <file>
+//
+// games go to prefix_0000.bin, prefix_0001.bin and so on, in ChessTrainingData's format. each
+// game opens with random moves, which aren't scored, and the engine is cleared before each one,
+// so a seed gives the same games whatever the thread count. positions in check aren't scored
+// either. --dump prints a file's scored positions back as "FEN score result" lines
+//
+#include "classes/ChessAI.h"
+#include "classes/ChessTrainingData.h"
+#include "classes/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Settings
+{
+    int games = 1000;
+    uint64_t nodes = 5000;
+    int randomPlies = 8;
+    int maxPlies = 400;
+    uint64_t seed = 1;
+};
+
+static ChessTrainingGame playGame(const Settings &settings, int index)
+{
+    thread_local ChessAI ai;
+    ai.clear();
+    std::mt19937_64 random(settings.seed * 0x9e3779b97f4a7c15ull + (uint64_t)index);
+    ChessTrainingGame game;
+    game.start = ChessBoard::startPosition();
+    ChessBoard board = game.start;
+    // positions since the last capture or pawn move, for threefold repetition
+    std::vector<uint64_t> positions = { board.hash() };
+
+    ChessAI::Limits limits;
+    limits.timeLimitMs = 0;
+    limits.nodeLimit = settings.nodes;
+    for (int ply = 0; ply < settings.maxPlies; ply++) {
+        ChessMoveList list;
+        board.generateMoves(list);
+        if (list.count == 0) {
+            if (board.inCheck()) {
+                game.result = board.sideToMove() == ChessBoard::kWhite ? 0 : 2;
+            }
+            break;
+        }
+        if (board.halfmoveClock() >= 100 || board.insufficientMaterial() || std::count(positions.begin(), positions.end(), board.hash()) >= 3) {
+            break;
+        }
+
+        ChessTrainingGame::Ply played;
+        if (ply < settings.randomPlies) {
+            played.move = list.moves[std::uniform_int_distribution<int>(0, list.count - 1)(random)];
+        } else {
+            limits.history.assign(positions.begin(), positions.end() - 1);
+            ChessAI::Result result = ai.search(board, limits);
+            played.move = result.bestMove;
+            if (!board.inCheck()) {
+                played.score = result.score;
+            }
+        }
+        game.plies.push_back(played);
+        ChessBoard::Undo undo;
+        board.make(played.move, undo);
+        if (board.halfmoveClock() == 0) {
+            positions.clear();
+        }
+        positions.push_back(board.hash());
+    }
+    return game;
+}
+
+static int dump(const char *file)
+{
+    ChessTrainingReader reader;
+    if (!reader.open(file)) {
+        std::fprintf(stderr, "could not read %s\n", file);
+        return 1;
+    }
+    const char *results[] = { "0-1", "1/2-1/2", "1-0" };
+    ChessTrainingPosition position;
+    while (reader.next(position)) {
+        std::printf("%s %d %s\n", position.board.fen().c_str(), position.score, results[position.result]);
+    }
+    if (reader.failed()) {
+        std::fprintf(stderr, "%s ends in a damaged game\n", file);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *prefix = nullptr;
+    Settings settings;
+    int perFile = 10000;
+    size_t threads = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+            return dump(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            settings.games = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--nodes") == 0 && i + 1 < argc) {
+            settings.nodes = std::max<uint64_t>(std::strtoull(argv[++i], nullptr, 10), 1);
+        } else if (std::strcmp(argv[i], "--random-plies") == 0 && i + 1 < argc) {
+            settings.randomPlies = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-plies") == 0 && i + 1 < argc) {
+            settings.maxPlies = std::clamp(std::atoi(argv[++i]), 1, 0xffff);
+        } else if (std::strcmp(argv[i], "--per-file") == 0 && i + 1 < argc) {
+            perFile = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            settings.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            prefix = argv[i];
+        }
+    }
+    if (!prefix) {
+        std::fprintf(stderr, "usage: %s <output prefix> [--games N, default 1000] [--nodes N, default 5000] [--random-plies N, default 8] [--max-plies N, default 400] [--per-file N, default 10000] [--seed N] [--threads N]\n", argv[0]);
+        std::fprintf(stderr, "       %s --dump <file>\n", argv[0]);
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ThreadPool pool(threads);
+    std::vector<std::future<ChessTrainingGame>> games;
+    for (int index = 0; index < settings.games; index++) {
+        games.push_back(pool.submit([&settings, index]() { return playGame(settings, index); }));
+    }
+
+    ChessTrainingWriter writer(prefix, perFile);
+    uint64_t positions = 0;
+    int results[3] = { 0, 0, 0 };
+    for (int index = 0; index < settings.games; index++) {
+        ChessTrainingGame game = games[index].get();
+        if (!writer.write(game)) {
+            std::fprintf(stderr, "\ncould not write %s\n", ChessTrainingWriter::fileName(prefix, writer.files() - 1).c_str());
+            return 1;
+        }
+        positions += std::count_if(game.plies.begin(), game.plies.end(), [](const ChessTrainingGame::Ply &ply) { return ply.score != ChessTrainingGame::kNoScore; });
+        results[game.result]++;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::fprintf(stderr, "\rgame %d / %d: %llu positions, %.0f positions/s   ", index + 1, settings.games, (unsigned long long)positions, positions / std::max(seconds, 1e-3));
+    }
+    if (!writer.close()) {
+        std::fprintf(stderr, "\ncould not finish writing %s\n", ChessTrainingWriter::fileName(prefix, writer.files() - 1).c_str());
+        return 1;
+    }
+    std::fprintf(stderr, "\n");
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%d games on %zu threads in %.1fs: white won %d, drew %d, lost %d\n", settings.games, pool.size(), seconds, results[2], results[1], results[0]);
+    std::printf("%llu positions in %d files, %llu bytes, %.2f bytes a position\n", (unsigned long long)positions, writer.files(), (unsigned long long)writer.bytes(), positions ? (double)writer.bytes() / positions : 0.0);
+    return 0;
+}
@@ -0,0 +1,88 @@
+//
+// sprt: plays a new engine configuration against a base one until a sequential probability
+// ratio test decides whether it's elo1 stronger (accept H1) or no more than elo0 (accept H0)
+//
+//   sprt --a NEW --b BASE [--elo0 E, default 0] [--elo1 E, default 5] [--alpha A, default 0.05]
+//        [--beta B, default 0.05] [--game G] [--games max, default 20000] [--random-plies N]
+//        [--seed N] [--max-plies N] [--threads N]
+//
+// engines are given as for match. games are played in pairs on a shared opening, one with
+// each engine moving first, and the test is run on the pentanomial pair results. it stops as
+// soon as the log likelihood ratio crosses a bound, or inconclusive after the maximum games
+//
+#include "classes/Match.h"
+#include "classes/Sprt.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char **argv)
+{
+    MatchSettings settings;
+    settings.games = 20000;
+    double elo0 = 0, elo1 = 5, alpha = 0.05, beta = 0.05;
+    std::string error;
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) {
+            std::fprintf(stderr, "%s needs a value\n", argv[i]);
+            return 1;
+        }
+        if (std::strcmp(argv[i], "--elo0") == 0) {
+            elo0 = std::atof(value);
+        } else if (std::strcmp(argv[i], "--elo1") == 0) {
+            elo1 = std::atof(value);
+        } else if (std::strcmp(argv[i], "--alpha") == 0) {
+            alpha = std::atof(value);
+        } else if (std::strcmp(argv[i], "--beta") == 0) {
+            beta = std::atof(value);
+        } else if (!settings.parseArgument(argv[i], value, error)) {
+            std::fprintf(stderr, "%s\n", error.empty() ? ("unknown argument " + std::string(argv[i])).c_str() : error.c_str());
+            return 1;
+        }
+        i++;
+    }
+    if (elo1 <= elo0 || alpha <= 0 || alpha >= 1 || beta <= 0 || beta >= 1) {
+        std::fprintf(stderr, "need elo0 < elo1 and alpha, beta between 0 and 1\n");
+        return 1;
+    }
+    // only whole pairs count
+    settings.games -= settings.games % 2;
+
+    settings.nameEngines();
+    Match match(settings);
+    if (!match.validate(error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    Sprt sprt(elo0, elo1, alpha, beta);
+    MatchScore score;
+    int pendingScore = 0;
+    match.run([&](const GameRecord &game) {
+        score.add(game.score);
+        if (game.index % 2 == 0) {
+            pendingScore = game.score;
+            return true;
+        }
+        sprt.addPair(pendingScore, game.score);
+        const int64_t *counts = sprt.pentanomial();
+        std::fprintf(stderr, "\rgames %d: +%d =%d -%d, pentanomial [%lld %lld %lld %lld %lld], LLR %.2f (%.2f, %.2f)   ", score.games(), score.wins, score.draws, score.losses,
+                     (long long)counts[0], (long long)counts[1], (long long)counts[2], (long long)counts[3], (long long)counts[4], sprt.llr(), sprt.lowerBound(), sprt.upperBound());
+        return sprt.status() == Sprt::kContinue;
+    });
+    std::fprintf(stderr, "\n");
+
+    const int64_t *counts = sprt.pentanomial();
+    std::printf("%s vs %s, %s, elo0 %g elo1 %g alpha %g beta %g\n", settings.engines[0].name.c_str(), settings.engines[1].name.c_str(), settings.game.c_str(), elo0, elo1, alpha, beta);
+    std::printf("games %d: wins %d, draws %d, losses %d\n", score.games(), score.wins, score.draws, score.losses);
+    std::printf("pentanomial [%lld %lld %lld %lld %lld]\n", (long long)counts[0], (long long)counts[1], (long long)counts[2], (long long)counts[3], (long long)counts[4]);
+    std::printf("elo %+.1f +- %.1f (95%%, from pairs)\n", sprt.elo(), sprt.eloError());
+    std::printf("LLR %.2f (%.2f, %.2f): ", sprt.llr(), sprt.lowerBound(), sprt.upperBound());
+    switch (sprt.status()) {
+        case Sprt::kAcceptH1: std::printf("H1 accepted\n"); break;
+        case Sprt::kAcceptH0: std::printf("H0 accepted\n"); break;
+        default: std::printf("inconclusive\n"); break;
+    }
+    return 0;
+}
@@ -0,0 +1,373 @@
+//
+// texel_tuner: fits ChessAI's evaluation weights to game results, texel style, by gradient
+// descent on the error between each position's result and a sigmoid of its evaluation
+//
+//   texel_tuner <positions file> [--epochs N, default 300] [--rate R, default 1]
+//               [--batch N, default 16384] [--k K] [--threads N] [--output FILE]
+//
+// a line holds a FEN and its game's result from white's side, as 1-0, 0-1 or 1/2-1/2, [1.0],
+// [0.5] or [0.0], or a bare 1, 0.5 or 0 at the end. a .bin file from selfplay is read as its
+// scored positions and their games' results instead. quiet positions work best, since the
+// evaluation is taken as it stands. each position is evaluated once with the engine's own
+// evaluation, traced into the weights it used and how many times, and the evaluation is
+// linear in the weights, so every epoch is a sparse dot product a position, in batches across
+// the thread pool, each handing back its share of the error's gradient. K, the sigmoid's
+// scale, is fitted to the starting weights unless given. the tuned weights are printed as
+// ChessAI.cpp's tables
+//
+#include "classes/ChessAI.h"
+#include "classes/ChessTrainingData.h"
+#include "classes/ThreadPool.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct Positions
+{
+    std::vector<PackedChessBoard> boards;
+    // white's score: 0 for a loss, 1 for a draw, 2 for a win
+    std::vector<uint8_t> results;
+};
+
+// every position's trace end to end, 6 bytes a term: position i's terms run from starts[i] to
+// starts[i + 1]
+struct Traces
+{
+    std::vector<ChessEvalTrace::Term> terms;
+    std::vector<size_t> starts;
+    std::vector<uint8_t> phases;
+};
+
+// what one batch of positions adds to an epoch
+struct Partial
+{
+    double error = 0;
+    std::vector<double> gradient;
+};
+
+static const size_t kNoResult = std::string::npos;
+
+// where the result starts in the line, kNoResult if it hasn't one, with the score in halves
+static size_t parseResult(const std::string &text, int &result)
+{
+    const struct { const char *text; int result; } marks[] = {
+        { "1/2-1/2", 1 }, { "1-0", 2 }, { "0-1", 0 }, { "[1.0]", 2 }, { "[0.5]", 1 }, { "[0.0]", 0 }, { "[1]", 2 }, { "[0]", 0 },
+    };
+    for (const auto &mark : marks) {
+        size_t at = text.find(mark.text);
+        if (at != std::string::npos) {
+            result = mark.result;
+            return at;
+        }
+    }
+    size_t end = text.find_last_not_of(" \t\r;\"");
+    if (end == std::string::npos) {
+        return kNoResult;
+    }
+    size_t start = text.find_last_of(" \t", end);
+    if (start == std::string::npos) {
+        return kNoResult;
+    }
+    std::string last = text.substr(start + 1, end - start);
+    if (last == "1" || last == "1.0") {
+        result = 2;
+    } else if (last == "0.5") {
+        result = 1;
+    } else if (last == "0" || last == "0.0") {
+        result = 0;
+    } else {
+        return kNoResult;
+    }
+    return start;
+}
+
+static void add(Positions &positions, const ChessBoard &board, int result)
+{
+    positions.boards.push_back(board.pack());
+    positions.results.push_back((uint8_t)result);
+    if (positions.boards.size() % 100000 == 0) {
+        std::fprintf(stderr, "\rloaded %zu positions", positions.boards.size());
+    }
+}
+
+static bool loadTrainingData(const char *file, Positions &positions)
+{
+    ChessTrainingReader reader;
+    if (!reader.open(file)) {
+        return false;
+    }
+    ChessTrainingPosition position;
+    while (reader.next(position)) {
+        add(positions, position.board, position.result);
+    }
+    std::fprintf(stderr, "\rloaded %zu positions%s\n", positions.boards.size(), reader.failed() ? ", stopped at a damaged game" : "");
+    return true;
+}
+
+static bool load(const char *file, Positions &positions)
+{
+    std::string name = file;
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, ".bin") == 0) {
+        return loadTrainingData(file, positions);
+    }
+    std::ifstream input(file);
+    if (!input) {
+        return false;
+    }
+    std::string text;
+    size_t skipped = 0;
+    ChessBoard board;
+    while (std::getline(input, text)) {
+        int result = 0;
+        size_t at = parseResult(text, result);
+        if (at == kNoResult || !board.setFEN(text.substr(0, at))) {
+            skipped += !text.empty();
+            continue;
+        }
+        add(positions, board, result);
+    }
+    std::fprintf(stderr, "\rloaded %zu positions, skipped %zu lines\n", positions.boards.size(), skipped);
+    return true;
+}
+
+static double sigmoid(double k, double score)
+{
+    return 1 / (1 + std::pow(10.0, -k * score / 400));
+}
+
+//
+// runs batch(first, last) over the positions on the pool and sums what comes back
+//
+template <typename Func>
+static Partial reduce(ThreadPool &pool, size_t count, size_t batchSize, size_t weights, Func batch)
+{
+    std::vector<std::future<Partial>> batches;
+    for (size_t first = 0; first < count; first += batchSize) {
+        size_t last = std::min(first + batchSize, count);
+        batches.push_back(pool.submit([&batch, first, last]() { return batch(first, last); }));
+    }
+    Partial total;
+    total.gradient.assign(weights, 0);
+    for (auto &future : batches) {
+        Partial partial = future.get();
+        total.error += partial.error;
+        for (size_t i = 0; i < partial.gradient.size(); i++) {
+            total.gradient[i] += partial.gradient[i];
+        }
+    }
+    return total;
+}
+
+int main(int argc, char **argv)
+{
+    const char *file = nullptr;
+    const char *outputFile = nullptr;
+    int epochs = 300;
+    double rate = 1;
+    size_t batchSize = 16384;
+    double k = 0;
+    size_t threads = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--epochs") == 0 && i + 1 < argc) {
+            epochs = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            rate = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batchSize = std::max<size_t>(std::strtoull(argv[++i], nullptr, 10), 1);
+        } else if (std::strcmp(argv[i], "--k") == 0 && i + 1 < argc) {
+            k = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else {
+            file = argv[i];
+        }
+    }
+    if (!file) {
+        std::fprintf(stderr, "usage: %s <positions file> [--epochs N, default 300] [--rate R, default 1] [--batch N, default 16384] [--k K] [--threads N] [--output FILE]\n", argv[0]);
+        return 1;
+    }
+
+    Positions positions;
+    if (!load(file, positions)) {
+        std::fprintf(stderr, "could not read %s\n", file);
+        return 1;
+    }
+    const size_t count = positions.boards.size();
+    if (count == 0) {
+        std::fprintf(stderr, "no positions to tune on\n");
+        return 1;
+    }
+
+    ThreadPool pool(threads);
+    ChessEvalParams params;
+    const size_t weightCount = params.weights().size();
+    std::vector<double> weights(params.weights().begin(), params.weights().end());
+
+    // the engine's evaluations from white's side, for fitting K, their traces, and how far the
+    // traced model strays from them: no further than the engine's rounding unless a weight is
+    // missing
+    std::vector<int> evaluations(count);
+    Traces traces;
+    traces.phases.resize(count);
+    std::vector<size_t> termCounts(count);
+    std::vector<std::vector<ChessEvalTrace::Term>> batchTerms((count + batchSize - 1) / batchSize);
+    size_t mismatches = reduce(pool, count, batchSize, 0, [&](size_t first, size_t last) {
+        ChessBoard board;
+        ChessEvalTrace trace;
+        Partial partial;
+        std::vector<ChessEvalTrace::Term> &terms = batchTerms[first / batchSize];
+        for (size_t i = first; i < last; i++) {
+            board.unpack(positions.boards[i]);
+            int score = ChessAI::evaluate(board, params, &trace);
+            evaluations[i] = board.sideToMove() == ChessBoard::kWhite ? score : -score;
+            terms.insert(terms.end(), trace.terms.begin(), trace.terms.end());
+            termCounts[i] = trace.terms.size();
+            traces.phases[i] = (uint8_t)trace.phase;
+            double middlegame = 0, endgame = 0;
+            for (const ChessEvalTrace::Term &term : trace.terms) {
+                middlegame += weights[term.weight] * term.middlegame;
+                endgame += weights[term.weight] * term.endgame;
+            }
+            double model = (middlegame * trace.phase + endgame * (ChessAI::kTotalPhase - trace.phase)) / ChessAI::kTotalPhase;
+            partial.error += std::abs(model - evaluations[i]) > 1;
+        }
+        return partial;
+    }).error;
+    if (mismatches > 0) {
+        std::fprintf(stderr, "warning: the traced evaluation differs from the engine's in %zu positions\n", mismatches);
+    }
+
+    // the batches' terms end to end, for the epochs to walk
+    traces.starts.resize(count + 1);
+    traces.starts[0] = 0;
+    for (size_t i = 0; i < count; i++) {
+        traces.starts[i + 1] = traces.starts[i] + termCounts[i];
+    }
+    traces.terms.reserve(traces.starts[count]);
+    for (std::vector<ChessEvalTrace::Term> &terms : batchTerms) {
+        traces.terms.insert(traces.terms.end(), terms.begin(), terms.end());
+        std::vector<ChessEvalTrace::Term>().swap(terms);
+    }
+
+    // mean squared error of the results against the evaluations through a sigmoid of scale k
+    auto staticError = [&](double scale) {
+        return reduce(pool, count, batchSize, 0, [&](size_t first, size_t last) {
+            Partial partial;
+            for (size_t i = first; i < last; i++) {
+                double difference = positions.results[i] / 2.0 - sigmoid(scale, evaluations[i]);
+                partial.error += difference * difference;
+            }
+            return partial;
+        }).error / count;
+    };
+    if (k <= 0) {
+        // the error is smooth in K with one minimum, so a golden section search finds it
+        double low = 0.05, high = 5;
+        const double ratio = (std::sqrt(5.0) - 1) / 2;
+        while (high - low > 1e-4) {
+            double a = high - ratio * (high - low), b = low + ratio * (high - low);
+            if (staticError(a) < staticError(b)) {
+                high = b;
+            } else {
+                low = a;
+            }
+        }
+        k = (low + high) / 2;
+    }
+    std::fprintf(stderr, "K %.4f, starting error %.6f, %zu weights on %zu threads\n", k, staticError(k), weightCount, pool.size());
+
+    // full batch adam
+    const double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+    std::vector<double> moment(weightCount, 0), velocity(weightCount, 0);
+    auto start = std::chrono::steady_clock::now();
+    for (int epoch = 1; epoch <= epochs; epoch++) {
+        Partial total = reduce(pool, count, batchSize, weightCount, [&](size_t first, size_t last) {
+            Partial partial;
+            partial.gradient.assign(weightCount, 0);
+            for (size_t i = first; i < last; i++) {
+                const ChessEvalTrace::Term *begin = traces.terms.data() + traces.starts[i];
+                const ChessEvalTrace::Term *end = traces.terms.data() + traces.starts[i + 1];
+                double middlegame = 0, endgame = 0;
+                for (const ChessEvalTrace::Term *term = begin; term != end; term++) {
+                    middlegame += weights[term->weight] * term->middlegame;
+                    endgame += weights[term->weight] * term->endgame;
+                }
+                double phase = traces.phases[i] / (double)ChessAI::kTotalPhase;
+                double predicted = sigmoid(k, middlegame * phase + endgame * (1 - phase));
+                double difference = positions.results[i] / 2.0 - predicted;
+                partial.error += difference * difference;
+                // d(difference^2)/d(score), then through the blend to each weight
+                double slope = -2 * difference * predicted * (1 - predicted) * k * std::log(10.0) / 400;
+                for (const ChessEvalTrace::Term *term = begin; term != end; term++) {
+                    partial.gradient[term->weight] += slope * (term->middlegame * phase + term->endgame * (1 - phase));
+                }
+            }
+            return partial;
+        });
+
+        for (size_t i = 0; i < weightCount; i++) {
+            double gradient = total.gradient[i] / count;
+            moment[i] = beta1 * moment[i] + (1 - beta1) * gradient;
+            velocity[i] = beta2 * velocity[i] + (1 - beta2) * gradient * gradient;
+            double correctedMoment = moment[i] / (1 - std::pow(beta1, epoch));
+            double correctedVelocity = velocity[i] / (1 - std::pow(beta2, epoch));
+            weights[i] -= rate * correctedMoment / (std::sqrt(correctedVelocity) + epsilon);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::fprintf(stderr, "\repoch %d / %d: error %.6f, %.0f positions/s   ", epoch, epochs, total.error / count, (double)count * epoch / std::max(seconds, 1e-3));
+    }
+    std::fprintf(stderr, "\n");
+
+    // the evaluation only takes whole numbers
+    for (size_t i = 0; i < weightCount; i++) {
+        params.weights()[i] = (int)std::lround(weights[i]);
+    }
+    reduce(pool, count, batchSize, 0, [&](size_t first, size_t last) {
+        ChessBoard board;
+        for (size_t i = first; i < last; i++) {
+            board.unpack(positions.boards[i]);
+            int score = ChessAI::evaluate(board, params);
+            evaluations[i] = board.sideToMove() == ChessBoard::kWhite ? score : -score;
+        }
+        return Partial();
+    });
+    std::fprintf(stderr, "tuned error %.6f with the weights rounded\n", staticError(k));
+
+    FILE *output = outputFile ? std::fopen(outputFile, "w") : stdout;
+    if (!output) {
+        std::fprintf(stderr, "could not write %s\n", outputFile);
+        return 1;
+    }
+    for (const ChessEvalParams::Table &table : ChessEvalParams::tables()) {
+        const int *values = params.weights().data() + table.offset / sizeof(int);
+        std::string name = "k";
+        name += (char)std::toupper(table.name[0]);
+        name += table.name + 1;
+        if (table.count == 1) {
+            std::fprintf(output, "%s = %d;\n\n", name.c_str(), values[0]);
+            continue;
+        }
+        std::fprintf(output, "%s = {\n", name.c_str());
+        for (size_t row = 0; row < table.count; row += table.rowLength) {
+            std::fprintf(output, "   ");
+            for (size_t i = row; i < row + table.rowLength; i++) {
+                std::fprintf(output, " %4d,", values[i]);
+            }
+            std::fprintf(output, "\n");
+        }
+        std::fprintf(output, "};\n\n");
+    }
+    if (outputFile) {
+        std::fclose(output);
+    }
+    return 0;
+}